@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include <engine/graphics/Camera.hpp>
+#include <engine/util/Utils.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Utils.hpp defines a range() macro, which would expand in benchmark::State::range.
+#undef range
+
+// Engine algorithms that don't need a context: the controller graph sort, run once at startup but on graphs
+// far larger than the engine's own, and the camera matrices built every frame.
+
+namespace {
+struct Node {
+    std::vector<Node *> next;
+};
+
+/**
+ * @brief A layered DAG: every node has up to three edges into the next layer. The nodes are shuffled,
+ * so the sort can't rely on the order they were created in.
+ */
+std::vector<std::unique_ptr<Node> > make_graph(std::size_t count) {
+    static constexpr std::size_t LAYERS = 32;
+    std::vector<std::unique_ptr<Node> > nodes;
+    nodes.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        nodes.push_back(std::make_unique<Node>());
+    }
+    const std::size_t layer_size = std::max<std::size_t>(count / LAYERS, 1);
+    std::mt19937 random(42);
+    for (std::size_t i = 0; i + layer_size < count; ++i) {
+        const std::size_t next_layer = (i / layer_size + 1) * layer_size;
+        std::uniform_int_distribution<std::size_t> target(next_layer, std::min(next_layer + layer_size, count) - 1);
+        for (int edge = 0; edge < 3; ++edge) {
+            nodes[i]->next.push_back(nodes[target(random)].get());
+        }
+    }
+    std::ranges::shuffle(nodes, random);
+    return nodes;
+}
+
+std::vector<Node *> node_pointers(const std::vector<std::unique_ptr<Node> > &nodes) {
+    std::vector<Node *> result;
+    result.reserve(nodes.size());
+    for (const auto &node: nodes) {
+        result.push_back(node.get());
+    }
+    return result;
+}
+
+void topological_sort(benchmark::State &state) {
+    const auto graph = make_graph(static_cast<std::size_t>(state.range(0)));
+    const auto nodes = node_pointers(graph);
+    auto adjacent = [](Node *node) -> std::vector<Node *> & {
+        return node->next;
+    };
+    std::vector<Node *> order;
+    for (auto _: state) {
+        state.PauseTiming();
+        order = nodes;
+        state.ResumeTiming();
+        engine::util::alg::topological_sort(order.begin(), order.end(), adjacent);
+        benchmark::DoNotOptimize(order.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void has_cycle(benchmark::State &state) {
+    const auto graph = make_graph(static_cast<std::size_t>(state.range(0)));
+    auto nodes = node_pointers(graph);
+    auto adjacent = [](Node *node) -> std::vector<Node *> & {
+        return node->next;
+    };
+    for (auto _: state) {
+        benchmark::DoNotOptimize(engine::util::alg::has_cycle(nodes.begin(), nodes.end(), adjacent));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// What GraphicsController and the app do every frame: rotate the camera and build the view-projection.
+void camera_view_projection(benchmark::State &state) {
+    engine::graphics::Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+    float offset = 0.0f;
+    for (auto _: state) {
+        camera.rotate_camera(0.5f, std::sin(offset += 0.01f));
+        const glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), 800.0f / 600.0f, 0.1f, 100.0f);
+        benchmark::DoNotOptimize(projection * camera.view_matrix());
+    }
+}
+} // namespace
+
+BENCHMARK(topological_sort)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 17);
+BENCHMARK(has_cycle)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 17);
+
+BENCHMARK(camera_view_projection);
@@ -0,0 +1,231 @@
+#include <benchmark/benchmark.h>
+#include <engine/util/ObjectPool.hpp>
+#include <engine/util/SlotMap.hpp>
+#include <engine/util/SmallVector.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Compares engine::util::ds containers with the std containers they are meant to replace,
+// using the access patterns of the engine: resources looked up by name/handle, meshes drawn by iterating
+// over all of them, entities spawned and despawned every frame, and short per-mesh texture lists.
+
+namespace {
+/**
+ * @brief Roughly the size of per-object render data: a transform and a few GL ids.
+ */
+struct Payload {
+    glm::mat4 transform{1.0f};
+    uint32_t vao{0};
+    uint32_t num_indices{0};
+};
+
+std::vector<std::string> make_names(std::size_t count) {
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back("resources/models/object_" + std::to_string(i));
+    }
+    return names;
+}
+
+float touch(const Payload &payload) {
+    return payload.transform[3][0] + static_cast<float>(payload.num_indices);
+}
+
+// Lookup: ResourcesController looks resources up by name every frame; a slot map resolves a handle instead.
+void lookup_unordered_map_by_name(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto names = make_names(count);
+    std::unordered_map<std::string, std::unique_ptr<Payload> > map;
+    for (const auto &name: names) {
+        map[name] = std::make_unique<Payload>();
+    }
+    std::size_t i = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(map[names[i++ % count]].get());
+    }
+}
+
+void lookup_slot_map_by_handle(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    engine::util::ds::SlotMap<Payload> map;
+    std::vector<engine::util::ds::SlotHandle> handles;
+    for (std::size_t i = 0; i < count; ++i) {
+        handles.push_back(map.insert(Payload{}));
+    }
+    std::size_t i = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(map.get(handles[i++ % count]));
+    }
+}
+
+// Iteration: drawing walks every object once per frame.
+void iterate_unordered_map_of_unique_ptr(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::unordered_map<uint32_t, std::unique_ptr<Payload> > map;
+    for (uint32_t i = 0; i < count; ++i) {
+        map[i] = std::make_unique<Payload>();
+    }
+    for (auto _: state) {
+        float sum = 0;
+        for (const auto &[id, payload]: map) {
+            sum += touch(*payload);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+void iterate_vector_of_unique_ptr(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<std::unique_ptr<Payload> > objects;
+    for (std::size_t i = 0; i < count; ++i) {
+        objects.push_back(std::make_unique<Payload>());
+    }
+    for (auto _: state) {
+        float sum = 0;
+        for (const auto &payload: objects) {
+            sum += touch(*payload);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+void iterate_slot_map(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    engine::util::ds::SlotMap<Payload> map;
+    for (std::size_t i = 0; i < count; ++i) {
+        map.insert(Payload{});
+    }
+    for (auto _: state) {
+        float sum = 0;
+        for (const auto &payload: map) {
+            sum += touch(payload);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+void iterate_object_pool(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    engine::util::ds::ObjectPool<Payload> pool;
+    for (std::size_t i = 0; i < count; ++i) {
+        pool.create();
+    }
+    for (auto _: state) {
+        float sum = 0;
+        pool.for_each([&](const Payload &payload) {
+            sum += touch(payload);
+        });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+// Churn: a tenth of the objects is despawned and respawned every frame.
+void churn_unordered_map(benchmark::State &state) {
+    const auto count = static_cast<uint32_t>(state.range(0));
+    std::unordered_map<uint32_t, std::unique_ptr<Payload> > map;
+    for (uint32_t i = 0; i < count; ++i) {
+        map[i] = std::make_unique<Payload>();
+    }
+    uint32_t next_id = count;
+    for (auto _: state) {
+        for (uint32_t i = 0; i < count / 10; ++i) {
+            map.erase(map.begin());
+            map[next_id++] = std::make_unique<Payload>();
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+void churn_slot_map(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    engine::util::ds::SlotMap<Payload> map;
+    for (std::size_t i = 0; i < count; ++i) {
+        map.insert(Payload{});
+    }
+    for (auto _: state) {
+        for (std::size_t i = 0; i < count / 10; ++i) {
+            map.erase(map.handle_at(0));
+            map.insert(Payload{});
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+// Create/destroy: one heap allocation per object versus a slot from the pool's free list.
+void create_destroy_make_unique(benchmark::State &state) {
+    std::vector<std::unique_ptr<Payload> > objects(static_cast<std::size_t>(state.range(0)));
+    for (auto _: state) {
+        for (auto &object: objects) {
+            object = std::make_unique<Payload>();
+        }
+        for (auto &object: objects) {
+            object.reset();
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+void create_destroy_object_pool(benchmark::State &state) {
+    engine::util::ds::ObjectPool<Payload> pool;
+    std::vector<Payload *> objects(static_cast<std::size_t>(state.range(0)));
+    for (auto _: state) {
+        for (auto &object: objects) {
+            object = pool.create();
+        }
+        for (auto &object: objects) {
+            pool.destroy(object);
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+// Small lists: a mesh usually has 1-4 textures.
+void small_list_std_vector(benchmark::State &state) {
+    const auto count = state.range(0);
+    Payload payload;
+    for (auto _: state) {
+        std::vector<Payload *> textures;
+        for (int64_t i = 0; i < count; ++i) {
+            textures.push_back(&payload);
+        }
+        benchmark::DoNotOptimize(textures.data());
+    }
+}
+
+void small_list_small_vector(benchmark::State &state) {
+    const auto count = state.range(0);
+    Payload payload;
+    for (auto _: state) {
+        engine::util::ds::SmallVector<Payload *, 4> textures;
+        for (int64_t i = 0; i < count; ++i) {
+            textures.push_back(&payload);
+        }
+        benchmark::DoNotOptimize(textures.data());
+    }
+}
+} // namespace
+
+BENCHMARK(lookup_unordered_map_by_name)->Arg(64)->Arg(4096);
+BENCHMARK(lookup_slot_map_by_handle)->Arg(64)->Arg(4096);
+
+BENCHMARK(iterate_unordered_map_of_unique_ptr)->Arg(1000)->Arg(100000);
+BENCHMARK(iterate_vector_of_unique_ptr)->Arg(1000)->Arg(100000);
+BENCHMARK(iterate_slot_map)->Arg(1000)->Arg(100000);
+BENCHMARK(iterate_object_pool)->Arg(1000)->Arg(100000);
+
+BENCHMARK(churn_unordered_map)->Arg(1000)->Arg(100000);
+BENCHMARK(churn_slot_map)->Arg(1000)->Arg(100000);
+
+BENCHMARK(create_destroy_make_unique)->Arg(1000);
+BENCHMARK(create_destroy_object_pool)->Arg(1000);
+
+BENCHMARK(small_list_std_vector)->Arg(2)->Arg(4)->Arg(8);
+BENCHMARK(small_list_small_vector)->Arg(2)->Arg(4)->Arg(8);
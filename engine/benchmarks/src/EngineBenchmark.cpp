@@ -0,0 +1,264 @@
+#include <benchmark/benchmark.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <engine/core/Engine.hpp>
+#include <engine/platform/InputRecording.hpp>
+#include <engine/resources/AssimpSceneProcessor.hpp>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Utils.hpp defines a range() macro, which would expand in benchmark::State::range.
+#undef range
+
+// Hot paths that need the engine: a real engine is set up headless, with the null renderer (see
+// engine::graphics::NullRenderer), so the cases measure the engine's CPU cost of each call without a driver.
+
+namespace {
+static constexpr std::string_view SHADER_SOURCE = R"(//#shader vertex
+#version 330 core
+layout (location = 0) in vec3 aPos;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+void main() {
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
+//#shader fragment
+#version 330 core
+out vec4 FragColor;
+uniform vec3 color;
+uniform float intensity;
+uniform int mode;
+void main() {
+    FragColor = vec4(color * intensity, float(mode));
+}
+)";
+
+std::filesystem::path assets_path() {
+    return std::filesystem::temp_directory_path() / "engine-benchmarks";
+}
+
+/**
+ * @brief Writes a flat grid of `quads` x `quads` quads as an OBJ model, once.
+ */
+std::filesystem::path grid_model(uint32_t quads) {
+    const auto path = assets_path() / std::format("grid_{}.obj", quads);
+    if (std::filesystem::exists(path)) {
+        return path;
+    }
+    std::ofstream file(path);
+    for (uint32_t y = 0; y <= quads; ++y) {
+        for (uint32_t x = 0; x <= quads; ++x) {
+            const float u = static_cast<float>(x) / static_cast<float>(quads);
+            const float v = static_cast<float>(y) / static_cast<float>(quads);
+            file << std::format("v {} 0 {}\nvt {} {}\nvn 0 1 0\n", u, v, u, v);
+        }
+    }
+    for (uint32_t y = 0; y < quads; ++y) {
+        for (uint32_t x = 0; x < quads; ++x) {
+            const uint32_t a = y * (quads + 1) + x + 1;
+            const uint32_t b = a + quads + 1;
+            file << std::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\nf {2}/{2}/{2} {1}/{1}/{1} {3}/{3}/{3}\n", a, b,
+                                a + 1, b + 1);
+        }
+    }
+    return path;
+}
+
+std::filesystem::path shader_file() {
+    const auto path = assets_path() / "benchmark.glsl";
+    std::ofstream(path) << SHADER_SOURCE;
+    return path;
+}
+
+std::filesystem::path texture_file() {
+    const auto path = assets_path() / "benchmark.ppm";
+    std::ofstream file(path, std::ios::binary);
+    file << "P6\n2 2\n255\n";
+    file.write("\xff\x00\x00\x00\xff\x00\x00\x00\xff\xff\xff\xff", 12);
+    return path;
+}
+
+/**
+ * @class BenchmarkEngine
+ * @brief Runs the engine phases on demand instead of through App::run.
+ */
+class BenchmarkEngine final : public engine::core::App {
+public:
+    BenchmarkEngine() {
+        std::filesystem::create_directories(assets_path());
+        // The ArgParser keeps the pointers, the arguments have to outlive the engine.
+        static const char *args[] = {
+                "engine-benchmarks", "--configuration", RG_BENCHMARKS_CONFIG, "--headless", "1", "--null-renderer", "1"
+        };
+        engine_setup(std::size(args), const_cast<char **>(args));
+        app_setup();
+        initialize();
+    }
+
+    ~BenchmarkEngine() override {
+        terminate();
+        engine::util::Logging::instance()->shutdown();
+    }
+
+    void run_poll_events() {
+        poll_events();
+    }
+
+private:
+    void app_setup() override {
+    }
+};
+
+BenchmarkEngine *benchmark_engine() {
+    static auto engine = std::make_unique<BenchmarkEngine>();
+    return engine.get();
+}
+
+engine::resources::ResourcesController *resources() {
+    benchmark_engine();
+    return engine::core::Controller::get<engine::resources::ResourcesController>();
+}
+
+engine::resources::Model *grid(uint32_t quads) {
+    const auto name = std::format("grid_{}", quads);
+    engine::util::Configuration::config()["resources"]["models"][name] = {{"path", grid_model(quads).string()}};
+    return resources()->model(name);
+}
+
+// Mesh::draw: texture binding, VAO bind and draw call for each mesh of the model.
+void mesh_draw(benchmark::State &state) {
+    auto model = grid(8);
+    auto shader = resources()->shader("benchmark", shader_file());
+    shader->use();
+    for (auto _: state) {
+        model->draw(shader);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(model->meshes().size()));
+}
+
+// Shader::set_*: every call looks the uniform location up by name.
+void shader_set_uniforms(benchmark::State &state) {
+    auto shader = resources()->shader("benchmark", shader_file());
+    shader->use();
+    const glm::mat4 transform(1.0f);
+    for (auto _: state) {
+        shader->set_mat4("model", transform);
+        shader->set_mat4("view", transform);
+        shader->set_vec3("color", glm::vec3(1.0f));
+        shader->set_float("intensity", 0.5f);
+        shader->set_int("mode", 1);
+    }
+    state.SetItemsProcessed(state.iterations() * 5);
+}
+
+void resources_shader_lookup(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto path = shader_file();
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back(std::format("benchmark_shader_{}", i));
+        resources()->shader(names.back(), path);
+    }
+    std::size_t i = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(resources()->shader(names[i++ % count]));
+    }
+}
+
+void resources_texture_lookup(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto path = texture_file();
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back(std::format("benchmark_texture_{}", i));
+        resources()->texture(names.back(), path);
+    }
+    std::size_t i = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(resources()->texture(names[i++ % count]));
+    }
+}
+
+void resources_model_lookup(benchmark::State &state) {
+    grid(8);
+    const std::string name = "grid_8";
+    for (auto _: state) {
+        benchmark::DoNotOptimize(resources()->model(name));
+    }
+}
+
+// AssimpSceneProcessor::process_mesh: conversion of the imported vertices and indices, and the GPU upload.
+void assimp_process_meshes(benchmark::State &state) {
+    const auto quads = static_cast<uint32_t>(state.range(0));
+    const auto path = grid_model(quads);
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(path.string(), aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+                                                            aiProcess_CalcTangentSpace);
+    if (!scene) {
+        state.SkipWithError("Failed to import the grid model.");
+        return;
+    }
+    engine::resources::AssimpSceneProcessor processor(resources(), scene, path);
+    for (auto _: state) {
+        auto meshes = processor.process_meshes();
+        state.PauseTiming();
+        for (auto &mesh: meshes) {
+            mesh.destroy();
+        }
+        state.ResumeTiming();
+    }
+    const auto vertices = static_cast<int64_t>(scene->mMeshes[0]->mNumVertices);
+    state.SetItemsProcessed(state.iterations() * vertices);
+    state.SetBytesProcessed(state.iterations() * vertices * static_cast<int64_t>(sizeof(engine::resources::Vertex)));
+}
+
+// PlatformController::poll_events with `range(0)` input events per frame, fed from an input recording.
+void platform_poll_events(benchmark::State &state) {
+    using engine::platform::RecordedInputEvent;
+    static constexpr std::size_t FRAMES = 1024;
+    constexpr int glfw_key_w = 87;
+    const auto events = state.range(0);
+    engine::platform::InputRecording recording;
+    for (std::size_t frame = 0; frame < FRAMES; ++frame) {
+        recording.new_frame();
+        for (int64_t i = 0; i < events; ++i) {
+            if (i % 8 == 0) {
+                recording.add(RecordedInputEvent{RecordedInputEvent::Type::Keyboard, glfw_key_w,
+                                                 frame % 2 == 0 ? 1 : 0, 0.0, 0.0});
+            } else {
+                recording.add(RecordedInputEvent{RecordedInputEvent::Type::Mouse, 0, 0, static_cast<double>(i),
+                                                 static_cast<double>(frame)});
+            }
+        }
+    }
+    auto engine = benchmark_engine();
+    auto platform = engine::core::Controller::get<engine::platform::PlatformController>();
+    platform->play_input_recording(recording);
+    for (auto _: state) {
+        if (platform->input_playback_finished()) {
+            state.PauseTiming();
+            platform->play_input_recording(recording);
+            state.ResumeTiming();
+        }
+        engine->run_poll_events();
+    }
+    state.SetItemsProcessed(state.iterations() * events);
+}
+} // namespace
+
+BENCHMARK(mesh_draw);
+BENCHMARK(shader_set_uniforms);
+
+BENCHMARK(resources_shader_lookup)->Arg(16)->Arg(1024);
+BENCHMARK(resources_texture_lookup)->Arg(16)->Arg(1024);
+BENCHMARK(resources_model_lookup);
+
+BENCHMARK(assimp_process_meshes)->Arg(8)->Arg(64)->Arg(256);
+
+BENCHMARK(platform_poll_events)->Arg(0)->Arg(16)->Arg(256);
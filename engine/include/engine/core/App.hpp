@@ -69,7 +69,9 @@ public:
     */
     int run(int argc, char **argv);
 
-private:
+protected:
+    // The phases are protected so that harnesses, such as the engine benchmarks, can drive them one at a time.
+
     /**
     * @brief The first function that the engine calls to do its internal Controller classes `engine_setup`.
     */
@@ -118,7 +120,8 @@ private:
     * @brief Draws the frame. Calls @ref engine::core::Controller::draw for registered controllers.
     *
     * This is where all the drawing should happen based on the state
-    * that the @ref App::update computed.
+    * that the @ref App::update computed. Skipped when @ref platform::PlatformController::consume_redraw says that
+    * nothing would change on screen.
     */
     void draw();
 
@@ -0,0 +1,133 @@
+/**
+ * @file BenchmarkController.hpp
+ * @brief Defines the BenchmarkController class that runs a scripted, repeatable benchmark and writes a JSON report.
+ */
+
+#ifndef MATF_RG_PROJECT_BENCHMARK_CONTROLLER_HPP
+#define MATF_RG_PROJECT_BENCHMARK_CONTROLLER_HPP
+
+#include <engine/core/Controller.hpp>
+#include <glm/glm.hpp>
+#include <json.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace engine::core {
+/**
+* @struct CameraKeyframe
+* @brief A point of a benchmark camera path. The camera passes through the keyframes along a Catmull-Rom spline.
+*/
+struct CameraKeyframe {
+    /**
+    * @brief Seconds from the start of the benchmark.
+    */
+    float time;
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+/**
+* @class BenchmarkController
+* @brief Runs the app for a fixed number of frames with a fixed timestep and a scripted camera or recorded input,
+* then writes frame time percentiles and their CPU and GPU breakdowns to a JSON report.
+*
+* Registered by @ref App::engine_setup when the app is started with `--benchmark <script>`. The script is a JSON file:
+* @code
+* {
+*     "name": "backpack-orbit",
+*     "frames": 600,
+*     "warmup_frames": 60,
+*     "fixed_dt": 0.016666,
+*     "camera_path": [
+*         { "time": 0.0, "position": [0.0, 0.0, 3.0], "yaw": -90.0, "pitch": 0.0 },
+*         { "time": 5.0, "position": [3.0, 1.0, 0.0], "yaw": -180.0, "pitch": -10.0 }
+*     ],
+*     "input": "session.input.json",
+*     "config": { "opengl": { "error_check": "none" } },
+*     "output": "benchmark.json",
+*     "baseline": "baseline.json",
+*     "regression_threshold": 0.05
+* }
+* @endcode
+* Only `frames` is required. `camera_path` and `input` (recorded with `--record-input <path>`) are alternatives,
+* `config` is merged into the config.json before the controllers are initialized.
+* `--benchmark-output` and `--benchmark-baseline` override `output` and `baseline`.
+*
+* The report contains the script and the full configuration, so two reports can be compared. When a baseline report
+* is given, the percentiles that got slower by more than `regression_threshold` are logged as regressions.
+*/
+class BenchmarkController final : public Controller {
+public:
+    static constexpr uint32_t REPORT_VERSION = 1;
+
+    /**
+    * @brief Loads the script and applies its `config` to the configuration. Called by @ref App::engine_setup.
+    */
+    void load_script(const std::filesystem::path &path);
+
+    std::string_view name() const override {
+        return "BenchmarkController";
+    }
+
+    std::string_view subsystem() const override {
+        return "engine";
+    }
+
+private:
+    void initialize() override;
+
+    /**
+    * @brief Measures the frame that just ended and ends the app after the last one.
+    */
+    bool loop() override;
+
+    /**
+    * @brief Moves the camera along the path. Done after every controller's update, so the path wins over input.
+    */
+    void begin_draw() override;
+
+    void terminate() override;
+
+    void record_frame(float frame_ms);
+
+    CameraKeyframe sample_camera_path(float time) const;
+
+    nlohmann::json make_report() const;
+
+    void write_report();
+
+    void compare_with_baseline(const nlohmann::json &report) const;
+
+    std::filesystem::path m_script_path;
+    nlohmann::json m_script;
+    std::vector<CameraKeyframe> m_camera_path;
+    bool m_loop_camera_path{false};
+    std::filesystem::path m_output_path;
+    std::filesystem::path m_baseline_path;
+    float m_regression_threshold{0.05f};
+    float m_fixed_dt{0.0f};
+    uint32_t m_warmup_frames{0};
+    uint32_t m_frames{0};
+
+    /**
+    * @brief Frames started so far, including the warmup.
+    */
+    uint32_t m_frame{0};
+    uint64_t m_frame_begin_ns{0};
+    float m_path_time{0.0f};
+    std::vector<float> m_frame_ms;
+    std::map<std::string, std::vector<float> > m_cpu_ms;
+    std::map<std::string, std::vector<float> > m_gpu_ms;
+    uint64_t m_draw_calls{0};
+    uint64_t m_triangles{0};
+    uint64_t m_gl_calls{0};
+    std::string m_renderer;
+    bool m_report_written{false};
+};
+} // namespace engine::core
+
+#endif//MATF_RG_PROJECT_BENCHMARK_CONTROLLER_HPP
@@ -66,6 +66,15 @@ public:
         return typeid(*this).name();
     }
 
+    /**
+    * Returns the subsystem from @ref util::Logging::SUBSYSTEMS the controller belongs to; used to attribute its allocations,
+    * see @ref util::AllocationTracker.
+    * @return Subsystem name
+    */
+    virtual std::string_view subsystem() const {
+        return "app";
+    }
+
     virtual ~Controller() = default;
 
     /**
@@ -219,6 +228,10 @@ public:
     std::string_view name() const override {
         return "EngineControllersBegin";
     }
+
+    std::string_view subsystem() const override {
+        return "engine";
+    }
 };
 
 /**
@@ -240,6 +253,10 @@ public:
     std::string_view name() const override {
         return "EngineControllersEnd";
     }
+
+    std::string_view subsystem() const override {
+        return "engine";
+    }
 };
 } // namespace engine
 
@@ -22,6 +22,12 @@
 #include <engine/util/Configuration.hpp>
 #include <engine/util/ArgParser.hpp>
 #include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <engine/util/Arena.hpp>
+#include <engine/util/SlotMap.hpp>
+#include <engine/util/ObjectPool.hpp>
+#include <engine/util/SmallVector.hpp>
 
 #include <engine/resources/ShaderCompiler.hpp>
 #include <engine/resources/ResourcesController.hpp>
@@ -108,6 +108,11 @@ public:
      */
     void zoom(float offset);
 
+    /**
+     * @brief Sets the Euler angles directly, e.g. when the camera follows a scripted path.
+     */
+    void set_orientation(float yaw, float pitch);
+
 private:
     /**
      * @brief Calculates the front vector from the Camera's (updated) Euler Angles
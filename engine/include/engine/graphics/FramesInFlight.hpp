@@ -0,0 +1,101 @@
+/**
+ * @file FramesInFlight.hpp
+ * @brief Defines the FramesInFlight limiter that keeps the CPU at most a set number of frames ahead of the GPU.
+ */
+
+#ifndef MATF_RG_PROJECT_FRAMES_IN_FLIGHT_HPP
+#define MATF_RG_PROJECT_FRAMES_IN_FLIGHT_HPP
+
+#include <json.hpp>
+#include <array>
+#include <cstdint>
+
+namespace engine::graphics {
+/**
+* @brief How @ref FramesInFlight waits for a frame's fence.
+*/
+enum class FrameWait {
+    /**
+    * @brief Blocks in `glClientWaitSync`. The driver decides how it waits, some drivers spin.
+    */
+    Block,
+    /**
+    * @brief Polls the fence and yields the thread in between. Wakes up sooner after the fence signals.
+    */
+    Poll,
+};
+
+/**
+* @class FramesInFlight
+* @brief Limits how many frames the CPU submits before the GPU finishes them.
+*
+* Without a limit, the driver queues frames as deep as it likes: the input latency grows with the queue, or the CPU
+* stalls somewhere unpredictable when the driver runs out of buffers. The limiter places a fence after every frame,
+* and before frame N starts it waits for the fence of frame N - `frames_in_flight`. The wait shows up as the
+* `FramesInFlight::wait` profiler zone and as @ref RenderStats::gpu_wait_ms.
+*
+* Owned by the @ref GraphicsController, which calls @ref FramesInFlight::begin_frame in `begin_draw` and
+* @ref FramesInFlight::end_frame in `end_draw`. Configured in the `opengl` section of the config.json:
+* @code
+* "opengl": { "frames_in_flight": 2, "frame_wait": "block" }
+* @endcode
+* 0 frames in flight disables the limiter. A frame whose index is at most @ref FramesInFlight::completed_frame is done
+* on the GPU, so its buffers can be reused and its readbacks are ready.
+*/
+class FramesInFlight {
+public:
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 8;
+
+    void configure(const nlohmann::json &opengl_config);
+
+    bool is_enabled() const {
+        return m_frames_in_flight > 0;
+    }
+
+    uint32_t frames_in_flight() const {
+        return m_frames_in_flight;
+    }
+
+    /**
+    * @brief Waits until at most `frames_in_flight - 1` frames are in flight.
+    * @returns Milliseconds spent waiting.
+    */
+    float begin_frame();
+
+    /**
+    * @brief Fences the frame that was just submitted.
+    */
+    void end_frame();
+
+    /**
+    * @returns Index of the frame that is being submitted, starting with 1.
+    */
+    uint64_t frame_index() const {
+        return m_frame;
+    }
+
+    /**
+    * @returns Index of the latest frame known to be finished on the GPU, 0 if none.
+    */
+    uint64_t completed_frame() const {
+        return m_completed_frame;
+    }
+
+    /**
+    * @brief Deletes the pending fences.
+    */
+    void terminate();
+
+private:
+    uint32_t m_frames_in_flight{2};
+    FrameWait m_wait{FrameWait::Block};
+    /**
+    * @brief `GLsync` of every frame in flight, by frame index modulo @ref FramesInFlight::m_frames_in_flight.
+    */
+    std::array<void *, MAX_FRAMES_IN_FLIGHT> m_fences{};
+    uint64_t m_frame{0};
+    uint64_t m_completed_frame{0};
+};
+} // namespace engine::graphics
+
+#endif//MATF_RG_PROJECT_FRAMES_IN_FLIGHT_HPP
@@ -0,0 +1,367 @@
+/**
+ * @file GlCapture.hpp
+ * @brief Defines the GlCapture class that records the OpenGL call stream to a file, and the GlReplayer that plays it back.
+ */
+
+#ifndef MATF_RG_PROJECT_GL_CAPTURE_HPP
+#define MATF_RG_PROJECT_GL_CAPTURE_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <source_location>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace engine::graphics {
+/**
+* @brief OpenGL functions that can be captured. Calls to other functions are skipped and counted.
+* The values are stored in capture files, append new functions at the end and bump @ref GlCapture::VERSION.
+*/
+enum class GlFunction : uint16_t {
+    ActiveTexture,
+    AttachShader,
+    BindBuffer,
+    BindTexture,
+    BindVertexArray,
+    BufferData,
+    Clear,
+    ClearColor,
+    CompileShader,
+    CreateProgram,
+    CreateShader,
+    DeleteBuffers,
+    DeleteProgram,
+    DeleteShader,
+    DeleteTextures,
+    DeleteVertexArrays,
+    DepthFunc,
+    Disable,
+    DrawArrays,
+    DrawElements,
+    Enable,
+    EnableVertexAttribArray,
+    GenBuffers,
+    GenTextures,
+    GenVertexArrays,
+    GenerateMipmap,
+    GetUniformLocation,
+    LinkProgram,
+    ShaderSource,
+    TexImage2D,
+    TexParameteri,
+    Uniform1f,
+    Uniform1i,
+    Uniform2fv,
+    Uniform3fv,
+    Uniform4fv,
+    UniformMatrix2fv,
+    UniformMatrix3fv,
+    UniformMatrix4fv,
+    UseProgram,
+    VertexAttribPointer,
+    Viewport,
+    BindBufferRange,
+    BufferStorage,
+    ClientWaitSync,
+    DeleteSync,
+    FenceSync,
+    GetUniformBlockIndex,
+    MapBufferRange,
+    UniformBlockBinding,
+    UnmapBuffer,
+    BufferSubData,
+
+    FunctionCount
+};
+
+/**
+* @brief How an argument or a result of a @ref GlFunction is stored and how the replayer translates it.
+*/
+enum class GlArg : uint8_t {
+    None,
+    /**
+    * @brief Integer, enum or a pointer that is used as an offset into a bound buffer. Stored as is.
+    */
+    Value,
+    Float,
+    /**
+    * @brief Object names. The replayer maps them to the names its own context generated.
+    */
+    Texture,
+    Buffer,
+    VertexArray,
+    Shader,
+    Program,
+    /**
+    * @brief GLsync of a fence, mapped like the object names.
+    */
+    Sync,
+    /**
+    * @brief Uniform location of the currently used program.
+    */
+    UniformLocation,
+    /**
+    * @brief Uniform block index of the program passed to the same call.
+    */
+    UniformBlockIndex,
+    /**
+    * @brief Pointer to data the call reads. The bytes are stored in the file, see @ref gl_data_size.
+    */
+    Data,
+    /**
+    * @brief Null-terminated string the call reads.
+    */
+    String,
+    /**
+    * @brief The `strings` array of glShaderSource, stored concatenated.
+    */
+    ShaderSources,
+    /**
+    * @brief Array of `n` object names the call writes (glGen*) or reads (glDelete*).
+    */
+    TextureNames,
+    BufferNames,
+    VertexArrayNames,
+};
+
+/**
+* @struct GlFunctionInfo
+* @brief Signature of a @ref GlFunction.
+*/
+struct GlFunctionInfo {
+    static constexpr std::size_t MAX_ARGS = 9;
+
+    std::string_view name;
+    GlArg result;
+    uint8_t arg_count;
+    std::array<GlArg, MAX_ARGS> args;
+};
+
+const GlFunctionInfo &gl_function_info(GlFunction function);
+
+/**
+* @returns Size in bytes of the data the `arg_index`-th argument of a @ref GlArg::Data argument points to,
+* computed from the other arguments of the call.
+*/
+std::size_t gl_data_size(GlFunction function, std::size_t arg_index, std::span<const uint64_t> args);
+
+/**
+* @class GlCapture
+* @brief Records every call made through @ref OpenGL::call into a compact binary file, for offline replay.
+*
+* A capture contains all the calls from the start of the capture to the first frame (the setup: loading of
+* shaders, meshes and textures), followed by the calls of the captured frames. The data the calls read, such as
+* buffer contents, texture images and uniform values, is stored with the calls. Since the replayer has to recreate
+* the objects the frames use, a capture can only be started before any resources are loaded,
+* i.e. from the `gl_capture` section of the config.json:
+* @code
+* "gl_capture": { "path": "frames.rgcap", "frames": 120 }
+* @endcode
+* Play the file back with the gl-replay tool.
+*
+* Only the functions in @ref GlFunction are captured. Calls to others (queries) are skipped, and the first call to each
+* of them is logged as a warning with its call site. ImGui calls OpenGL directly, so its calls aren't seen at all.
+* Writes through a buffer mapped with glMapBufferRange aren't GL calls either. The @ref StreamingBuffer records what
+* it wrote with @ref GlCapture::record_buffer_data when it flushes, and the replay uploads it with glBufferSubData.
+* Pointer arguments of glDrawElements and glVertexAttribPointer are recorded as offsets, so they must refer to bound buffers.
+*/
+class GlCapture {
+public:
+    static constexpr uint32_t VERSION = 3;
+
+    enum class Record : uint8_t {
+        Call = 1,
+        SetupEnd = 2,
+        FrameEnd = 3,
+    };
+
+    /**
+    * @brief Starts capturing into `path`. Captures `frames` frames after the setup, then stops.
+    */
+    void start(const std::filesystem::path &path, uint32_t frames);
+
+    void stop();
+
+    bool is_capturing() const {
+        return m_file.is_open();
+    }
+
+    /**
+    * @brief Ends the setup part of the capture on the first frame. Called by @ref GraphicsController::begin_draw.
+    */
+    void begin_frame();
+
+    /**
+    * @brief Called by @ref GraphicsController::end_draw.
+    */
+    void end_frame();
+
+    /**
+    * @returns Number of calls that weren't captured because their function isn't in @ref GlFunction.
+    */
+    uint64_t skipped_calls() const {
+        return m_skipped_calls;
+    }
+
+    /**
+    * @brief Records a call made at `location`, after it was made. Called by @ref OpenGL::call.
+    */
+    void record(std::source_location location, const void *function, std::span<const uint64_t> args, uint64_t result);
+
+    /**
+    * @brief Records `size` bytes written to `buffer` at `offset` through a mapping, as a glBufferSubData on
+    * GL_COPY_WRITE_BUFFER. Nothing is called, the data is only stored for the replay.
+    */
+    void record_buffer_data(uint32_t buffer, std::size_t offset, const void *data, std::size_t size);
+
+    /**
+    * @brief Encodes an argument of the type `T` the OpenGL function takes.
+    */
+    template<typename T>
+    static uint64_t encode_arg(T value) {
+        if constexpr (std::is_pointer_v<T>) {
+            return reinterpret_cast<uintptr_t>(value);
+        } else if constexpr (std::is_same_v<T, float>) {
+            return std::bit_cast<uint32_t>(value);
+        } else if constexpr (std::is_same_v<T, double>) {
+            return std::bit_cast<uint64_t>(value);
+        } else {
+            return static_cast<uint64_t>(static_cast<int64_t>(value));
+        }
+    }
+
+private:
+    void write_bytes(const void *data, std::size_t size);
+
+    /**
+    * @brief Writes the size, followed by the data aligned to 8 bytes.
+    */
+    void write_data(const void *data, uint64_t size);
+
+    void flush();
+
+    template<typename T>
+    void write(T value) {
+        write_bytes(&value, sizeof(value));
+    }
+
+    std::ofstream m_file;
+    std::vector<char> m_buffer;
+    std::unordered_map<const void *, GlFunction> m_functions;
+    /**
+    * @brief Bytes written to the file so far, including the ones still in the buffer.
+    */
+    uint64_t m_offset{0};
+    uint32_t m_frames_left{0};
+    uint32_t m_frames_captured{0};
+    uint64_t m_skipped_calls{0};
+    /**
+    * @brief Functions outside of @ref GlFunction that were already warned about.
+    */
+    std::unordered_set<const void *> m_skipped_functions;
+    bool m_in_setup{true};
+};
+
+/**
+* @brief The capture calls are recorded into. Set while a @ref GlCapture is capturing, null otherwise.
+*/
+inline GlCapture *g_gl_capture = nullptr;
+
+/**
+* @struct GlReplayFrameTiming
+* @brief Time it took to replay one captured frame.
+*/
+struct GlReplayFrameTiming {
+    /**
+    * @brief CPU time spent issuing the calls.
+    */
+    float submit_ms;
+    /**
+    * @brief Time from the submit until the GPU finished the frame.
+    */
+    float gpu_wait_ms;
+};
+
+/**
+* @class GlReplayer
+* @brief Plays back a @ref GlCapture file on the current OpenGL context.
+*
+* The file is loaded and decoded up front, so the replay only pays for the calls and the translation of object names.
+* @code
+* GlReplayer replayer("frames.rgcap");
+* replayer.replay_setup();
+* for (std::size_t i = 0; i < replayer.frame_count(); ++i) {
+*     auto timing = replayer.replay_frame(i);
+* }
+* @endcode
+*/
+class GlReplayer {
+public:
+    explicit GlReplayer(const std::filesystem::path &path);
+
+    std::size_t frame_count() const {
+        return m_frames.size();
+    }
+
+    std::size_t call_count() const {
+        return m_calls.size();
+    }
+
+    /**
+    * @brief Issues the setup calls, recreating the objects the frames use.
+    */
+    void replay_setup();
+
+    /**
+    * @brief Issues the calls of the `index`-th frame and waits for the GPU to finish it.
+    */
+    GlReplayFrameTiming replay_frame(std::size_t index);
+
+private:
+    struct Call {
+        GlFunction function;
+        std::array<uint64_t, GlFunctionInfo::MAX_ARGS> args;
+        uint64_t result;
+    };
+
+    struct Range {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    void replay(const Call &call);
+
+    uint32_t map_name(const std::unordered_map<uint32_t, uint32_t> &names, uint64_t name) const;
+
+    std::vector<char> m_data;
+    std::vector<Call> m_calls;
+    Range m_setup{};
+    std::vector<Range> m_frames;
+
+    std::unordered_map<uint32_t, uint32_t> m_textures;
+    std::unordered_map<uint32_t, uint32_t> m_buffers;
+    std::unordered_map<uint32_t, uint32_t> m_vertex_arrays;
+    std::unordered_map<uint32_t, uint32_t> m_shaders;
+    std::unordered_map<uint32_t, uint32_t> m_programs;
+    /**
+    * @brief (captured program << 32 | captured location) -> location in the replay context.
+    */
+    std::unordered_map<uint64_t, int32_t> m_uniform_locations;
+    /**
+    * @brief (captured program << 32 | captured block index) -> block index in the replay context.
+    */
+    std::unordered_map<uint64_t, uint32_t> m_uniform_block_indices;
+    std::unordered_map<uint64_t, void *> m_syncs;
+    uint32_t m_current_program{0};
+    std::vector<uint32_t> m_names_scratch;
+};
+} // namespace engine::graphics
+
+#endif//MATF_RG_PROJECT_GL_CAPTURE_HPP
@@ -0,0 +1,157 @@
+/**
+ * @file GpuProfiler.hpp
+ * @brief Defines the GpuProfiler class that measures GPU time of render passes with timer queries.
+ */
+
+#ifndef MATF_RG_PROJECT_GPU_PROFILER_HPP
+#define MATF_RG_PROJECT_GPU_PROFILER_HPP
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace engine::graphics {
+/**
+* @struct GpuPassStats
+* @brief GPU time of a named pass over the last @ref GpuPassStats::WINDOW frames in which it ran.
+*/
+struct GpuPassStats {
+    static constexpr std::size_t WINDOW = 120;
+
+    std::string_view name;
+    float last_ms;
+    float min_ms;
+    float avg_ms;
+    float max_ms;
+    std::array<float, WINDOW> samples;
+    std::size_t sample_count;
+};
+
+/**
+* @class GpuProfiler
+* @brief Times GPU passes with `GL_TIMESTAMP` queries without stalling the pipeline.
+*
+* Every pass writes a timestamp query at its beginning and at its end. Queries are pooled per frame in a ring
+* @ref GpuProfiler::FRAME_LATENCY frames deep, and the results of a frame are read only when its slot comes up
+* again, by which time the GPU has long finished it. If it hasn't, the results are dropped instead of waiting.
+*
+* The results feed the per-pass statistics, the "GPU" lane of the @ref util::Profiler timeline (shifted into the
+* CPU clock, @ref GpuProfiler::FRAME_LATENCY frames late) and the overlay drawn by @ref GpuProfiler::draw_gui.
+*
+* When the driver has no timer queries (some software implementations report 0 counter bits), the profiler
+* disables itself and all the scopes become no-ops.
+* @code
+* void MainController::draw() {
+*     RG_GPU_SCOPE("backpack");
+*     draw_backpack();
+* }
+* @endcode
+*/
+class GpuProfiler {
+public:
+    static constexpr std::size_t FRAME_LATENCY = 4;
+
+    /**
+    * @brief Checks for timer query support and registers the GPU lane. Called by @ref GraphicsController::initialize.
+    */
+    void initialize();
+
+    void terminate();
+
+    bool is_supported() const {
+        return m_supported;
+    }
+
+    /**
+    * @brief Reads back the frame that was recorded @ref GpuProfiler::FRAME_LATENCY frames ago and starts recording a new one.
+    * Called by @ref GraphicsController::begin_draw.
+    */
+    void new_frame();
+
+    /**
+    * @brief Starts a pass. Passes can nest. `name` must outlive the profiler, use string literals.
+    */
+    void begin(std::string_view name);
+
+    void end();
+
+    std::span<const GpuPassStats> passes() const {
+        return m_passes;
+    }
+
+    /**
+    * @returns Number of frames whose results weren't ready when they were due, and were dropped.
+    */
+    uint64_t dropped_frames() const {
+        return m_dropped_frames;
+    }
+
+    /**
+    * @brief Draws the GPU timing overlay. Call between @ref GraphicsController::begin_gui and @ref GraphicsController::end_gui.
+    */
+    void draw_gui();
+
+private:
+    struct Pass {
+        std::string_view name;
+        uint32_t begin_query;
+        uint32_t end_query;
+        uint32_t depth;
+    };
+
+    struct Frame {
+        std::vector<uint32_t> queries;
+        std::size_t used_queries{0};
+        std::vector<Pass> passes;
+    };
+
+    uint32_t next_query(Frame &frame);
+
+    void read_back(Frame &frame);
+
+    void calibrate();
+
+    void add_sample(std::string_view name, float ms);
+
+    std::array<Frame, FRAME_LATENCY> m_frames;
+    std::vector<std::size_t> m_open_passes;
+    std::vector<GpuPassStats> m_passes;
+    uint64_t m_frame_index{0};
+    uint64_t m_dropped_frames{0};
+    /**
+    * @brief CPU time (@ref util::Profiler::now_ns) minus GPU time, measured by @ref GpuProfiler::calibrate.
+    */
+    int64_t m_clock_offset_ns{0};
+    uint32_t m_profiler_lane{0};
+    bool m_supported{false};
+};
+
+/**
+* @class GpuScope
+* @brief Times the enclosing scope as a GPU pass of the @ref GraphicsController's @ref GpuProfiler.
+*/
+class GpuScope {
+public:
+    explicit GpuScope(std::string_view name);
+
+    ~GpuScope();
+
+    GpuScope(const GpuScope &) = delete;
+
+    GpuScope &operator=(const GpuScope &) = delete;
+
+private:
+    GpuProfiler *m_profiler;
+};
+} // namespace engine::graphics
+
+/**
+* @brief Times the enclosing scope on the GPU as a pass named `name`.
+*/
+#define RG_GPU_SCOPE(name) ::engine::graphics::GpuScope RG_GPU_SCOPE_CONCAT(rg_gpu_scope_, __LINE__)(name)
+#define RG_GPU_SCOPE_CONCAT_IMPL(a, b) a##b
+#define RG_GPU_SCOPE_CONCAT(a, b) RG_GPU_SCOPE_CONCAT_IMPL(a, b)
+
+#endif//MATF_RG_PROJECT_GPU_PROFILER_HPP
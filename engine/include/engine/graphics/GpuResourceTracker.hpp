@@ -0,0 +1,144 @@
+/**
+ * @file GpuResourceTracker.hpp
+ * @brief Defines the GpuResourceTracker that accounts for every GL object the engine creates and reports the leaked ones.
+ */
+
+#ifndef MATF_RG_PROJECT_GPU_RESOURCE_TRACKER_HPP
+#define MATF_RG_PROJECT_GPU_RESOURCE_TRACKER_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace engine::graphics {
+enum class GlObjectType {
+    Buffer,
+    VertexArray,
+    Texture,
+    Renderbuffer,
+    Framebuffer,
+    Program,
+    Query,
+};
+
+std::string_view to_string(GlObjectType type);
+
+/**
+* @struct GlObject
+* @brief A live GL object.
+*/
+struct GlObject {
+    GlObjectType type;
+    uint32_t id;
+    /**
+    * @brief What the object is used for, e.g. "mesh" or "texture". Not copied, use string literals.
+    */
+    std::string_view category;
+    /**
+    * @brief The resource that created the object, see @ref GpuResourceTracker::OwnerScope.
+    */
+    std::string owner;
+    /**
+    * @brief Estimated size of the object's storage on the GPU.
+    */
+    uint64_t bytes;
+};
+
+/**
+* @struct GpuCategoryUsage
+* @brief Live objects and their bytes in one category.
+*/
+struct GpuCategoryUsage {
+    uint32_t objects;
+    uint64_t bytes;
+};
+
+/**
+* @class GpuResourceTracker
+* @brief Accounts for the GL objects created and deleted by the engine.
+*
+* Every place that creates or deletes a GL object reports it right after the call:
+* @code
+* CHECKED_GL_CALL(glGenBuffers, 1, &vbo);
+* GpuResourceTracker::instance()->on_create(GlObjectType::Buffer, vbo, "mesh", vertices.size_bytes());
+* ...
+* CHECKED_GL_CALL(glDeleteBuffers, 1, &vbo);
+* GpuResourceTracker::instance()->on_delete(GlObjectType::Buffer, vbo);
+* @endcode
+* The owner of the new objects is the innermost @ref GpuResourceTracker::OwnerScope, the @ref resources::ResourcesController
+* opens one for every asset it loads. The live usage per category is shown by @ref GpuResourceTracker::draw_gui, and
+* the objects that are still alive when the @ref GraphicsController terminates are logged as leaks.
+* Objects created by ImGui's renderer backend are not tracked.
+*/
+class GpuResourceTracker {
+public:
+    static GpuResourceTracker *instance();
+
+    /**
+    * @class OwnerScope
+    * @brief Sets the owner of the objects created while it's alive.
+    */
+    class OwnerScope {
+    public:
+        explicit OwnerScope(std::string owner);
+
+        ~OwnerScope();
+
+        OwnerScope(const OwnerScope &) = delete;
+
+        OwnerScope &operator=(const OwnerScope &) = delete;
+
+    private:
+        std::string m_previous;
+    };
+
+    void on_create(GlObjectType type, uint32_t id, std::string_view category, uint64_t bytes = 0);
+
+    /**
+    * @brief Updates the size of a live object, e.g. after a buffer is reallocated.
+    */
+    void set_bytes(GlObjectType type, uint32_t id, uint64_t bytes);
+
+    void on_delete(GlObjectType type, uint32_t id);
+
+    /**
+    * @returns The live objects and bytes per category.
+    */
+    const std::map<std::string_view, GpuCategoryUsage> &usage() const {
+        return m_usage;
+    }
+
+    std::size_t live_objects() const {
+        return m_objects.size();
+    }
+
+    uint64_t live_bytes() const;
+
+    /**
+    * @brief Logs every live object as a leak. Called by @ref GraphicsController::terminate.
+    * @returns The number of leaked objects.
+    */
+    std::size_t report_leaks() const;
+
+    /**
+    * @brief Draws the GPU memory panel. Call between @ref GraphicsController::begin_gui and @ref GraphicsController::end_gui.
+    */
+    void draw_gui();
+
+private:
+    GpuResourceTracker() = default;
+
+    static uint64_t key(GlObjectType type, uint32_t id) {
+        return static_cast<uint64_t>(type) << 32 | id;
+    }
+
+    std::unordered_map<uint64_t, GlObject> m_objects;
+    std::map<std::string_view, GpuCategoryUsage> m_usage;
+    std::string m_owner;
+    bool m_gui_show_objects{false};
+};
+} // namespace engine::graphics
+
+#endif//MATF_RG_PROJECT_GPU_RESOURCE_TRACKER_HPP
@@ -7,8 +7,16 @@
 #define GRAPHICSCONTROLLER_HPP
 
 #include <engine/graphics/Camera.hpp>
+#include <engine/graphics/FramesInFlight.hpp>
+#include <engine/graphics/GlCapture.hpp>
+#include <engine/graphics/GpuProfiler.hpp>
+#include <engine/graphics/OffscreenTarget.hpp>
+#include <engine/graphics/RenderStats.hpp>
+#include <engine/graphics/StreamingBuffer.hpp>
+#include <engine/graphics/UniformBlock.hpp>
 #include <engine/core/Controller.hpp>
 #include <engine/platform/PlatformEventObserver.hpp>
+#include <cstring>
 
 struct ImGuiContext;
 
@@ -58,6 +66,10 @@ class GraphicsController final : public core::Controller {
 public:
     std::string_view name() const override;
 
+    std::string_view subsystem() const override {
+        return "graphics";
+    }
+
     /**
     * @brief Calls internal methods for the beginning of gui drawing. Should be called in pair with @ref GraphicsController::end_gui.
     *
@@ -90,6 +102,85 @@ public:
         return &m_camera;
     }
 
+    /**
+    * @brief GPU pass timings, see @ref RG_GPU_SCOPE.
+    */
+    GpuProfiler *gpu_profiler() {
+        return &m_gpu_profiler;
+    }
+
+    /**
+    * @brief Per-frame renderer counters. Use @ref RenderStatsRecorder::last_frame to read the last completed frame.
+    */
+    RenderStatsRecorder *render_stats() {
+        return &m_render_stats;
+    }
+
+    /**
+    * @brief GL call capture, started from the `gl_capture` section of the config.json.
+    */
+    GlCapture *gl_capture() {
+        return &m_gl_capture;
+    }
+
+    /**
+    * @brief The framebuffer the frames are rendered into in headless mode. Not created otherwise.
+    */
+    OffscreenTarget *offscreen_target() {
+        return &m_offscreen_target;
+    }
+
+    /**
+    * @brief Limits how far the CPU runs ahead of the GPU, see the `opengl.frames_in_flight` config.
+    */
+    FramesInFlight *frames_in_flight() {
+        return &m_frames_in_flight;
+    }
+
+    /**
+    * @brief Ring of per-frame memory for geometry and constants written every frame. Sized by
+    * `opengl.streaming_buffer_kb` in the config.json, not created when it's 0.
+    */
+    StreamingBuffer *streaming_buffer() {
+        return &m_streaming_buffer;
+    }
+
+    /**
+    * @brief Copies a uniform block into the @ref StreamingBuffer, aligned for `glBindBufferRange`.
+    *
+    * Push the blocks of a batch of draws first, then @ref StreamingBuffer::flush once and bind each draw's slice with
+    * @ref GraphicsController::bind_uniforms, so a frame costs one copy per draw and at most one buffer update:
+    * @code
+    * for (const auto &object: objects) {
+    *     slices.push_back(graphics->push_uniforms(object.constants));
+    * }
+    * graphics->streaming_buffer()->flush();
+    * for (std::size_t i = 0; i < objects.size(); ++i) {
+    *     graphics->bind_uniforms<DrawConstants>(slices[i]);
+    *     objects[i].model->draw(shader);
+    * }
+    * @endcode
+    */
+    template<typename TBlock>
+    UniformSlice push_uniforms(const TBlock &block) {
+        static_assert(has_std140_layout<TBlock>(), "The uniform block struct doesn't follow the std140 layout.");
+        RG_GUARANTEE(m_streaming_buffer.is_created(), "Uniform blocks need the streaming buffer, set opengl.streaming_buffer_kb.");
+        const auto allocation = m_streaming_buffer.allocate(sizeof(TBlock), m_uniform_alignment);
+        std::memcpy(allocation.data, &block, sizeof(TBlock));
+        ++g_render_stats.uniform_uploads;
+        return UniformSlice{allocation.offset, sizeof(TBlock)};
+    }
+
+    /**
+    * @brief Binds a slice pushed by @ref GraphicsController::push_uniforms to `TBlock::BINDING`.
+    */
+    template<typename TBlock>
+    void bind_uniforms(UniformSlice slice) {
+        bind_uniform_range(TBlock::BINDING, slice);
+    }
+
+    void bind_uniform_range(uint32_t binding, UniformSlice slice);
+
     /**
     * @brief Compute the projection matrix.
     * @returns Return perspective projection by default.
@@ -159,13 +250,37 @@ private:
     */
     void initialize() override;
 
-    void terminate();
+    void terminate() override;
+
+    /**
+    * @brief Selects how @ref OpenGL::call checks for errors, from the `opengl` section of the config.json,
+    * and installs the debug output callback when it's used.
+    */
+    void initialize_error_checking();
+
+    /**
+    * @brief Waits for a frame in flight to finish, starts a new frame of GPU timings and of the streaming buffer, and
+    * binds the offscreen target in headless mode.
+    */
+    void begin_draw() override;
+
+    /**
+    * @brief Fences the frame and its streaming buffer region, and closes the frame's renderer stats.
+    */
+    void end_draw() override;
 
     PerspectiveMatrixParams m_perspective_params{};
     OrthographicMatrixParams m_ortho_params{};
 
     glm::mat4 m_projection_matrix{};
     Camera m_camera{};
+    GpuProfiler m_gpu_profiler{};
+    RenderStatsRecorder m_render_stats{};
+    GlCapture m_gl_capture{};
+    OffscreenTarget m_offscreen_target{};
+    StreamingBuffer m_streaming_buffer{};
+    FramesInFlight m_frames_in_flight{};
+    std::size_t m_uniform_alignment{16};
     ImGuiContext *m_imgui_context{};
 };
 
@@ -0,0 +1,43 @@
+/**
+ * @file NullRenderer.hpp
+ * @brief Defines the NullRenderer, an OpenGL backend that does nothing, for measuring the CPU cost of the engine.
+ */
+
+#ifndef MATF_RG_PROJECT_NULL_RENDERER_HPP
+#define MATF_RG_PROJECT_NULL_RENDERER_HPP
+
+#include <cstdint>
+
+namespace engine::graphics {
+/**
+* @class NullRenderer
+* @brief Points every OpenGL function at a stub that only counts the call.
+*
+* Enabled with `"opengl": { "null_renderer": true }` in the config.json, or `--null-renderer 1` on the command line.
+* The platform then creates its window without an OpenGL context, and the @ref GraphicsController loads the stubs
+* instead of the driver's functions. Everything else, the @ref core::App loop, resource loading, ImGui and the app,
+* runs unchanged, so the frame time is the CPU cost of the engine alone.
+*
+* The stubs hand out fake object names, report shaders as compiled and framebuffers as complete, and return zeros
+* from the queries. All other functions resolve to one no-op.
+*/
+class NullRenderer {
+public:
+    /**
+    * @brief Loads the stubs into glad.
+    */
+    static void load();
+
+    /**
+    * @brief Loader of the stubs, in place of `glfwGetProcAddress`.
+    */
+    static void *get_proc_address(const char *name);
+
+    /**
+    * @returns Number of OpenGL calls made since the stubs were loaded.
+    */
+    static uint64_t call_count();
+};
+} // namespace engine::graphics
+
+#endif//MATF_RG_PROJECT_NULL_RENDERER_HPP
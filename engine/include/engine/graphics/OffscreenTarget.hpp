@@ -0,0 +1,58 @@
+/**
+ * @file OffscreenTarget.hpp
+ * @brief Defines the OffscreenTarget class, a framebuffer object the frames are rendered into when there is no window.
+ */
+
+#ifndef MATF_RG_PROJECT_OFFSCREEN_TARGET_HPP
+#define MATF_RG_PROJECT_OFFSCREEN_TARGET_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace engine::graphics {
+/**
+* @class OffscreenTarget
+* @brief An RGBA8 color and a depth-stencil renderbuffer attached to a framebuffer object.
+*
+* In headless mode (see @ref platform::PlatformController::headless) the @ref GraphicsController creates one with
+* the size of the window from the config.json and binds it at the beginning of every frame, in place of the default
+* framebuffer. Read the rendered image back with @ref OffscreenTarget::read_pixels.
+*/
+class OffscreenTarget {
+public:
+    void create(int width, int height);
+
+    void destroy();
+
+    /**
+    * @brief Binds the framebuffer for drawing and reading, and sets the viewport to cover it.
+    */
+    void bind() const;
+
+    bool is_created() const {
+        return m_framebuffer != 0;
+    }
+
+    int width() const {
+        return m_width;
+    }
+
+    int height() const {
+        return m_height;
+    }
+
+    /**
+    * @returns The color buffer as tightly packed RGBA8 rows, bottom row first.
+    */
+    std::vector<uint8_t> read_pixels() const;
+
+private:
+    uint32_t m_framebuffer{0};
+    uint32_t m_color{0};
+    uint32_t m_depth_stencil{0};
+    int m_width{0};
+    int m_height{0};
+};
+} // namespace engine::graphics
+
+#endif//MATF_RG_PROJECT_OFFSCREEN_TARGET_HPP
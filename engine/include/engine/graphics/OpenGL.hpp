@@ -6,8 +6,13 @@
 #ifndef OPENGL_HPP
 #define OPENGL_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <filesystem>
+#include <source_location>
+#include <string_view>
+#include <engine/graphics/GlCapture.hpp>
+#include <engine/graphics/RenderStats.hpp>
 #include <engine/resources/Shader.hpp>
 
 namespace engine::resources {
@@ -25,9 +30,61 @@ class Skybox;
 * CHECKED_GL_CALL(glGenTextures, 1, &texture_id);
 * @endcode
 */
-#define CHECKED_GL_CALL(func, ...) engine::graphics::OpenGL::call(std::source_location::current(), func, __VA_ARGS__)
+#define CHECKED_GL_CALL(func, ...) engine::graphics::OpenGL::call(std::source_location::current(), func __VA_OPT__(,) __VA_ARGS__)
 
 namespace engine::graphics {
+/**
+* @brief How @ref OpenGL::call detects OpenGL errors in debug builds. Release builds never check.
+*/
+enum class GlErrorCheck {
+    /**
+    * @brief No checks.
+    */
+    None,
+    /**
+    * @brief `glGetError` after every call. Exact, but every check is a round trip to the driver.
+    */
+    GetError,
+    /**
+    * @brief The driver reports errors to a `KHR_debug` callback. The call only checks a flag set by the callback.
+    */
+    DebugOutput
+};
+
+/**
+* @brief Active @ref GlErrorCheck mode. Set by the @ref GraphicsController from the `opengl` config section.
+*/
+inline GlErrorCheck g_gl_error_check = GlErrorCheck::GetError;
+
+/**
+* @brief Set by the debug output callback when the driver reports a `GL_DEBUG_TYPE_ERROR` message. @ref OpenGL::call
+* throws it. Messages of the other types are only logged, whatever their severity.
+*/
+inline std::atomic<bool> g_gl_debug_error_pending{false};
+
+/**
+* @brief The location of the last @ref OpenGL::call on this thread. With synchronous debug output, the debug output
+* callback uses it to report where a message comes from.
+*/
+inline thread_local std::source_location g_gl_call_location{};
+
+/**
+* @struct GlDebugOutputConfig
+* @brief Settings for @ref OpenGL::enable_debug_output.
+*/
+struct GlDebugOutputConfig {
+    /**
+    * @brief Messages below this severity are filtered out by the driver: 0 notification, 1 low, 2 medium, 3 high.
+    */
+    int min_severity{1};
+    /**
+    * @brief Deliver messages inside the offending call, so the location is exact. Without it, the driver may report them
+    * later, from a thread of its own: the messages are logged without a call location, and errors are raised by the
+    * next checked call, which is not necessarily the one that caused them.
+    */
+    bool synchronous{true};
+};
+
 /**
 * @class OpenGL
 * @brief This class serves as the OpenGL interface for your app, since the engine doesn't directly link OpenGL to the app executable.
@@ -49,18 +106,31 @@ public:
     */
     template<typename TResult, typename... TOpenGLArgs, typename... Args>
     static TResult call(std::source_location location, TResult (*glfun)(TOpenGLArgs...), Args... args) {
+        ++g_render_stats.gl_calls;
         // @formatter:off
+        #ifndef NDEBUG
+            g_gl_call_location = location;
+        #endif
         if constexpr (!std::is_same_v<TResult, void>) {
             auto result = glfun(std::forward<Args>(args)...);
             #ifndef NDEBUG
-                assert_no_error(location);
+                check_call(location);
             #endif
+            if (g_gl_capture) [[unlikely]] {
+                const std::array<uint64_t, sizeof...(TOpenGLArgs)> encoded{GlCapture::encode_arg<TOpenGLArgs>(args)...};
+                g_gl_capture->record(location, reinterpret_cast<const void *>(glfun), encoded,
+                                     GlCapture::encode_arg(result));
+            }
             return result;
         } else {
             glfun(std::forward<Args>(args)...);
             #ifndef NDEBUG
-                assert_no_error(location);
+                check_call(location);
             #endif
+            if (g_gl_capture) [[unlikely]] {
+                const std::array<uint64_t, sizeof...(TOpenGLArgs)> encoded{GlCapture::encode_arg<TOpenGLArgs>(args)...};
+                g_gl_capture->record(location, reinterpret_cast<const void *>(glfun), encoded, 0);
+            }
         }
         // @formatter:on
     }
@@ -93,6 +163,11 @@ public:
     */
     static uint32_t init_skybox_cube();
 
+    /**
+    * @brief Deletes the cube created by @ref OpenGL::init_skybox_cube, if it was created.
+    */
+    static void destroy_skybox_cube();
+
     /**
     * @brief Check if the shader with the `shader_id` compiled successfully.
     * @returns true if the shader compilation succeeded, false otherwise.
@@ -141,7 +216,43 @@ public:
     */
     static std::string get_compilation_error_message(uint32_t shader_id);
 
+    /**
+    * @brief Installs a `KHR_debug` message callback. The context should be created as a debug context, see the `opengl`
+    * section of the config.json.
+    * @param get_proc_address Loader for the debug functions, which the core 3.3 loader doesn't load.
+    * @returns false if the driver doesn't support `KHR_debug`.
+    */
+    static bool enable_debug_output(void *(*get_proc_address)(const char *), const GlDebugOutputConfig &config);
+
+    /**
+    * @returns Whether the context version is at least `major`.`minor`.
+    */
+    static bool has_version(int major, int minor);
+
+    /**
+    * @returns Whether the driver exposes the extension, e.g. "GL_ARB_buffer_storage".
+    */
+    static bool has_extension(std::string_view name);
+
 private:
+    static void check_call(std::source_location location) {
+        switch (g_gl_error_check) {
+            case GlErrorCheck::GetError: assert_no_error(location);
+                break;
+            case GlErrorCheck::DebugOutput:
+                if (g_gl_debug_error_pending.load(std::memory_order_relaxed)) {
+                    throw_debug_output_error(location);
+                }
+                break;
+            case GlErrorCheck::None: break;
+        }
+    }
+
+    /**
+    * @brief Throws the error reported by the debug output callback.
+    */
+    [[noreturn]] static void throw_debug_output_error(std::source_location location);
+
     /**
     * @brief Throws an engine::util::EngineError of type @ref engine::util::EngineError::Type::OpenGLError if an OpenGL error occurred. Used internally.
     * @param location Source location from where the OpenGL call was made.
@@ -0,0 +1,105 @@
+/**
+ * @file RenderStats.hpp
+ * @brief Defines the per-frame renderer counters and the RenderStatsRecorder that collects them.
+ */
+
+#ifndef MATF_RG_PROJECT_RENDER_STATS_HPP
+#define MATF_RG_PROJECT_RENDER_STATS_HPP
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace engine::graphics {
+/**
+* @struct RenderStats
+* @brief What the renderer submitted in one frame.
+*/
+struct RenderStats {
+    uint64_t frame;
+    uint32_t draw_calls;
+    uint64_t triangles;
+    uint32_t instances;
+    uint32_t program_binds;
+    uint32_t vao_binds;
+    uint32_t texture_binds;
+    uint32_t uniform_uploads;
+    uint64_t buffer_bytes_uploaded;
+    /**
+    * @brief Calls made through @ref OpenGL::call (CHECKED_GL_CALL).
+    */
+    uint32_t gl_calls;
+    /**
+    * @brief CPU time from @ref GraphicsController::begin_draw to @ref GraphicsController::end_draw, i.e. the time
+    * the controllers spent submitting the frame, without the buffer swap.
+    */
+    float submit_ms;
+    /**
+    * @brief CPU time spent at the beginning of the frame waiting for the GPU, see @ref FramesInFlight.
+    */
+    float gpu_wait_ms;
+};
+
+/**
+* @brief Counters of the frame that is being recorded. The draw paths add to it directly:
+* @code
+* ++g_render_stats.draw_calls;
+* g_render_stats.triangles += index_count / 3;
+* @endcode
+*/
+inline RenderStats g_render_stats{};
+
+/**
+* @class RenderStatsRecorder
+* @brief Closes the per-frame counters, keeps a short history for the panel and optionally writes every frame as a CSV row.
+*
+* Owned by the @ref GraphicsController, get it with @ref GraphicsController::render_stats. The CSV dump can be
+* started from the panel or with `"render_stats": { "csv": "render_stats.csv" }` in the config.json.
+*/
+class RenderStatsRecorder {
+public:
+    static constexpr std::size_t HISTORY_SIZE = 120;
+
+    void begin_frame();
+
+    void end_frame();
+
+    /**
+    * @returns Counters of the last completed frame.
+    */
+    const RenderStats &last_frame() const {
+        return m_last;
+    }
+
+    /**
+    * @brief Starts writing one CSV row per frame to `path`.
+    * @returns false, after logging a warning, if the file can't be opened.
+    */
+    bool start_csv(const std::filesystem::path &path);
+
+    void stop_csv();
+
+    bool is_writing_csv() const {
+        return m_csv.is_open();
+    }
+
+    /**
+    * @brief Draws the renderer stats panel. Call between @ref GraphicsController::begin_gui and @ref GraphicsController::end_gui.
+    */
+    void draw_gui();
+
+private:
+    void write_csv_row(const RenderStats &stats);
+
+    RenderStats m_last{};
+    uint64_t m_frame{0};
+    uint64_t m_frame_begin_ns{0};
+    std::array<float, HISTORY_SIZE> m_submit_ms_history{};
+    std::array<float, HISTORY_SIZE> m_draw_calls_history{};
+    std::size_t m_history_head{0};
+    std::ofstream m_csv;
+};
+} // namespace engine::graphics
+
+#endif//MATF_RG_PROJECT_RENDER_STATS_HPP
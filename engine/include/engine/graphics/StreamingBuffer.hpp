@@ -0,0 +1,174 @@
+/**
+ * @file StreamingBuffer.hpp
+ * @brief Defines the StreamingBuffer, a ring of per-frame regions in one GL buffer for data that is written every frame.
+ */
+
+#ifndef MATF_RG_PROJECT_STREAMING_BUFFER_HPP
+#define MATF_RG_PROJECT_STREAMING_BUFFER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace engine::graphics {
+/**
+* @struct StreamingAllocation
+* @brief Memory handed out by @ref StreamingBuffer::allocate.
+*/
+struct StreamingAllocation {
+    /**
+    * @brief Where to write the data. Write only, never read from it, it may be uncached GPU memory.
+    */
+    void *data;
+    /**
+    * @brief Offset of the data from the start of @ref StreamingBuffer::buffer, for `glVertexAttribPointer`,
+    * `glDrawElements` or `glBindBufferRange`.
+    */
+    std::size_t offset;
+};
+
+/**
+* @class StreamingBuffer
+* @brief Hands out write-only memory in a GL buffer for data that changes every frame: UI and debug geometry,
+* particles, sprites, per-draw constants.
+*
+* The buffer is split into @ref StreamingBuffer::FRAME_COUNT regions, one per frame in a ring. A frame allocates
+* linearly from its region, and @ref StreamingBuffer::end_frame places a fence behind the frame's draws. A region is
+* reused only after its fence has signaled, so writing into it never races the GPU, and the CPU only waits when it
+* runs more than @ref StreamingBuffer::FRAME_COUNT frames ahead; those waits are counted by @ref StreamingBuffer::stalls.
+* With the @ref FramesInFlight limiter below @ref StreamingBuffer::FRAME_COUNT frames, it never does.
+*
+* With GL 4.4 or `GL_ARB_buffer_storage` the buffer is mapped once, persistently and coherently. On plain 3.3 the
+* free part of the region is mapped unsynchronized on the first allocation of a batch, and has to be unmapped with
+* @ref StreamingBuffer::flush before the draws that read it:
+* @code
+* auto stream = graphics->streaming_buffer();
+* auto vertices = stream->allocate(count * sizeof(Vertex), alignof(Vertex));
+* std::memcpy(vertices.data, lines.data(), count * sizeof(Vertex));
+* stream->flush();
+* CHECKED_GL_CALL(glBindBuffer, GL_ARRAY_BUFFER, stream->buffer());
+* CHECKED_GL_CALL(glVertexAttribPointer, 0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) vertices.offset);
+* @endcode
+* Writes through the mapping are not GL calls. While a @ref GlCapture records, the allocations point into a CPU copy
+* of the region instead, and @ref StreamingBuffer::flush copies them to the mapping and records them with
+* @ref GlCapture::record_buffer_data. That costs a copy per flush, only during a capture.
+*/
+class StreamingBuffer {
+public:
+    static constexpr std::size_t FRAME_COUNT = 3;
+
+    /**
+    * @brief Creates the buffer with `frame_capacity` bytes for every frame. `category` names it in the
+    * @ref GpuResourceTracker, use a string literal.
+    */
+    void create(std::size_t frame_capacity, std::string_view category);
+
+    void destroy();
+
+    bool is_created() const {
+        return m_buffer != 0;
+    }
+
+    /**
+    * @returns Whether the buffer is persistently mapped, i.e. @ref StreamingBuffer::flush is a no-op.
+    */
+    bool is_persistent() const {
+        return m_persistent != nullptr;
+    }
+
+    uint32_t buffer() const {
+        return m_buffer;
+    }
+
+    std::size_t frame_capacity() const {
+        return m_frame_capacity;
+    }
+
+    /**
+    * @brief Moves to the next region, waiting for the GPU only if it's still reading it.
+    */
+    void begin_frame();
+
+    /**
+    * @brief Reserves `bytes` in the current frame's region. `alignment` must be a power of two.
+    * @throws EngineError if the region is full; raise the capacity.
+    */
+    StreamingAllocation allocate(std::size_t bytes, std::size_t alignment = 16);
+
+    /**
+    * @brief Makes the writes since the last flush visible to the GPU. Call it before the draws that read them.
+    * Also flushes the persistent mapping into a running @ref GlCapture, @ref StreamingBuffer::end_frame does it for
+    * the writes that weren't flushed.
+    */
+    void flush();
+
+    /**
+    * @brief Flushes and fences the current frame's region.
+    */
+    void end_frame();
+
+    /**
+    * @returns Bytes allocated in the current frame.
+    */
+    std::size_t used() const {
+        return m_head;
+    }
+
+    /**
+    * @returns The most bytes a frame has allocated.
+    */
+    std::size_t peak_used() const {
+        return m_peak_used;
+    }
+
+    /**
+    * @returns How many times the CPU had to wait for the GPU to release a region, and for how long in total.
+    */
+    uint64_t stalls() const {
+        return m_stalls;
+    }
+
+    uint64_t stall_ns() const {
+        return m_stall_ns;
+    }
+
+private:
+    std::size_t region_begin() const {
+        return m_region * m_frame_capacity;
+    }
+
+    uint32_t m_buffer{0};
+    std::size_t m_frame_capacity{0};
+    std::size_t m_region{FRAME_COUNT - 1};
+    std::size_t m_head{0};
+    std::size_t m_peak_used{0};
+    /**
+    * @brief The whole buffer when it's persistently mapped.
+    */
+    uint8_t *m_persistent{nullptr};
+    /**
+    * @brief The current 3.3 mapping, which starts at @ref StreamingBuffer::m_mapped_begin of the region.
+    */
+    uint8_t *m_mapped{nullptr};
+    std::size_t m_mapped_begin{0};
+    /**
+    * @brief Whether a @ref GlCapture was recording when the frame began, then the writes go to m_capture_shadow.
+    */
+    bool m_capturing{false};
+    /**
+    * @brief The current region's data while capturing, and the offset up to which it's recorded.
+    */
+    std::vector<uint8_t> m_capture_shadow;
+    std::size_t m_captured_head{0};
+    /**
+    * @brief `GLsync` of every region, null when the region is free.
+    */
+    std::array<void *, FRAME_COUNT> m_fences{};
+    uint64_t m_stalls{0};
+    uint64_t m_stall_ns{0};
+};
+} // namespace engine::graphics
+
+#endif//MATF_RG_PROJECT_STREAMING_BUFFER_HPP
@@ -0,0 +1,156 @@
+/**
+ * @file UniformBlock.hpp
+ * @brief Defines the std140 layout descriptions of the C++ structs that are uploaded as uniform blocks.
+ */
+
+#ifndef MATF_RG_PROJECT_UNIFORM_BLOCK_HPP
+#define MATF_RG_PROJECT_UNIFORM_BLOCK_HPP
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace engine::graphics {
+/**
+* @struct UniformMember
+* @brief A member of a uniform block struct: its GLSL name and its place in the struct.
+*/
+struct UniformMember {
+    std::string_view name;
+    std::size_t offset;
+    std::size_t size;
+    /**
+    * @brief The std140 base alignment of the member's type.
+    */
+    std::size_t alignment;
+};
+
+/**
+* @brief Size and std140 base alignment of the GLSL type that a C++ type is uploaded as. `mat3` and arrays are left out
+* on purpose: std140 pads their elements to 16 bytes, so they don't match the tightly packed glm types.
+*/
+template<typename T>
+struct Std140;
+
+template<>
+struct Std140<float> {
+    static constexpr std::size_t SIZE = 4, ALIGNMENT = 4;
+};
+
+template<>
+struct Std140<int32_t> {
+    static constexpr std::size_t SIZE = 4, ALIGNMENT = 4;
+};
+
+template<>
+struct Std140<uint32_t> {
+    static constexpr std::size_t SIZE = 4, ALIGNMENT = 4;
+};
+
+template<>
+struct Std140<glm::vec2> {
+    static constexpr std::size_t SIZE = 8, ALIGNMENT = 8;
+};
+
+template<>
+struct Std140<glm::vec3> {
+    static constexpr std::size_t SIZE = 12, ALIGNMENT = 16;
+};
+
+template<>
+struct Std140<glm::vec4> {
+    static constexpr std::size_t SIZE = 16, ALIGNMENT = 16;
+};
+
+template<>
+struct Std140<glm::mat4> {
+    static constexpr std::size_t SIZE = 64, ALIGNMENT = 16;
+};
+
+/**
+* @brief Describes the member `name` of type `TMember` at `offset`, use `offsetof` for the offset.
+*/
+template<typename TMember>
+constexpr UniformMember uniform_member(std::string_view name, std::size_t offset) {
+    return UniformMember{name, offset, Std140<TMember>::SIZE, Std140<TMember>::ALIGNMENT};
+}
+
+/**
+* @returns `offset` rounded up to a multiple of `alignment`.
+*/
+constexpr std::size_t align_up(std::size_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+/**
+* @returns Whether the members of `TBlock` are exactly where std140 puts them: each one at the first offset
+* aligned to its base alignment after the previous one, with the struct size a multiple of a vec4.
+* A gap the GLSL block doesn't have would shift every member after it, so it is rejected too.
+* Checked at compile time by everything that uploads a block.
+*/
+template<typename TBlock>
+constexpr bool has_std140_layout() {
+    std::size_t end = 0;
+    for (const auto &member: TBlock::members()) {
+        if (member.offset != align_up(end, member.alignment)) {
+            return false;
+        }
+        end = member.offset + member.size;
+    }
+    return end <= sizeof(TBlock) && sizeof(TBlock) % 16 == 0;
+}
+
+/**
+* @struct UniformSlice
+* @brief A block uploaded into the @ref StreamingBuffer by @ref GraphicsController::push_uniforms.
+*/
+struct UniformSlice {
+    std::size_t offset;
+    std::size_t size;
+};
+
+/**
+* @struct DrawConstants
+* @brief Per-draw constants. The matching GLSL block, in every stage that reads it:
+* @code
+* layout (std140) uniform DrawConstants {
+*     mat4 model;
+*     mat4 normal_matrix;
+*     vec4 tint;
+* };
+* @endcode
+* A uniform block struct names its GLSL block, its binding point and its members; see @ref resources::Shader::bind_uniform_block.
+*/
+struct DrawConstants {
+    static constexpr std::string_view BLOCK_NAME = "DrawConstants";
+    static constexpr uint32_t BINDING = 0;
+
+    glm::mat4 model;
+    /**
+    * @brief `transpose(inverse(model))`, a mat4 so that it has no std140 padding. Use `mat3(normal_matrix)` in GLSL.
+    */
+    glm::mat4 normal_matrix;
+    glm::vec4 tint;
+
+    static constexpr std::array<UniformMember, 3> members() {
+        return {
+                uniform_member<glm::mat4>("model", offsetof(DrawConstants, model)),
+                uniform_member<glm::mat4>("normal_matrix", offsetof(DrawConstants, normal_matrix)),
+                uniform_member<glm::vec4>("tint", offsetof(DrawConstants, tint)),
+        };
+    }
+
+    /**
+    * @returns The constants of a draw with the `model` transform.
+    */
+    static DrawConstants from_model(const glm::mat4 &model, const glm::vec4 &tint = glm::vec4(1.0f)) {
+        return DrawConstants{model, glm::transpose(glm::inverse(model)), tint};
+    }
+};
+
+static_assert(has_std140_layout<DrawConstants>());
+} // namespace engine::graphics
+
+#endif//MATF_RG_PROJECT_UNIFORM_BLOCK_HPP
@@ -0,0 +1,190 @@
+/**
+ * @file FramePacer.hpp
+ * @brief Defines the FramePacer that caps the frame rate, sets the swap interval and keeps frame time statistics.
+ */
+
+#ifndef MATF_RG_PROJECT_FRAME_PACER_HPP
+#define MATF_RG_PROJECT_FRAME_PACER_HPP
+
+#include <json.hpp>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace engine::platform {
+/**
+* @brief Swap interval of the window, i.e. how @ref PlatformController::swap_buffers waits for the display.
+*/
+enum class VSync {
+    /**
+    * @brief Swaps right away, the frames tear.
+    */
+    Off,
+    /**
+    * @brief Waits for the vertical blank.
+    */
+    On,
+    /**
+    * @brief Waits for the vertical blank, unless the frame missed it, in which case it swaps right away and tears
+    * instead of waiting for the next one. Falls back to @ref VSync::On without `*_EXT_swap_control_tear`.
+    */
+    Adaptive,
+};
+
+/**
+* @struct FramePacingStats
+* @brief Frame time statistics over the last `stats_window` frames.
+*/
+struct FramePacingStats {
+    float mean_ms;
+    /**
+    * @brief Variance of the frame time, in ms².
+    */
+    float variance_ms;
+    float stddev_ms;
+    float min_ms;
+    float max_ms;
+    /**
+    * @brief Time the last frame slept and spun at the frame boundary.
+    */
+    float wait_ms;
+    /**
+    * @brief Frames that reached the frame boundary after it had passed, since the start.
+    */
+    uint64_t missed_frames;
+};
+
+/**
+* @class FramePacer
+* @brief Caps the frame rate at `target_fps` and measures how evenly the frames are paced.
+*
+* At the start of every frame, @ref FramePacer::wait waits for the frame boundary: it sleeps in 1 ms steps while the
+* boundary is further away than a sleep is expected to take, then spins the rest. The expected sleep is the mean plus
+* one standard deviation of the recently measured sleeps, but at least `spin_ms`, so the scheduler's oversleep never
+* makes a frame late, and the spin stays short. The boundaries are a fixed period apart, a late frame doesn't shift the
+* ones after it unless it's more than a period late.
+*
+* Owned by the @ref PlatformController, which calls it in `loop`. Configured by the `frame_pacing` section of the
+* config.json:
+* @code
+* "frame_pacing": { "target_fps": 60, "vsync": "off", "spin_ms": 0.25, "smoothing": 0.1, "stats_window": 120 }
+* @endcode
+* A `target_fps` of 0 doesn't cap the frame rate. `vsync` is `off`, `on` or `adaptive`. Capping below the refresh rate
+* with vsync off keeps the CPU and GPU mostly idle, capping with vsync on is only useful below the refresh rate.
+*/
+class FramePacer {
+public:
+    void configure(const nlohmann::json &config);
+
+    /**
+    * @brief Sets the swap interval of the current context from @ref FramePacer::vsync. Called by the
+    * @ref PlatformController only when there is a window to swap, i.e. not headless or with the null renderer.
+    */
+    void apply_swap_interval();
+
+    float target_fps() const {
+        return m_target_fps;
+    }
+
+    /**
+    * @brief Caps the frame rate, zero removes the cap. The next boundary is a period after the current frame's.
+    */
+    void set_target_fps(float fps);
+
+    /**
+    * @brief Starts the boundaries over from the next frame, e.g. after the loop waited for events.
+    */
+    void restart() {
+        m_next_frame_ns = 0;
+    }
+
+    VSync vsync() const {
+        return m_vsync;
+    }
+
+    /**
+    * @brief Changes the swap interval of the current context, if @ref FramePacer::apply_swap_interval was called
+    * before. Otherwise only the setting changes.
+    */
+    void set_vsync(VSync vsync);
+
+    /**
+    * @brief Waits for the frame boundary.
+    * @returns Milliseconds spent waiting.
+    */
+    float wait();
+
+    /**
+    * @brief Adds the measured frame time to the statistics and the smoothed dt.
+    */
+    void end_frame(float dt);
+
+    /**
+    * @returns Exponential moving average of the frame time in seconds, with the `smoothing` weight for the new frame.
+    * Steadier than the measured dt for animations and camera motion; the simulation should still use the measured one.
+    */
+    float smoothed_dt() const {
+        return m_smoothed_dt;
+    }
+
+    const FramePacingStats &stats() const {
+        return m_stats;
+    }
+
+    /**
+    * @returns The scheduler's expected time for a 1 ms sleep, the spin threshold of @ref FramePacer::wait.
+    */
+    float sleep_estimate_ms() const {
+        return m_sleep_estimate_ms;
+    }
+
+    /**
+    * @brief Draws the pacing settings and the frame time statistics in an ImGui window.
+    */
+    void draw_gui();
+
+    static std::string_view to_string(VSync vsync);
+
+private:
+    /**
+    * @brief Sleeps and spins until `deadline_ns` on the @ref util::Profiler::now_ns clock.
+    */
+    void sleep_until(uint64_t deadline_ns);
+
+    void update_sleep_estimate(double slept_ms);
+
+    void update_stats();
+
+    float m_target_fps{0.0f};
+    VSync m_vsync{VSync::On};
+    /**
+    * @brief Whether the swap interval was applied, i.e. the context has a window to swap.
+    */
+    bool m_swap_interval_applied{false};
+    float m_spin_ms{0.25f};
+    float m_smoothing{0.1f};
+    std::size_t m_stats_window{120};
+
+    /**
+    * @brief Next frame boundary, 0 until the first capped frame.
+    */
+    uint64_t m_next_frame_ns{0};
+    /**
+    * @brief Exponentially weighted mean and variance of the measured 1 ms sleeps, so the estimate follows the load.
+    */
+    uint64_t m_sleeps{0};
+    double m_sleep_mean_ms{0.0};
+    double m_sleep_variance{0.0};
+    float m_sleep_estimate_ms{0.25f};
+
+    float m_smoothed_dt{0.0f};
+    /**
+    * @brief Ring of the last frame times in ms, in arrival order until it fills up.
+    */
+    std::vector<float> m_frame_ms;
+    uint64_t m_frame{0};
+    FramePacingStats m_stats{};
+};
+} // namespace engine::platform
+
+#endif//MATF_RG_PROJECT_FRAME_PACER_HPP
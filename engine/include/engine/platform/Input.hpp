@@ -6,6 +6,10 @@
 #ifndef INPUT_HPP
 #define INPUT_HPP
 
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 namespace engine::platform {
@@ -226,9 +230,117 @@ public:
         return (m_state == State::Released || m_state == State::JustReleased);
     }
 
+    /**
+    * @returns The time, in seconds since the platform initialization, of the last press or release event of the key.
+    */
+    double timestamp() const {
+        return m_timestamp;
+    }
+
 private:
     KeyId m_key = KEY_COUNT;
     State m_state = State::Released;
+    double m_timestamp = 0.0;
+};
+
+/**
+* @class KeySet
+* @brief A set of @ref KeyId packed into 64-bit words, one bit per key.
+* Set operations work on whole words, so their cost doesn't depend on the number of keys.
+*/
+class KeySet {
+public:
+    static constexpr std::size_t WORD_BITS = 64;
+    static constexpr std::size_t WORD_COUNT = (KEY_COUNT + WORD_BITS - 1) / WORD_BITS;
+
+    void set(KeyId key, bool value = true) {
+        const uint64_t bit = uint64_t{1} << (key % WORD_BITS);
+        if (value) {
+            m_words[key / WORD_BITS] |= bit;
+        } else {
+            m_words[key / WORD_BITS] &= ~bit;
+        }
+    }
+
+    bool test(KeyId key) const {
+        return (m_words[key / WORD_BITS] >> (key % WORD_BITS)) & 1;
+    }
+
+    void clear() {
+        m_words.fill(0);
+    }
+
+    bool empty() const {
+        for (uint64_t word: m_words) {
+            if (word) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+    * @brief Calls `func(KeyId)` for every key in the set. Skips empty words, so the cost depends on the number of keys in the set.
+    */
+    template<typename Func>
+    void for_each(Func func) const {
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            for (uint64_t word = m_words[i]; word; word &= word - 1) {
+                func(static_cast<KeyId>(i * WORD_BITS + std::countr_zero(word)));
+            }
+        }
+    }
+
+    KeySet operator|(const KeySet &other) const {
+        KeySet result;
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            result.m_words[i] = m_words[i] | other.m_words[i];
+        }
+        return result;
+    }
+
+    KeySet operator&(const KeySet &other) const {
+        KeySet result;
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            result.m_words[i] = m_words[i] & other.m_words[i];
+        }
+        return result;
+    }
+
+    /**
+    * @returns Keys that are in this set, but not in the `other`.
+    */
+    KeySet operator-(const KeySet &other) const {
+        KeySet result;
+        for (std::size_t i = 0; i < WORD_COUNT; ++i) {
+            result.m_words[i] = m_words[i] & ~other.m_words[i];
+        }
+        return result;
+    }
+
+    bool operator==(const KeySet &) const = default;
+
+private:
+    std::array<uint64_t, WORD_COUNT> m_words{};
+};
+
+/**
+* @struct KeyEvent
+* @brief A key or mouse button event as delivered by the platform, in the order it happened.
+*/
+struct KeyEvent {
+    enum class Action {
+        Press,
+        Release,
+        Repeat
+    };
+
+    KeyId key;
+    Action action;
+    /**
+    * @brief Time of the event in seconds since the platform initialization.
+    */
+    double timestamp;
 };
 
 /**
@@ -258,5 +370,18 @@ struct MousePosition {
     */
     float scroll;
 };
+
+/**
+* @struct MouseSample
+* @brief A single cursor position reported by the platform, see @ref PlatformController::set_mouse_samples_enabled.
+*/
+struct MouseSample {
+    float x;
+    float y;
+    /**
+    * @brief Time of the sample in seconds since the platform initialization.
+    */
+    double timestamp;
+};
 }
 #endif //INPUT_HPP
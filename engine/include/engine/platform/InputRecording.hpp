@@ -0,0 +1,88 @@
+/**
+ * @file InputRecording.hpp
+ * @brief Defines the InputRecording class that stores the platform input per frame, so a session can be played back.
+ */
+
+#ifndef MATF_RG_PROJECT_INPUT_RECORDING_HPP
+#define MATF_RG_PROJECT_INPUT_RECORDING_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace engine::platform {
+/**
+* @struct RecordedInputEvent
+* @brief An input event as the platform callbacks received it.
+*/
+struct RecordedInputEvent {
+    enum class Type : uint8_t {
+        /**
+        * @brief Cursor moved to (`x`, `y`).
+        */
+        Mouse,
+        /**
+        * @brief Scrolled by (`x`, `y`).
+        */
+        Scroll,
+        /**
+        * @brief Platform key `code` got the platform `action`.
+        */
+        Keyboard,
+        /**
+        * @brief Platform mouse button `code` got the platform `action`.
+        */
+        MouseButton,
+    };
+
+    Type type;
+    int32_t code;
+    int32_t action;
+    double x;
+    double y;
+};
+
+/**
+* @class InputRecording
+* @brief The input events of consecutive frames. Recorded with `--record-input <path>` and played back with
+* @ref PlatformController::play_input_recording, e.g. by a benchmark script.
+*
+* The events are stored in the frame in which they were polled. Playing them back in the same frames, with a fixed
+* timestep, reproduces the session.
+*/
+class InputRecording {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    static InputRecording load(const std::filesystem::path &path);
+
+    void save(const std::filesystem::path &path) const;
+
+    /**
+    * @brief Starts a new frame, the events added after it belong to it.
+    */
+    void new_frame() {
+        m_frame_offsets.push_back(m_events.size());
+    }
+
+    void add(const RecordedInputEvent &event) {
+        m_events.push_back(event);
+    }
+
+    std::size_t frame_count() const {
+        return m_frame_offsets.size();
+    }
+
+    std::span<const RecordedInputEvent> frame(std::size_t index) const;
+
+private:
+    std::vector<RecordedInputEvent> m_events;
+    /**
+    * @brief Index of the first event of each frame in @ref m_events.
+    */
+    std::vector<std::size_t> m_frame_offsets;
+};
+} // namespace engine::platform
+
+#endif//MATF_RG_PROJECT_INPUT_RECORDING_HPP
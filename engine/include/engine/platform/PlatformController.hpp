@@ -7,11 +7,20 @@
 #define MATF_RG_PROJECT_PLATFORM_H
 
 #include <engine/core/Controller.hpp>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <span>
+#include <string_view>
+#include <thread>
 #include <vector>
+#include <engine/platform/FramePacer.hpp>
 #include <engine/platform/Input.hpp>
+#include <engine/platform/InputRecording.hpp>
 #include <engine/platform/Window.hpp>
 #include <engine/platform/PlatformEventObserver.hpp>
+#include <engine/util/HitchDetector.hpp>
 
 struct GLFWwindow;
 
@@ -35,6 +44,44 @@ struct FrameTime {
     * @brief Time from the initialization of the Platform to the moment when the current frame began.
     */
     float current;
+
+    /**
+    * @brief @ref FramePacer::smoothed_dt of the previous frame, or the fixed timestep when there is one.
+    */
+    float smoothed_dt;
+};
+
+/**
+* @struct InputLatency
+* @brief Time from the newest input event consumed by a frame to the return of @ref PlatformController::swap_buffers for that frame.
+* It's a lower bound of the input-to-photon latency, the compositor and the display add to it.
+*/
+struct InputLatency {
+    float last_ms;
+    /**
+    * @brief Exponential moving average over the recent frames.
+    */
+    float average_ms;
+    float max_ms;
+    /**
+    * @brief Number of frames that consumed input.
+    */
+    uint64_t frames;
+};
+
+/**
+* @brief What the user can see of the window, see @ref PlatformController::window_activity.
+*/
+enum class WindowActivity {
+    Focused,
+    /**
+    * @brief Visible, but another window has the input focus.
+    */
+    Unfocused,
+    /**
+    * @brief Minimized, hidden or with an empty framebuffer: nothing that is drawn can be seen.
+    */
+    Hidden,
 };
 
 /**
@@ -52,17 +99,147 @@ public:
     const Key &key(KeyId key) const;
 
     /**
-    * @brief Get the state of the @ref MousePosition in the current frame
+    * @returns Keys that are down in the current frame.
+    */
+    const KeySet &keys_down() const {
+        return m_keys_current;
+    }
+
+    /**
+    * @returns Keys that went down in the current frame.
+    */
+    const KeySet &keys_just_pressed() const {
+        return m_keys_just_pressed;
+    }
+
+    /**
+    * @returns Keys that went up in the current frame.
+    */
+    const KeySet &keys_just_released() const {
+        return m_keys_just_released;
+    }
+
+    /**
+    * @returns Key and mouse button events received in the current frame, in the order they happened.
+    */
+    std::span<const KeyEvent> key_events() const {
+        return m_key_events;
+    }
+
+    /**
+    * @brief Get the state of the @ref MousePosition in the current frame.
+    * `dx`, `dy` and `scroll` are accumulated over all the events received in the frame.
     * @returns @ref MousePosition for the current frame.
     */
     const MousePosition &mouse() const;
 
+    /**
+    * @brief Enables buffering of every cursor position received in a frame.
+    * Off by default: observers get one coalesced @ref PlatformEventObserver::on_mouse_move per frame, which is
+    * all that camera controls need. Turn it on for consumers that need sub-frame precision (drawing, gestures...).
+    */
+    void set_mouse_samples_enabled(bool enabled);
+
+    /**
+    * @returns Cursor positions received in the current frame, with timestamps. Empty unless @ref set_mouse_samples_enabled.
+    */
+    std::span<const MouseSample> mouse_samples() const {
+        return m_mouse_samples;
+    }
+
+    /**
+    * @brief Requests unscaled and unaccelerated mouse motion while the cursor is disabled, if the platform supports it.
+    * Can also be enabled with `"input": { "raw_mouse_motion": true }` in the config.json.
+    */
+    void set_raw_mouse_motion(bool enabled);
+
+    bool raw_mouse_motion() const {
+        return m_raw_mouse_motion;
+    }
+
+    /**
+    * @brief Re-samples the cursor position right before the frame is submitted (late latching).
+    *
+    * Call it after @ref core::App::update, just before drawing the camera-dependent geometry, and apply the returned
+    * delta to the camera. The motion it returns is not reported again in the next frame.
+    * @code
+    * auto delta = platform->latch_mouse();
+    * camera->rotate_camera(delta.dx, delta.dy);
+    * @endcode
+    * The latched motion doesn't change @ref PlatformController::input_latency, which is measured from input events.
+    * @returns Cursor position now, and `dx`/`dy` since the last position the engine has seen.
+    */
+    MousePosition latch_mouse();
+
+    /**
+    * @returns Input-to-present latency statistics, updated in @ref PlatformController::swap_buffers.
+    */
+    const InputLatency &input_latency() const {
+        return m_input_latency;
+    }
+
+    void reset_input_latency() {
+        m_input_latency = {};
+    }
+
+    /**
+    * @brief Whether the platform runs without a display: no visible window and no input, with an offscreen context.
+    * Enabled with `"platform": { "headless": true }` in the config.json, or `--headless 1` on the command line.
+    */
+    bool headless() const {
+        return m_headless;
+    }
+
+    /**
+    * @brief Sets the GLFW window hints for an offscreen context, `context_api` is egl or osmesa.
+    * GLFW has to be initialized with `GLFW_PLATFORM_NULL`. Used by the gl-replay tool as well.
+    */
+    static void set_headless_window_hints(std::string_view context_api);
+
+    /**
+    * @brief Whether the window was created without an OpenGL context, for the @ref graphics::NullRenderer.
+    */
+    bool null_renderer() const {
+        return m_null_renderer;
+    }
+
+    /**
+    * @brief Advances the frame time by `dt` seconds every frame instead of measuring it, so simulations are
+    * reproducible (e.g. in a benchmark). Zero switches back to the measured time.
+    */
+    void set_fixed_timestep(float dt);
+
+    float fixed_timestep() const {
+        return m_fixed_dt;
+    }
+
+    /**
+    * @brief Feeds the frames of `recording` to the engine, one per @ref core::App::poll_events, in place of the live input.
+    * Record a session with `--record-input <path>`.
+    */
+    void play_input_recording(InputRecording recording);
+
+    bool is_playing_input() const {
+        return m_playing_input;
+    }
+
+    /**
+    * @returns Whether every frame of the played back recording was fed.
+    */
+    bool input_playback_finished() const {
+        return m_input_playback_frame == m_input_playback.frame_count();
+    }
+
     /**
     * @brief Get the name of the Controller
     * @returns "PlatformController"
     */
     std::string_view name() const override;
 
+    std::string_view subsystem() const override {
+        return "platform";
+    }
+
     /**
     * @brief Get the window
     * @returns @ref Window
@@ -93,6 +270,58 @@ public:
         return m_frame_time.dt;
     }
 
+    /**
+    * @brief Get the smoothed elapsed time for the previous frame, see @ref FramePacer::smoothed_dt.
+    */
+    float smoothed_dt() const {
+        return m_frame_time.smoothed_dt;
+    }
+
+    /**
+    * @brief Get the @ref FramePacer that caps the frame rate at the start of every @ref core::App::loop.
+    */
+    FramePacer *frame_pacer() {
+        return &m_frame_pacer;
+    }
+
+    /**
+    * @brief Whether the window is focused, in the background or hidden. GLFW doesn't report windows covered by other
+    * windows, so an occluded window counts as unfocused.
+    */
+    WindowActivity window_activity() const {
+        return m_window_activity;
+    }
+
+    /**
+    * @brief Enables on-demand rendering: frames are drawn only after input, a window change or
+    * @ref PlatformController::request_redraw, and in between @ref core::App::poll_events sleeps until an event arrives.
+    * Can also be enabled with `"idle": { "on_demand": true }` in the config.json.
+    */
+    void set_on_demand(bool enabled);
+
+    bool on_demand() const {
+        return m_on_demand;
+    }
+
+    /**
+    * @brief Marks the frame dirty, so it's drawn in on-demand mode. Call it every frame that animates something.
+    * Safe to call from any thread, it wakes up the main thread if it waits for events.
+    */
+    void request_redraw();
+
+    /**
+    * @brief Called by @ref core::App::draw. You shouldn't call this function directly.
+    * @returns Whether the frame has to be drawn, and clears the redraw request.
+    */
+    bool consume_redraw();
+
+    /**
+    * @brief Get the @ref util::HitchDetector, fed the measured frame time every @ref core::App::loop.
+    */
+    util::HitchDetector *hitch_detector() {
+        return &m_hitch_detector;
+    }
+
     /**
     *  @brief Enables/disabled the visibility of the cursor on screen.
     */
@@ -130,6 +359,11 @@ public:
 
     void _platform_on_mouse_button(int button, int action);
 
+    /**
+    * @brief Called from the platform-specific callback when the window is focused, minimized or restored.
+    */
+    void _platform_on_window_state_change();
+
 private:
     Key &key_ref(KeyId key);
 
@@ -147,13 +381,85 @@ private:
 
     void poll_events() override;
 
+    /**
+    * @brief Dispatches the mouse motion and scroll accumulated in this frame to the observers.
+    */
     void update_mouse();
 
-    void update_key(Key &key_data) const;
+    void on_key_event(KeyId key, int action);
+
+    void update_keys();
+
+    void play_input_frame();
+
+    /**
+    * @brief Waits for events instead of polling them while the window is hidden or unfocused, or while nothing has to
+    * be redrawn in on-demand mode.
+    */
+    void wait_events();
+
+    void record_input(const RecordedInputEvent &event);
 
     FrameTime m_frame_time;
+    /**
+    * @brief Measured time of the previous @ref PlatformController::loop, even under a fixed timestep.
+    */
+    double m_last_loop_time{0.0};
+    FramePacer m_frame_pacer;
+    WindowActivity m_window_activity{WindowActivity::Focused};
+    /**
+    * @brief Whether a hidden or unfocused window waits for events, from `idle.throttle`.
+    */
+    bool m_idle_throttle{true};
+    float m_unfocused_fps{10.0f};
+    /**
+    * @brief The longest a wait for events lasts, so the controllers still update now and then.
+    */
+    double m_idle_timeout_s{0.25};
+    bool m_on_demand{false};
+    std::atomic<bool> m_redraw_requested{true};
+    /**
+    * @brief Seconds the current frame waited in @ref PlatformController::wait_events. The hitch detector skips them.
+    */
+    double m_idle_wait_s{0.0};
+    std::thread::id m_main_thread;
+    util::HitchDetector m_hitch_detector;
     Window m_window;
     std::vector<Key> m_keys;
+    /**
+    * @brief Keys that are down according to the events received so far. Written by the platform callbacks.
+    */
+    KeySet m_keys_pending;
+    KeySet m_keys_current;
+    KeySet m_keys_previous;
+    KeySet m_keys_just_pressed;
+    KeySet m_keys_just_released;
+    std::vector<KeyEvent> m_key_events;
+    std::vector<MouseSample> m_mouse_samples;
+    bool m_mouse_samples_enabled{false};
+    bool m_mouse_moved{false};
+    bool m_mouse_scrolled{false};
+    bool m_raw_mouse_motion{false};
+    bool m_headless{false};
+    bool m_null_renderer{false};
+    /**
+    * @brief Timestamp of the newest input event received from the platform.
+    */
+    double m_last_input_time{0.0};
+    /**
+    * @brief Timestamp of the newest input consumed by the current frame, or negative if the frame consumed no input.
+    */
+    double m_frame_input_time{-1.0};
+    InputLatency m_input_latency{};
+    float m_fixed_dt{0.0f};
+    /**
+    * @brief Where the input is saved on terminate, from `--record-input`. Empty if the input isn't recorded.
+    */
+    std::filesystem::path m_input_recording_path;
+    InputRecording m_input_recording;
+    InputRecording m_input_playback;
+    std::size_t m_input_playback_frame{0};
+    bool m_playing_input{false};
     std::vector<std::unique_ptr<PlatformEventObserver> > m_platform_event_observers;
 };
 } // namespace engine
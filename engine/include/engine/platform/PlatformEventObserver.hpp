@@ -7,6 +7,7 @@
 #define PLATFORMEVENTOBSERVER_HPP
 
 #include <engine/platform/Input.hpp>
+#include <span>
 
 namespace engine::platform {
 /**
@@ -22,6 +23,12 @@ public:
     */
     virtual void on_mouse_move(MousePosition position) {}
 
+    /**
+    * @brief Called by @ref engine::platform::PlatformController once per frame with every cursor position reported in that frame,
+    * if the sample buffer is enabled with @ref engine::platform::PlatformController::set_mouse_samples_enabled.
+    */
+    virtual void on_mouse_samples(std::span<const MouseSample> samples) {}
+
     /**
      * @brief Called by @ref engine::platform::PlatformController for every frame in which the scroll button is moved.
      */
@@ -0,0 +1,55 @@
+/**
+ * @file AssimpSceneProcessor.hpp
+ * @brief Defines the AssimpSceneProcessor class that converts an imported Assimp scene into engine meshes.
+ * Used by the ResourcesController; in the public headers so that the engine benchmarks can measure it.
+ */
+
+#ifndef MATF_RG_PROJECT_ASSIMP_SCENE_PROCESSOR_HPP
+#define MATF_RG_PROJECT_ASSIMP_SCENE_PROCESSOR_HPP
+
+#include <assimp/scene.h>
+#include <engine/resources/Mesh.hpp>
+#include <engine/resources/Texture.hpp>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+namespace engine::resources {
+class ResourcesController;
+
+/**
+ * @class AssimpSceneProcessor
+ * @brief Processes the meshes in an Assimp scene.
+ */
+class AssimpSceneProcessor {
+public:
+    /**
+     * @brief Processes the meshes in the scene.
+     * @returns The meshes in the scene.
+     */
+    std::vector<Mesh> process_meshes();
+
+    explicit AssimpSceneProcessor(ResourcesController *resources_controller, const aiScene *scene,
+                                  std::filesystem::path model_path) :
+            m_scene(scene), m_model_path(std::move(model_path)), m_resources_controller(resources_controller) {
+    }
+
+private:
+    void process_node(const aiNode *node);
+
+    void process_mesh(aiMesh *mesh);
+
+    MeshTextures process_materials(const aiMaterial *material);
+
+    void process_material_type(MeshTextures &textures, const aiMaterial *material, aiTextureType type);
+
+    static TextureType assimp_texture_type_to_engine(aiTextureType type);
+
+    std::vector<Mesh> m_meshes;
+    const aiScene *m_scene;
+    std::filesystem::path m_model_path;
+    ResourcesController *m_resources_controller;
+};
+} // namespace engine::resources
+
+#endif//MATF_RG_PROJECT_ASSIMP_SCENE_PROCESSOR_HPP
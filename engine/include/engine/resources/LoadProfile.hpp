@@ -0,0 +1,154 @@
+/**
+ * @file LoadProfile.hpp
+ * @brief Defines the per-asset load timings and the LoadProfile that collects them into the load-time report.
+ */
+
+#ifndef MATF_RG_PROJECT_LOAD_PROFILE_HPP
+#define MATF_RG_PROJECT_LOAD_PROFILE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine::resources {
+enum class AssetKind {
+    Model,
+    Texture,
+    Skybox,
+    Shader,
+};
+
+std::string_view to_string(AssetKind kind);
+
+/**
+* @struct AssetLoadTimings
+* @brief Where the time of one asset load went. Times are in nanoseconds.
+*/
+struct AssetLoadTimings {
+    /**
+    * @brief Reading the file from disk.
+    */
+    uint64_t io_ns;
+    /**
+    * @brief Image decoding, Assimp import or shader source parsing.
+    */
+    uint64_t decode_ns;
+    /**
+    * @brief Assimp post-processing and the conversion of the imported meshes.
+    */
+    uint64_t post_process_ns;
+    /**
+    * @brief GPU buffer and texture uploads, shader compilation and linking.
+    */
+    uint64_t upload_ns;
+    uint64_t bytes_read;
+    uint64_t gpu_bytes;
+    /**
+    * @brief Time spent loading other assets from inside this load, e.g. the textures of a model.
+    * Already accounted for in their own records.
+    */
+    uint64_t nested_ns;
+};
+
+/**
+* @brief Timings of the asset that is being loaded. The load paths add to it directly:
+* @code
+* const uint64_t begin = util::Profiler::now_ns();
+* std::string source = util::read_text_file(path);
+* g_asset_load_timings.io_ns += util::Profiler::now_ns() - begin;
+* g_asset_load_timings.bytes_read += source.size();
+* @endcode
+* @ref LoadProfile::Scope resets it for every asset and restores the outer asset's timings when a load nests.
+*/
+inline AssetLoadTimings g_asset_load_timings{};
+
+/**
+* @struct AssetLoadRecord
+* @brief One loaded asset in the load-time report.
+*/
+struct AssetLoadRecord {
+    std::string name;
+    AssetKind kind;
+    std::filesystem::path path;
+    AssetLoadTimings timings;
+    /**
+    * @brief Wall time of the whole load, without the nested loads.
+    */
+    uint64_t total_ns;
+};
+
+/**
+* @class LoadProfile
+* @brief Records how long every model, texture, skybox and shader took to load, split by load stage.
+*
+* Owned by the @ref ResourcesController, get it with @ref ResourcesController::load_profile.
+* At the end of @ref ResourcesController::initialize the report is logged as a table, slowest asset first,
+* and written as JSON to `resources.load_report` from the config.json (default: load_report.json, "" disables it).
+*/
+class LoadProfile {
+public:
+    /**
+    * @class Scope
+    * @brief Records the load of one asset, from construction to destruction.
+    */
+    class Scope {
+    public:
+        Scope(LoadProfile *profile, AssetKind kind, std::string name, std::filesystem::path path);
+
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        LoadProfile *m_profile;
+        AssetLoadRecord m_record;
+        AssetLoadTimings m_outer;
+        uint64_t m_begin_ns;
+        int m_uncaught_exceptions;
+    };
+
+    /**
+    * @returns The loaded assets, in load order.
+    */
+    const std::vector<AssetLoadRecord> &records() const {
+        return m_records;
+    }
+
+    /**
+    * @returns A copy of the records sorted by @ref AssetLoadRecord::total_ns, slowest first. The order is kept up to
+    * date as the assets load, so this doesn't sort.
+    */
+    std::vector<AssetLoadRecord> sorted_records() const;
+
+    /**
+    * @brief Logs the report as a table on the "resources" logger.
+    */
+    void log_report() const;
+
+    /**
+    * @brief Writes the report as JSON to `path`.
+    */
+    void write_report(const std::filesystem::path &path) const;
+
+    /**
+    * @brief Draws the load-time panel. Call between @ref graphics::GraphicsController::begin_gui and
+    * @ref graphics::GraphicsController::end_gui.
+    */
+    void draw_gui();
+
+private:
+    void add_record(AssetLoadRecord record);
+
+    std::vector<AssetLoadRecord> m_records;
+    /**
+    * @brief Indices into m_records, slowest first. The panel walks it every frame, so it isn't sorted there.
+    */
+    std::vector<std::size_t> m_slowest_first;
+};
+} // namespace engine::resources
+
+#endif//MATF_RG_PROJECT_LOAD_PROFILE_HPP
@@ -7,10 +7,17 @@
 #define MATF_RG_PROJECT_MESH_HPP
 
 #include <glm/glm.hpp>
+#include <span>
 #include <vector>
 #include <engine/resources/Texture.hpp>
+#include <engine/util/SmallVector.hpp>
 
 namespace engine::resources {
+/**
+* @brief Textures used by a single mesh. Meshes rarely have more than a handful, so they are stored inline.
+*/
+using MeshTextures = util::ds::SmallVector<Texture *, 4>;
+
 /**
 * @struct Vertex
 * @brief Represents a vertex in the mesh.
@@ -40,7 +47,7 @@ public:
     void draw(const Shader *shader);
 
     /**
-    * @brief Destroys the mesh in the OpenGL context.
+    * @brief Destroys the mesh's vertex array and buffers in the OpenGL context.
     */
     void destroy();
 
@@ -51,12 +58,14 @@ private:
     * @param indices The indices in the mesh.
     * @param textures The textures in the mesh.
      */
-    Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
-         std::vector<Texture *> textures);
+    Mesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+         MeshTextures textures);
 
     uint32_t m_vao{0};
+    uint32_t m_vbo{0};
+    uint32_t m_ebo{0};
     uint32_t m_num_indices{0};
-    std::vector<Texture *> m_textures;
+    MeshTextures m_textures;
 };
 } // namespace engine
 
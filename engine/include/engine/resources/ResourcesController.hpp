@@ -7,6 +7,7 @@
 #define MATF_RG_PROJECT_RESOURCES_CONTROLLER_HPP
 
 #include <engine/core/Controller.hpp>
+#include <engine/resources/LoadProfile.hpp>
 #include <engine/resources/Model.hpp>
 #include <engine/resources/Texture.hpp>
 #include <engine/resources/Shader.hpp>
@@ -24,6 +25,10 @@ public:
         return "ResourcesController";
     }
 
+    std::string_view subsystem() const override {
+        return "resources";
+    }
+
     /**
     * @brief Retrieves the model with a given name. You are not supposed to call `delete` on this pointer.
     * @param name of the model in the configuration file.
@@ -69,12 +74,24 @@ public:
     */
     Shader *shader(const std::string &name, const std::filesystem::path &path = "");
 
+    /**
+    * @returns The load timings of every asset loaded so far.
+    */
+    LoadProfile *load_profile() {
+        return &m_load_profile;
+    }
+
 private:
     /**
-    * @brief Loads all the resources from the "resources/" directory.
+    * @brief Loads all the resources from the "resources/" directory, then reports how long each of them took to load.
     */
     void initialize() override;
 
+    /**
+    * @brief Destroys all the resources in the OpenGL context.
+    */
+    void terminate() override;
+
     /**
     * @brief Loads all the models from the "resources/models" directory based on the provided configuration. Called during @ref ResourcesController::initialize.
     */
@@ -112,6 +129,8 @@ private:
     */
     std::unordered_map<std::string, std::unique_ptr<Shader> > m_shaders;
 
+    LoadProfile m_load_profile;
+
     const std::filesystem::path m_models_path = "resources/models";
     const std::filesystem::path m_textures_path = "resources/textures";
     const std::filesystem::path m_shaders_path = "resources/shaders";
@@ -6,7 +6,9 @@
 #ifndef MATF_RG_PROJECT_SHADER_HPP
 #define MATF_RG_PROJECT_SHADER_HPP
 
+#include <engine/graphics/UniformBlock.hpp>
 #include <engine/util/Utils.hpp>
+#include <span>
 #include <string>
 #include <glm/glm.hpp>
 
@@ -34,6 +36,7 @@ std::string_view to_string(ShaderType type);
 */
 class Shader {
     friend class ShaderCompiler;
+    friend class ResourcesController;
 
 public:
     /**
@@ -110,6 +113,19 @@ public:
     */
     void set_mat4(const std::string &name, const glm::mat4 &mat) const;
 
+    /**
+    * @brief Binds the shader's uniform block `TBlock::BLOCK_NAME` to `TBlock::BINDING`, after checking that the layout the
+    * driver reflects for it matches the C++ struct member by member. Call it once after the shader is loaded.
+    * @returns false if the shader doesn't have the block.
+    * @throws EngineError if the block's size or a member's offset differs from the struct.
+    */
+    template<typename TBlock>
+    bool bind_uniform_block() const {
+        static_assert(graphics::has_std140_layout<TBlock>(), "The uniform block struct doesn't follow the std140 layout.");
+        const auto members = TBlock::members();
+        return bind_uniform_block(TBlock::BLOCK_NAME, TBlock::BINDING, members, sizeof(TBlock));
+    }
+
     /**
     * @brief Returns the name of the shader program by which it can be referenced using the @ref engine::resources::ResourcesController::shader function.
     * @returns The name of the shader.
@@ -139,6 +155,9 @@ private:
     Shader(unsigned shader_id, std::string name, std::string source,
            std::filesystem::path source_path = "");
 
+    bool bind_uniform_block(std::string_view block, uint32_t binding, std::span<const graphics::UniformMember> members,
+                            std::size_t size) const;
+
     /**
     * @brief Destroys the shader program in the OpenGL context.
     */
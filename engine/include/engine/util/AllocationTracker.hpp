@@ -0,0 +1,252 @@
+/**
+ * @file AllocationTracker.hpp
+ * @brief Defines the AllocationTracker that counts heap allocations per frame, subsystem, profiler zone and call site.
+ */
+
+#ifndef MATF_RG_PROJECT_ALLOCATION_TRACKER_HPP
+#define MATF_RG_PROJECT_ALLOCATION_TRACKER_HPP
+
+#include <engine/util/Logging.hpp>
+#include <json.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace engine::util {
+/**
+* @struct AllocationCounters
+* @brief Number of allocations and the bytes requested by them.
+*/
+struct AllocationCounters {
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+/**
+* @struct AllocationFrame
+* @brief The allocations made during one frame.
+*/
+struct AllocationFrame {
+    uint64_t frame;
+    /**
+    * @brief Allocations made by all the threads.
+    */
+    AllocationCounters total;
+    /**
+    * @brief Allocations made by the thread that runs the frame loop.
+    */
+    AllocationCounters main_thread;
+    uint64_t frees;
+    /**
+    * @brief Allocations per @ref Logging::SUBSYSTEMS entry, see @ref AllocationTracker::Scope.
+    */
+    std::array<AllocationCounters, std::size(Logging::SUBSYSTEMS)> subsystems;
+};
+
+/**
+* @struct AllocationSite
+* @brief Allocations made from one call site or inside one profiler zone.
+*/
+struct AllocationSite {
+    /**
+    * @brief Return address of the `operator new` or `malloc` call, or the data of the zone name.
+    */
+    const void *key;
+    std::string_view zone;
+    AllocationCounters total;
+    /**
+    * @brief Allocations of the frame with the @ref AllocationSite::frame index.
+    */
+    AllocationCounters last;
+    uint64_t frame;
+};
+
+/**
+* @class AllocationTracker
+* @brief Counts the heap allocations when the engine is built with `-DRG_ALLOCATION_TRACKING=ON`.
+* Without it the tracker exists but sees no allocations and costs nothing.
+*
+* Every allocation is attributed to:
+*  - the subsystem of the innermost @ref AllocationTracker::Scope on the thread. @ref core::App opens one with
+*    @ref core::Controller::subsystem around every controller phase; allocations outside of any scope are `engine`'s.
+*  - the innermost @ref ProfileScope on the thread, while the @ref Profiler is enabled.
+*  - the call site, the return address of `operator new` or `malloc`. Sites are symbolized only when they are reported.
+*
+* @ref core::App::loop closes the frame with @ref AllocationTracker::new_frame, and @ref core::App::terminate logs the
+* report: the peak frame, the peak heap growth and the top call sites. Configured by the `allocations` section of the config.json:
+* @code
+* "allocations": { "enabled": true, "report_sites": 16, "zero_after_frame": 300 }
+* @endcode
+* With a non-zero `zero_after_frame`, any allocation made by the main thread in a later frame fails the run with the
+* call sites of that frame. Use it to keep the steady state of a scene allocation free.
+*
+* All the global `operator new`/`operator delete` overloads are replaced, the aligned ones included. With glibc,
+* `malloc`, `calloc`, `realloc`, `free`, `posix_memalign`, `aligned_alloc` and `memalign` are replaced too and forward
+* to glibc's allocator, so the allocations of C libraries (GLFW, assimp, stb, the driver) are counted as well.
+* Elsewhere, only the C++ allocations are counted.
+*/
+class AllocationTracker {
+public:
+    static constexpr std::size_t MAX_SITES = 4096;
+    static constexpr std::size_t DEFAULT_REPORT_SITES = 16;
+
+    static AllocationTracker *instance();
+
+    /**
+    * @returns Whether the engine was built with `RG_ALLOCATION_TRACKING`.
+    */
+    static constexpr bool is_compiled_in() {
+#ifdef RG_ALLOCATION_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+    * @class Scope
+    * @brief Attributes the allocations the thread makes while it's alive to a subsystem from @ref Logging::SUBSYSTEMS.
+    * Use @ref RG_ALLOCATION_SCOPE, it compiles to nothing without `RG_ALLOCATION_TRACKING`.
+    */
+    class Scope {
+    public:
+        explicit Scope(std::string_view subsystem);
+
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        uint8_t m_previous;
+    };
+
+    /**
+    * @brief Applies the `allocations` section of the configuration. Must be called from the main thread.
+    */
+    void configure(const nlohmann::json &config);
+
+    bool is_enabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    void set_enabled(bool enabled);
+
+    /**
+    * @brief Closes the current frame and opens the next one. Called by @ref core::App::loop.
+    * @throws EngineError if the closed frame allocated on the main thread after `zero_after_frame`.
+    */
+    void new_frame();
+
+    /**
+    * @brief Counts an allocation. Called by the replaced allocation functions, must not allocate.
+    */
+    void on_allocate(std::size_t bytes, std::size_t usable_bytes, const void *site);
+
+    /**
+    * @brief Counts a deallocation. Called by the replaced deallocation functions, must not allocate.
+    */
+    void on_free(std::size_t usable_bytes);
+
+    /**
+    * @returns The most recent completed frame.
+    */
+    const AllocationFrame &last_frame() const {
+        return m_last_frame;
+    }
+
+    /**
+    * @returns The completed frame with the most main thread allocations.
+    */
+    const AllocationFrame &peak_frame() const {
+        return m_peak_frame;
+    }
+
+    /**
+    * @returns The highest heap growth since tracking was enabled. Only measured with glibc, 0 elsewhere.
+    */
+    int64_t peak_live_bytes() const {
+        return m_peak_live_bytes.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * @returns Up to `count` call sites with the most allocations, over the whole run or in the `frame` only.
+    */
+    std::vector<AllocationSite> top_sites(std::size_t count, std::optional<uint64_t> frame = std::nullopt);
+
+    /**
+    * @returns Up to `count` profiler zones with the most allocations, over the whole run or in the `frame` only.
+    */
+    std::vector<AllocationSite> top_zones(std::size_t count, std::optional<uint64_t> frame = std::nullopt);
+
+    /**
+    * @returns The function and offset of a call site, or its module and offset if the function has no dynamic symbol.
+    */
+    static std::string describe_site(const void *site);
+
+    /**
+    * @brief Logs the peak frame, the peak heap growth and the top call sites. Called by @ref core::App::terminate.
+    */
+    void log_report();
+
+    /**
+    * @brief Draws the allocations panel. Call between @ref graphics::GraphicsController::begin_gui and
+    * @ref graphics::GraphicsController::end_gui.
+    */
+    void draw_gui();
+
+private:
+    AllocationTracker() = default;
+
+    using SiteTable = std::array<AllocationSite, MAX_SITES>;
+
+    std::vector<AllocationSite> top_entries(const SiteTable &entries, std::size_t count, std::optional<uint64_t> frame);
+
+    static AllocationSite *find_or_insert(SiteTable &entries, const void *key);
+
+    void lock();
+
+    void unlock();
+
+    const std::string &site_name(const void *site);
+
+    std::atomic<bool> m_enabled{false};
+    // Guards everything below that the hooks write. A spin lock, because a mutex may allocate on some platforms.
+    std::atomic_flag m_lock;
+    AllocationFrame m_current{};
+    AllocationFrame m_last_frame{};
+    AllocationFrame m_peak_frame{};
+    int64_t m_live_bytes{0};
+    std::atomic<int64_t> m_peak_live_bytes{0};
+
+    // Open addressing tables keyed by the call site and the zone name. They never allocate, allocations that don't
+    // fit anymore are only counted in the frame totals.
+    SiteTable m_sites{};
+    SiteTable m_zones{};
+    uint64_t m_dropped_sites{0};
+
+    uint64_t m_zero_after_frame{0};
+    std::size_t m_report_sites{DEFAULT_REPORT_SITES};
+    std::unordered_map<const void *, std::string> m_site_names;
+};
+} // namespace engine::util
+
+#ifdef RG_ALLOCATION_TRACKING
+/**
+* @brief Attributes the allocations in the enclosing scope to the `subsystem`.
+*/
+#define RG_ALLOCATION_SCOPE(subsystem)                                                                                 \
+    ::engine::util::AllocationTracker::Scope RG_ALLOCATION_CONCAT(rg_allocation_scope_, __LINE__)(subsystem)
+#define RG_ALLOCATION_CONCAT_IMPL(a, b) a##b
+#define RG_ALLOCATION_CONCAT(a, b) RG_ALLOCATION_CONCAT_IMPL(a, b)
+#else
+#define RG_ALLOCATION_SCOPE(subsystem) ((void) 0)
+#endif
+
+#endif//MATF_RG_PROJECT_ALLOCATION_TRACKER_HPP
@@ -0,0 +1,257 @@
+/**
+ * @file Arena.hpp
+ * @brief Defines linear (bump) arenas for transient allocations: the per-frame arena, thread-local scratch arenas and their pmr adapters.
+ */
+
+#ifndef MATF_RG_PROJECT_ARENA_HPP
+#define MATF_RG_PROJECT_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace engine::util::ds {
+class LinearArena;
+
+/**
+* @struct ArenaStats
+* @brief Usage statistics of a @ref LinearArena.
+*/
+struct ArenaStats {
+    /**
+    * @brief Bytes currently handed out, including alignment padding.
+    */
+    std::size_t used;
+
+    /**
+    * @brief Bytes reserved from the global heap across all blocks.
+    */
+    std::size_t capacity;
+
+    /**
+    * @brief The largest value @ref ArenaStats::used reached since the arena was created.
+    */
+    std::size_t high_water_mark;
+
+    /**
+    * @brief Number of allocations since the last @ref LinearArena::reset.
+    */
+    std::size_t allocations;
+
+    /**
+    * @brief Number of times the arena had to go to the global heap for a new block.
+    * In a steady state this number stops growing.
+    */
+    std::size_t block_allocations;
+};
+
+/**
+* @class ArenaResource
+* @brief Adapts a @ref LinearArena to `std::pmr::memory_resource` so that `std::pmr` containers can allocate from it.
+*
+* Deallocation is a no-op, memory is reclaimed only when the arena is rewound or reset.
+* @code
+* util::ds::ScratchScope scratch;
+* std::pmr::vector<uint32_t> indices(scratch.resource());
+* @endcode
+*/
+class ArenaResource final : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(LinearArena *arena) : m_arena(arena) {
+    }
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    LinearArena *m_arena;
+};
+
+/**
+* @class LinearArena
+* @brief A bump allocator that hands out memory from a chain of blocks and frees everything at once.
+*
+* Allocation is a pointer increment. Individual allocations are never freed; instead, the arena is either
+* rewound to a @ref LinearArena::Marker or @ref LinearArena::reset completely. When the arena had to grow during
+* a frame, `reset` merges all the blocks into a single block big enough for the observed high-water mark,
+* so after a few frames the arena stops touching the global heap.
+*
+* In debug builds the released memory is poisoned with @ref LinearArena::POISON_BYTE to catch
+* use-after-reset bugs early.
+*
+* Objects allocated from the arena don't have their destructors called, so prefer trivially destructible types
+* or `std::pmr` containers through @ref LinearArena::resource.
+*/
+class LinearArena {
+public:
+    /**
+    * @brief A position in the arena that can be returned to with @ref LinearArena::rewind.
+    */
+    struct Marker {
+        std::size_t block;
+        std::size_t offset;
+        std::size_t used;
+        std::size_t allocations;
+    };
+
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+    static constexpr std::byte POISON_BYTE{0xDD};
+
+    explicit LinearArena(std::size_t block_size = DEFAULT_BLOCK_SIZE);
+
+    ~LinearArena();
+
+    LinearArena(const LinearArena &) = delete;
+
+    LinearArena &operator=(const LinearArena &) = delete;
+
+    /**
+    * @brief Allocates `bytes` aligned to `alignment`. Never returns nullptr.
+    * @param bytes Number of bytes to allocate.
+    * @param alignment Must be a power of two.
+    * @returns Pointer to the uninitialized memory that stays valid until the arena is rewound past it or reset.
+    */
+    void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+    * @brief Allocates uninitialized storage for `count` objects of type `T`.
+    */
+    template<typename T>
+    std::span<T> allocate_array(std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "The arena never calls destructors.");
+        return {static_cast<T *>(allocate(count * sizeof(T), alignof(T))), count};
+    }
+
+    /**
+    * @brief Constructs a `T` inside the arena.
+    */
+    template<typename T, typename... Args>
+    T *create(Args &&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "The arena never calls destructors.");
+        return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+    * @returns The current position of the arena.
+    */
+    Marker marker() const {
+        return {m_current, m_offset, m_stats.used, m_stats.allocations};
+    }
+
+    /**
+    * @brief Releases every allocation made after the `marker` was taken.
+    */
+    void rewind(Marker marker);
+
+    /**
+    * @brief Releases every allocation, and if the arena grew since the last reset, merges the blocks into one.
+    */
+    void reset();
+
+    /**
+    * @brief Returns all the blocks to the global heap.
+    */
+    void release();
+
+    /**
+    * @brief Enables/disables poisoning of the released memory. Enabled by default in debug builds.
+    */
+    void set_poison_on_free(bool enabled) {
+        m_poison_on_free = enabled;
+    }
+
+    /**
+    * @returns The `std::pmr::memory_resource` view of this arena.
+    */
+    ArenaResource *resource() {
+        return &m_resource;
+    }
+
+    const ArenaStats &stats() const {
+        return m_stats;
+    }
+
+private:
+    struct Block {
+        std::byte *data;
+        std::size_t size;
+        std::size_t offset;
+    };
+
+    void *allocate_slow(std::size_t bytes, std::size_t alignment);
+
+    Block allocate_block(std::size_t size);
+
+    void poison(std::byte *begin, std::size_t size) const;
+
+    std::vector<Block> m_blocks;
+    std::size_t m_current{0};
+    std::size_t m_offset{0};
+    std::size_t m_block_size;
+    ArenaStats m_stats{};
+    ArenaResource m_resource{this};
+    bool m_poison_on_free;
+};
+
+/**
+* @brief Returns the arena for allocations that live until the end of the current frame.
+* The @ref engine::core::App resets it at the beginning of every frame. Use only from the main thread.
+*/
+LinearArena &frame_arena();
+
+/**
+* @brief Returns the calling thread's scratch arena. Use it through @ref ScratchScope.
+*/
+LinearArena &scratch_arena();
+
+/**
+* @class ScratchScope
+* @brief Takes a marker in the thread-local scratch arena and rewinds to it when the scope ends.
+* @code
+* void Mesh::draw(const Shader *shader) {
+*     util::ds::ScratchScope scratch;
+*     std::pmr::string uniform_name(scratch.resource());
+*     ...
+* } // <-- everything allocated from `scratch` is released here
+* @endcode
+*/
+class ScratchScope {
+public:
+    ScratchScope() : m_arena(&scratch_arena())
+                     , m_marker(m_arena->marker()) {
+    }
+
+    ~ScratchScope() {
+        m_arena->rewind(m_marker);
+    }
+
+    ScratchScope(const ScratchScope &) = delete;
+
+    ScratchScope &operator=(const ScratchScope &) = delete;
+
+    LinearArena *arena() const {
+        return m_arena;
+    }
+
+    ArenaResource *resource() const {
+        return m_arena->resource();
+    }
+
+private:
+    LinearArena *m_arena;
+    LinearArena::Marker m_marker;
+};
+} // namespace engine::util::ds
+
+#endif//MATF_RG_PROJECT_ARENA_HPP
@@ -0,0 +1,123 @@
+/**
+ * @file HitchDetector.hpp
+ * @brief Defines the per-frame event counters and the HitchDetector that logs what happened in unusually slow frames.
+ */
+
+#ifndef MATF_RG_PROJECT_HITCH_DETECTOR_HPP
+#define MATF_RG_PROJECT_HITCH_DETECTOR_HPP
+
+#include <json.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace engine::util {
+/**
+* @struct FrameEvents
+* @brief Work in a frame that is known to cause hitches.
+*/
+struct FrameEvents {
+    /**
+    * @brief Assets loaded by the @ref resources::ResourcesController, and the time it took.
+    */
+    uint32_t asset_loads;
+    uint64_t asset_load_ns;
+    /**
+    * @brief Shader programs compiled and linked.
+    */
+    uint32_t shader_compiles;
+    /**
+    * @brief GL buffer (re)allocations, i.e. glBufferData calls, and the bytes allocated.
+    */
+    uint32_t buffer_allocations;
+    uint64_t buffer_allocation_bytes;
+};
+
+/**
+* @brief Events of the frame that is being recorded. The engine adds to it directly:
+* @code
+* ++g_frame_events.buffer_allocations;
+* g_frame_events.buffer_allocation_bytes += size;
+* @endcode
+*/
+inline FrameEvents g_frame_events{};
+
+/**
+* @struct HitchFrame
+* @brief One frame as the @ref HitchDetector saw it.
+*/
+struct HitchFrame {
+    uint64_t frame;
+    /**
+    * @brief Index of the frame in the @ref Profiler, to look its zones up.
+    */
+    uint64_t profiler_frame;
+    float frame_ms;
+    FrameEvents events;
+    uint64_t log_messages;
+    uint64_t log_bytes;
+};
+
+/**
+* @class HitchDetector
+* @brief Detects frames that take `threshold` times longer than the median of the recent frames.
+*
+* For every hitch it logs a warning and appends a JSON line to `path` with the hitch frame and the frames before it:
+* the @ref FrameEvents, the log volume and the slowest profiler zones. Enabling hitch detection enables the
+* @ref Profiler as well, the zones are missing from the frames recorded while it's switched off from its panel.
+* Owned by the @ref platform::PlatformController, which feeds it @ref platform::FrameTime::dt every frame.
+* Configured by the `hitches` section of the config.json:
+* @code
+* "hitches": { "enabled": true, "threshold": 3.0, "min_ms": 10.0, "window": 120, "context_frames": 4, "path": "hitches.jsonl" }
+* @endcode
+* Frames shorter than `min_ms` are never hitches. Detection starts once `window` frames have been seen.
+*/
+class HitchDetector {
+public:
+    static constexpr std::size_t MAX_ZONES = 8;
+
+    void configure(const nlohmann::json &config);
+
+    bool is_enabled() const {
+        return m_enabled;
+    }
+
+    /**
+    * @brief Closes the frame that took `frame_ms`, checks it for a hitch and resets @ref g_frame_events.
+    */
+    void end_frame(float frame_ms);
+
+    uint64_t hitch_count() const {
+        return m_hitch_count;
+    }
+
+    /**
+    * @returns The median frame time of the current window.
+    */
+    float median_ms();
+
+private:
+    void report_hitch(const HitchFrame &hitch, float median_ms);
+
+    static nlohmann::json frame_json(const HitchFrame &frame);
+
+    bool m_enabled{false};
+    float m_threshold{3.0f};
+    float m_min_ms{10.0f};
+    std::size_t m_window{120};
+    std::size_t m_context_frames{4};
+    std::filesystem::path m_path{"hitches.jsonl"};
+    std::ofstream m_file;
+
+    std::vector<float> m_frame_ms;
+    std::vector<float> m_sorted_ms;
+    std::vector<HitchFrame> m_frames;
+    uint64_t m_frame{0};
+    uint64_t m_hitch_count{0};
+    uint64_t m_log_messages{0};
+    uint64_t m_log_bytes{0};
+};
+} // namespace engine::util
+
+#endif//MATF_RG_PROJECT_HITCH_DETECTOR_HPP
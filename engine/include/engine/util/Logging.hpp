@@ -0,0 +1,355 @@
+/**
+ * @file Logging.hpp
+ * @brief Defines the Logging class that runs the asynchronous logging backend and the per-subsystem loggers.
+ */
+
+#ifndef MATF_RG_PROJECT_LOGGING_HPP
+#define MATF_RG_PROJECT_LOGGING_HPP
+
+#include <engine/util/MpscRing.hpp>
+#include <json.hpp>
+#include <spdlog/spdlog.h>
+#include <spdlog/details/os.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace engine::util {
+/**
+* @struct LogRecord
+* @brief A log call as the calling thread left it in the queue: the format string and a copy of the arguments.
+* The background thread turns it into the message.
+*/
+struct LogRecord {
+    static constexpr std::size_t ARGUMENTS_SIZE = 192;
+
+    /**
+    * @brief Formats the arguments stored in `arguments` into `out` and destroys them.
+    */
+    using FormatFn = void (*)(std::string_view format, std::byte *arguments, std::string &out);
+
+    spdlog::log_clock::time_point time;
+    spdlog::source_loc location;
+    std::size_t thread_id{0};
+    spdlog::level::level_enum level{spdlog::level::info};
+    uint32_t logger{0};
+    /**
+    * @brief Points to the format string literal of the call, which outlives the record.
+    */
+    std::string_view format;
+    /**
+    * @brief Null if the arguments couldn't be captured. The background thread skips such records.
+    */
+    FormatFn format_arguments{nullptr};
+    alignas(std::max_align_t) std::byte arguments[ARGUMENTS_SIZE];
+};
+
+namespace detail {
+/**
+* @brief Arguments are captured by value. Strings are copied, because a `const char *` or a `std::string_view`
+* may not live until the background thread formats the message.
+*/
+template<typename T>
+using CapturedArgument = std::conditional_t<std::is_convertible_v<const std::decay_t<T> &, std::string_view>,
+                                            std::string, std::decay_t<T> >;
+
+template<typename Tuple>
+void format_captured(std::string_view format, std::byte *arguments, std::string &out) {
+    auto *values = std::launder(reinterpret_cast<Tuple *>(arguments));
+    std::apply([&](auto &... value) {
+        out = std::vformat(format, std::make_format_args(value...));
+    }, *values);
+    values->~Tuple();
+}
+} // namespace detail
+
+/**
+* @class Logger
+* @brief The named logger of a subsystem, returned by @ref util::logger. Mirrors the `spdlog::logger` logging API.
+*/
+class Logger {
+public:
+    Logger(std::string name, uint32_t index) : m_name(std::move(name)), m_index(index) {
+    }
+
+    const std::string &name() const {
+        return m_name;
+    }
+
+    uint32_t index() const {
+        return m_index;
+    }
+
+    spdlog::level::level_enum level() const {
+        return m_level.load(std::memory_order_relaxed);
+    }
+
+    void set_level(spdlog::level::level_enum level) {
+        m_level.store(level, std::memory_order_relaxed);
+    }
+
+    bool should_log(spdlog::level::level_enum level) const {
+        return level >= this->level() && level != spdlog::level::off;
+    }
+
+    /**
+    * @brief Queues the message for the background thread. Only the arguments are copied here; formatting them
+    * and writing the message happen on the background thread.
+    */
+    template<typename... Args>
+    void log(spdlog::source_loc location, spdlog::level::level_enum level, std::format_string<Args...> format,
+             Args &&... args);
+
+    template<typename... Args>
+    void log(spdlog::level::level_enum level, std::format_string<Args...> format, Args &&... args) {
+        log(spdlog::source_loc{}, level, format, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void trace(std::format_string<Args...> format, Args &&... args) {
+        log(spdlog::level::trace, format, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void debug(std::format_string<Args...> format, Args &&... args) {
+        log(spdlog::level::debug, format, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void info(std::format_string<Args...> format, Args &&... args) {
+        log(spdlog::level::info, format, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void warn(std::format_string<Args...> format, Args &&... args) {
+        log(spdlog::level::warn, format, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void error(std::format_string<Args...> format, Args &&... args) {
+        log(spdlog::level::err, format, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void critical(std::format_string<Args...> format, Args &&... args) {
+        log(spdlog::level::critical, format, std::forward<Args>(args)...);
+    }
+
+private:
+    std::string m_name;
+    uint32_t m_index;
+    std::atomic<spdlog::level::level_enum> m_level{spdlog::level::info};
+};
+
+/**
+* @class Logging
+* @brief Owns the engine logging backend.
+*
+* A log call copies its arguments, together with the format string, into a slot of a lock-free ring
+* (@ref ds::MpscRing) and returns; a background thread formats the message, applies the pattern and writes it
+* to the sinks. The caller never formats, never waits for console or file I/O and never takes a lock.
+* Arguments that don't fit in the @ref LogRecord::ARGUMENTS_SIZE bytes of a slot are formatted on the calling thread.
+* When the ring is full, the new message is dropped instead of blocking the caller, and the number of dropped
+* messages is reported by @ref Logging::dropped_messages and at shutdown.
+*
+* Every subsystem logs through its own named logger, so verbosity can be tuned per subsystem at runtime
+* or in the config.json:
+* @code
+* "logging": {
+*   "level": "info",
+*   "queue_size": 8192,
+*   "file": "engine.log",
+*   "subsystems": { "platform": "warn", "resources": "debug" }
+* }
+* @endcode
+*
+* `trace` and `debug` calls made through the `SPDLOG_LOGGER_TRACE`/`SPDLOG_LOGGER_DEBUG` macros are removed
+* at compile time in Release builds, see `SPDLOG_ACTIVE_LEVEL` in engine/CMakeLists.txt.
+* @code
+* SPDLOG_LOGGER_TRACE(engine::util::logger("resources"), "load_texture(path={})", path.string());
+* engine::util::logger("resources")->info("Loaded {} models", count);
+* @endcode
+* The spdlog default logger (`spdlog::info` etc.) writes to the same sinks, but synchronously.
+*/
+class Logging {
+public:
+    /**
+    * @brief Names of the engine subsystem loggers. `engine` is also the fallback of @ref Logging::logger.
+    */
+    static constexpr std::string_view SUBSYSTEMS[] = {"engine", "platform", "graphics", "resources", "app"};
+
+    static constexpr std::size_t DEFAULT_QUEUE_SIZE = 8192;
+
+    static Logging *instance();
+
+    /**
+    * @brief Starts the background logging thread. Called first in @ref core::App::engine_setup.
+    * Until then, messages are written synchronously.
+    */
+    void initialize();
+
+    /**
+    * @brief Applies the `logging` section of the configuration: levels, queue size and the optional log file.
+    * Calling it again with the same configuration changes nothing; a different `file` replaces the log file.
+    * A different `file` or `queue_size` restarts the background thread, so no other thread may log meanwhile.
+    */
+    void configure(const nlohmann::json &config);
+
+    /**
+    * @brief Writes all the pending messages, reports the dropped message count and stops the background thread.
+    * Logging keeps working afterward, but synchronously.
+    */
+    void shutdown();
+
+    /**
+    * @brief Sets the runtime level of a subsystem logger.
+    */
+    void set_level(std::string_view subsystem, spdlog::level::level_enum level);
+
+    /**
+    * @returns The number of messages that were dropped because the queue was full.
+    */
+    std::size_t dropped_messages() const {
+        return m_dropped_messages.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * @returns The number of messages written to the sinks so far. The background thread counts them when it writes them,
+    * so the count trails the log calls by the queue latency.
+    */
+    uint64_t logged_messages() const {
+        return m_logged_messages.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * @returns The total size of the message payloads written to the sinks so far.
+    */
+    uint64_t logged_bytes() const {
+        return m_logged_bytes.load(std::memory_order_relaxed);
+    }
+
+    /**
+    * @returns The logger of the `subsystem`, or the `engine` logger if there is no such subsystem.
+    */
+    Logger *logger(std::string_view subsystem) const;
+
+    /**
+    * @brief Queues a log call of the `logger`, or writes it right away when the background thread isn't running.
+    */
+    template<typename... Args>
+    void submit(const Logger &logger, spdlog::source_loc location, spdlog::level::level_enum level,
+                std::string_view format, Args &&... args);
+
+private:
+    Logging();
+
+    template<typename F>
+    void push(const Logger &logger, spdlog::source_loc location, spdlog::level::level_enum level,
+              std::string_view format, LogRecord::FormatFn format_arguments, F &&capture);
+
+    void write(uint32_t logger, spdlog::log_clock::time_point time, spdlog::source_loc location,
+               std::size_t thread_id, spdlog::level::level_enum level, std::string_view payload);
+
+    void start_backend(std::size_t queue_size);
+
+    void stop_backend();
+
+    void run_backend(std::stop_token stop);
+
+    void set_default_logger();
+
+    std::vector<spdlog::sink_ptr> m_sinks;
+    /**
+    * @brief The sink of `logging.file`, also in @ref Logging::m_sinks. Null without a log file.
+    */
+    spdlog::sink_ptr m_file_sink;
+    std::string m_file_path;
+    std::vector<std::unique_ptr<Logger> > m_loggers;
+    std::unique_ptr<ds::MpscRing<LogRecord> > m_queue;
+    std::size_t m_queue_size{DEFAULT_QUEUE_SIZE};
+    std::atomic<bool> m_async{false};
+    std::atomic<uint64_t> m_dropped_messages{0};
+    std::atomic<uint64_t> m_logged_messages{0};
+    std::atomic<uint64_t> m_logged_bytes{0};
+    /**
+    * @brief Declared last, so it is joined before the queue and the sinks it uses are destroyed.
+    */
+    std::jthread m_backend;
+};
+
+template<typename... Args>
+void Logger::log(spdlog::source_loc location, spdlog::level::level_enum level, std::format_string<Args...> format,
+                 Args &&... args) {
+    if (!should_log(level)) {
+        return;
+    }
+    const auto format_view = format.get();
+    Logging::instance()->submit(*this, location, level, std::string_view(format_view.data(), format_view.size()),
+                                std::forward<Args>(args)...);
+}
+
+template<typename... Args>
+void Logging::submit(const Logger &logger, spdlog::source_loc location, spdlog::level::level_enum level,
+                     std::string_view format, Args &&... args) {
+    if (!m_async.load(std::memory_order_acquire)) {
+        write(logger.index(), spdlog::log_clock::now(), location, spdlog::details::os::thread_id(), level,
+              std::vformat(format, std::make_format_args(args...)));
+        return;
+    }
+    using Captured = std::tuple<detail::CapturedArgument<Args>...>;
+    if constexpr (sizeof(Captured) <= LogRecord::ARGUMENTS_SIZE && alignof(Captured) <= alignof(std::max_align_t)) {
+        push(logger, location, level, format, &detail::format_captured<Captured>, [&](std::byte *storage) {
+            new(storage) Captured(std::forward<Args>(args)...);
+        });
+    } else {
+        // Too large for a slot, so only this call pays for formatting on the calling thread.
+        using Formatted = std::tuple<std::string>;
+        push(logger, location, level, "{}", &detail::format_captured<Formatted>, [&](std::byte *storage) {
+            new(storage) Formatted(std::vformat(format, std::make_format_args(args...)));
+        });
+    }
+}
+
+template<typename F>
+void Logging::push(const Logger &logger, spdlog::source_loc location, spdlog::level::level_enum level,
+                   std::string_view format, LogRecord::FormatFn format_arguments, F &&capture) {
+    const bool pushed = m_queue->try_push([&](LogRecord &record) {
+        record.time = spdlog::log_clock::now();
+        record.location = location;
+        record.thread_id = spdlog::details::os::thread_id();
+        record.level = level;
+        record.logger = logger.index();
+        record.format = format;
+        record.format_arguments = format_arguments;
+        // The slot has to be published even if copying the arguments throws, or the background thread would wait
+        // for it forever.
+        try {
+            capture(record.arguments);
+        } catch (...) {
+            record.format_arguments = nullptr;
+        }
+    });
+    if (!pushed) {
+        m_dropped_messages.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+* @brief Shorthand for @ref Logging::logger.
+*/
+inline Logger *logger(std::string_view subsystem) {
+    return Logging::instance()->logger(subsystem);
+}
+} // namespace engine::util
+
+#endif//MATF_RG_PROJECT_LOGGING_HPP
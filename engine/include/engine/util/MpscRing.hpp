@@ -0,0 +1,115 @@
+/**
+ * @file MpscRing.hpp
+ * @brief Defines the MpscRing bounded lock-free multi-producer, single-consumer queue.
+ */
+
+#ifndef MATF_RG_PROJECT_MPSC_RING_HPP
+#define MATF_RG_PROJECT_MPSC_RING_HPP
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+namespace engine::util::ds {
+/**
+* @class MpscRing
+* @brief Bounded lock-free queue that any number of threads push into and a single thread pops from.
+*
+* Every cell carries a sequence number that tells whether it is free for the producer at a given position
+* or holds a value for the consumer, so neither side takes a lock (D. Vyukov's bounded MPMC queue, with the
+* consumer side simplified to a single thread). Producers claim a position with one CAS and never wait for
+* each other's writes; when the ring is full, the push fails instead of blocking.
+*
+* Values are written and read in place, so `T` is constructed once with the ring and reused for every message.
+* @code
+* util::ds::MpscRing<Record> ring(1024);
+* ring.try_push([&](Record &record) { record.value = 42; });   // any thread
+* ring.try_pop([&](Record &record) { consume(record); });       // the consumer thread
+* @endcode
+*/
+template<typename T>
+class MpscRing {
+public:
+    /**
+    * @brief Creates a ring with room for `capacity` values, rounded up to a power of two.
+    */
+    explicit MpscRing(std::size_t capacity) : m_mask(std::bit_ceil(capacity < 2 ? 2 : capacity) - 1),
+                                              m_cells(std::make_unique<Cell[]>(m_mask + 1)) {
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing &) = delete;
+
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    /**
+    * @brief Claims a free cell and calls `fill(T &)` to write the value into it. Safe to call from any thread.
+    * @returns false without calling `fill` if the ring is full.
+    */
+    template<typename F>
+    bool try_push(F &&fill) {
+        Cell *cell;
+        std::size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &m_cells[position & m_mask];
+            const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+        fill(cell->value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    * @brief Calls `consume(T &)` on the oldest published value and frees its cell.
+    * Only the consumer thread may call it.
+    * @returns false if there is nothing to pop. A value that is still being written counts as nothing.
+    */
+    template<typename F>
+    bool try_pop(F &&consume) {
+        Cell &cell = m_cells[m_dequeue_position & m_mask];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != m_dequeue_position + 1) {
+            return false;
+        }
+        consume(cell.value);
+        cell.sequence.store(m_dequeue_position + m_mask + 1, std::memory_order_release);
+        ++m_dequeue_position;
+        return true;
+    }
+
+    std::size_t capacity() const {
+        return m_mask + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    const std::size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    /**
+    * @brief Shared by the producers. Kept off the consumer's cache line, so popping doesn't invalidate it.
+    */
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_enqueue_position{0};
+    alignas(CACHE_LINE) std::size_t m_dequeue_position{0};
+};
+} // namespace engine::util::ds
+
+#endif//MATF_RG_PROJECT_MPSC_RING_HPP
@@ -0,0 +1,152 @@
+/**
+ * @file ObjectPool.hpp
+ * @brief Defines the ObjectPool class that allocates objects of a single type from fixed-size chunks.
+ */
+
+#ifndef MATF_RG_PROJECT_OBJECT_POOL_HPP
+#define MATF_RG_PROJECT_OBJECT_POOL_HPP
+
+#include <engine/util/Errors.hpp>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace engine::util::ds {
+/**
+* @class ObjectPool
+* @brief A pool of fixed-size slots for objects of type `T` with an intrusive free list.
+*
+* Objects are allocated from chunks of `CHUNK_SIZE` slots. Chunks are never moved or released while the pool
+* is alive, so pointers to the objects stay stable. A destroyed object's slot is pushed onto the free list
+* and handed out by the next @ref ObjectPool::create, which makes create/destroy O(1) without touching the heap
+* in a steady state.
+* @code
+* util::ds::ObjectPool<Particle> particles;
+* Particle *p = particles.create(position, velocity);
+* ...
+* particles.destroy(p);
+* @endcode
+*/
+template<typename T, std::size_t CHUNK_SIZE = 256>
+class ObjectPool {
+    static_assert(CHUNK_SIZE > 0);
+
+public:
+    ObjectPool() = default;
+
+    ObjectPool(const ObjectPool &) = delete;
+
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    ~ObjectPool() {
+        for (auto &chunk: m_chunks) {
+            for (auto &slot: chunk->slots) {
+                if (slot.live) {
+                    std::destroy_at(slot.object());
+                }
+            }
+        }
+    }
+
+    /**
+    * @brief Constructs a new `T` in a free slot.
+    * @returns Pointer to the object that stays valid until @ref ObjectPool::destroy is called on it.
+    */
+    template<typename... Args>
+    T *create(Args &&... args) {
+        if (!m_free_head) {
+            grow();
+        }
+        Slot *slot = m_free_head;
+        T *object = std::construct_at(slot->object(), std::forward<Args>(args)...);
+        m_free_head = slot->next_free;
+        slot->live = true;
+        ++m_size;
+        return object;
+    }
+
+    /**
+    * @brief Destroys the `object` and returns its slot to the pool.
+    * @param object Must have been created by this pool.
+    */
+    void destroy(T *object) {
+        if (!object) {
+            return;
+        }
+        Slot *slot = Slot::from_object(object);
+        RG_GUARANTEE(slot->live, "ObjectPool: double destroy of an object.");
+        std::destroy_at(object);
+        slot->live = false;
+        slot->next_free = m_free_head;
+        m_free_head = slot;
+        --m_size;
+    }
+
+    /**
+    * @brief Calls `func` for every live object. Objects are visited chunk by chunk, in memory order.
+    */
+    template<typename Func>
+    void for_each(Func func) {
+        for (auto &chunk: m_chunks) {
+            for (auto &slot: chunk->slots) {
+                if (slot.live) {
+                    func(*slot.object());
+                }
+            }
+        }
+    }
+
+    /**
+    * @returns Number of live objects.
+    */
+    std::size_t size() const {
+        return m_size;
+    }
+
+    /**
+    * @returns Number of slots across all chunks.
+    */
+    std::size_t capacity() const {
+        return m_chunks.size() * CHUNK_SIZE;
+    }
+
+private:
+    struct Slot {
+        alignas(T) std::byte storage[sizeof(T)];
+        Slot *next_free;
+        bool live;
+
+        T *object() {
+            return std::launder(reinterpret_cast<T *>(storage));
+        }
+
+        static Slot *from_object(T *object) {
+            static_assert(offsetof(Slot, storage) == 0);
+            return reinterpret_cast<Slot *>(object);
+        }
+    };
+
+    struct Chunk {
+        std::array<Slot, CHUNK_SIZE> slots;
+    };
+
+    void grow() {
+        auto &chunk = m_chunks.emplace_back(std::make_unique<Chunk>());
+        for (std::size_t i = CHUNK_SIZE; i-- > 0;) {
+            Slot &slot = chunk->slots[i];
+            slot.live = false;
+            slot.next_free = m_free_head;
+            m_free_head = &slot;
+        }
+    }
+
+    std::vector<std::unique_ptr<Chunk> > m_chunks;
+    Slot *m_free_head{nullptr};
+    std::size_t m_size{0};
+};
+} // namespace engine::util::ds
+
+#endif//MATF_RG_PROJECT_OBJECT_POOL_HPP
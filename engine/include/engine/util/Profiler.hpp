@@ -0,0 +1,281 @@
+/**
+ * @file Profiler.hpp
+ * @brief Defines the hierarchical CPU frame profiler: scoped zones, per-frame history and Chrome trace export.
+ */
+
+#ifndef MATF_RG_PROJECT_PROFILER_HPP
+#define MATF_RG_PROJECT_PROFILER_HPP
+
+#include <json.hpp>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine::util {
+/**
+* @brief Checked by every @ref ProfileScope. While it's false, a scope costs one relaxed load and a branch.
+*/
+inline std::atomic<bool> g_profiler_enabled{false};
+
+/**
+* @struct ProfileZone
+* @brief A completed profiling zone.
+*
+* `name` and `category` are not copied, they must outlive the profiler. Use string literals
+* or names that live as long as the app, like @ref core::Controller::name.
+*/
+struct ProfileZone {
+    std::string_view name;
+    std::string_view category;
+    /**
+    * @brief Nanoseconds since the profiler epoch, see @ref Profiler::now_ns.
+    */
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    /**
+    * @brief Nesting level of the zone on its thread, 0 for the outermost zones.
+    */
+    uint32_t depth;
+    /**
+    * @brief Index of the timeline lane, see @ref Profiler::lane_name.
+    */
+    uint32_t lane;
+};
+
+/**
+* @struct ProfileFrame
+* @brief Zones recorded between two calls to @ref Profiler::new_frame.
+*/
+struct ProfileFrame {
+    uint64_t index;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    std::vector<ProfileZone> zones;
+};
+
+/**
+* @class Profiler
+* @brief Collects the @ref ProfileScope zones of all threads into per-frame timelines.
+*
+* Each thread records its zones into its own ring buffer, without locks. Once per frame, @ref core::App::loop
+* calls @ref Profiler::new_frame, which moves the zones from the rings into the frame history.
+* @ref core::App wraps every controller phase in a zone, so enabling the profiler is enough to see where the
+* frame time goes. Add your own zones with @ref RG_PROFILE_SCOPE:
+* @code
+* void MainController::draw_backpack() {
+*     RG_PROFILE_SCOPE("draw_backpack");
+*     ...
+* }
+* @endcode
+*
+* Enable it with `"profiler": { "enabled": true }` in the config.json or from the profiler panel.
+* Captured frames export to the Chrome trace format that chrome://tracing and https://ui.perfetto.dev open.
+*/
+class Profiler {
+public:
+    static constexpr std::size_t HISTORY_SIZE = 120;
+    static constexpr std::size_t THREAD_RING_SIZE = 1 << 13;
+
+    static Profiler *instance();
+
+    /**
+    * @returns Nanoseconds since the first call, from the steady clock.
+    */
+    static uint64_t now_ns();
+
+    static bool is_enabled() {
+        return g_profiler_enabled.load(std::memory_order_relaxed);
+    }
+
+    void set_enabled(bool enabled);
+
+    /**
+    * @brief Applies the `profiler` section of the configuration:
+    * @code
+    * "profiler": { "enabled": true, "capture_frames": 300, "capture_path": "profile.json" }
+    * @endcode
+    * A non-zero `capture_frames` starts a capture with the first frame.
+    */
+    void configure(const nlohmann::json &config);
+
+    /**
+    * @brief Closes the current frame and opens the next one. Called by @ref core::App::loop.
+    */
+    void new_frame();
+
+    /**
+    * @brief Records the next `frame_count` frames and writes them as a Chrome trace to `path` when done.
+    */
+    void start_capture(uint32_t frame_count, std::filesystem::path path);
+
+    bool is_capturing() const {
+        return m_capture_remaining > 0;
+    }
+
+    /**
+    * @brief Writes `frames` in the Chrome trace event format.
+    */
+    void export_chrome_trace(const std::vector<ProfileFrame> &frames, const std::filesystem::path &path) const;
+
+    /**
+    * @returns The most recent completed frame, or nullptr if no frame has been recorded yet.
+    */
+    const ProfileFrame *last_frame() const;
+
+    /**
+    * @returns The frame with the `index` if it's still in the history, nullptr otherwise.
+    * Frames are only recorded while the profiler is enabled.
+    */
+    const ProfileFrame *frame(uint64_t index) const;
+
+    /**
+    * @returns The index of the frame that is being recorded.
+    */
+    uint64_t frame_index() const {
+        return m_frame_index;
+    }
+
+    /**
+    * @brief Registers a timeline lane that is not a thread, e.g. the GPU. Its zones are added with @ref Profiler::submit.
+    * @returns The lane index.
+    */
+    uint32_t register_lane(std::string name);
+
+    /**
+    * @returns A copy of the lane's name, which a thread may rename at any time.
+    */
+    std::string lane_name(uint32_t lane) const;
+
+    /**
+    * @brief Adds an already timed zone to the current frame. Must be called from the thread that calls @ref Profiler::new_frame.
+    */
+    void submit(const ProfileZone &zone);
+
+    /**
+    * @brief Names the calling thread's lane in the timeline.
+    */
+    void set_thread_name(std::string name);
+
+    /**
+    * @brief Draws the profiler panel: controls and the timeline of the last frame. Call between
+    * @ref graphics::GraphicsController::begin_gui and @ref graphics::GraphicsController::end_gui.
+    */
+    void draw_gui();
+
+    /**
+    * @brief Single-producer ring of the zones completed on one thread. The owning thread writes, @ref Profiler::new_frame reads.
+    * The owning thread never overwrites a zone that hasn't been read: when the ring is full, it drops the new zone.
+    */
+    struct ThreadRing {
+        std::unique_ptr<ProfileZone[]> zones{std::make_unique<ProfileZone[]>(THREAD_RING_SIZE)};
+        std::atomic<uint64_t> written{0};
+        std::atomic<uint64_t> read{0};
+        /**
+        * @brief Zones dropped because the ring was full, since the last @ref Profiler::new_frame.
+        */
+        std::atomic<uint64_t> dropped{0};
+        uint32_t lane{0};
+        uint32_t depth{0};
+        /**
+        * @brief Name of the innermost open zone.
+        */
+        std::string_view zone;
+    };
+
+    /**
+    * @brief The calling thread's ring. Registers it on first use.
+    */
+    ThreadRing *thread_ring();
+
+    /**
+    * @returns The name of the calling thread's innermost open zone, empty if there is none or the profiler is disabled.
+    * Doesn't register the thread, so it's safe to call from an allocation hook.
+    */
+    static std::string_view current_zone();
+
+private:
+    Profiler() = default;
+
+    void collect_thread_zones(ProfileFrame &frame);
+
+    /**
+    * @brief Guards @ref Profiler::m_rings and @ref Profiler::m_lane_names, which other threads grow and rename.
+    */
+    mutable std::mutex m_lanes_mutex;
+    std::vector<std::shared_ptr<ThreadRing> > m_rings;
+    std::vector<std::string> m_lane_names;
+
+    std::vector<ProfileFrame> m_history;
+    std::size_t m_history_head{0};
+    ProfileFrame m_current{};
+    uint64_t m_frame_index{0};
+    uint64_t m_dropped_zones{0};
+
+    std::vector<ProfileFrame> m_capture;
+    uint32_t m_capture_remaining{0};
+    std::filesystem::path m_capture_path;
+
+    std::filesystem::path m_gui_capture_path{"profile.json"};
+    bool m_gui_paused{false};
+    /**
+    * @brief The frame shown while the panel is paused.
+    */
+    ProfileFrame m_gui_frame{};
+    std::vector<std::string> m_gui_lane_names;
+};
+
+/**
+* @class ProfileScope
+* @brief Measures the time between its construction and destruction as a @ref ProfileZone.
+*/
+class ProfileScope {
+public:
+    explicit ProfileScope(std::string_view name, std::string_view category = {}) {
+        if (Profiler::is_enabled()) {
+            begin(name, category);
+        }
+    }
+
+    ~ProfileScope() {
+        if (m_ring) {
+            end();
+        }
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    void begin(std::string_view name, std::string_view category);
+
+    void end();
+
+    Profiler::ThreadRing *m_ring{nullptr};
+    std::string_view m_name;
+    std::string_view m_category;
+    std::string_view m_parent_zone;
+    uint64_t m_begin_ns{0};
+    uint32_t m_depth{0};
+};
+} // namespace engine::util
+
+#define RG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RG_PROFILE_CONCAT(a, b) RG_PROFILE_CONCAT_IMPL(a, b)
+
+/**
+* @brief Profiles the enclosing scope as a zone named `name`.
+*/
+#define RG_PROFILE_SCOPE(...) ::engine::util::ProfileScope RG_PROFILE_CONCAT(rg_profile_scope_, __LINE__)(__VA_ARGS__)
+
+/**
+* @brief Profiles the enclosing function.
+*/
+#define RG_PROFILE_FUNCTION() RG_PROFILE_SCOPE(__func__)
+
+#endif//MATF_RG_PROJECT_PROFILER_HPP
@@ -0,0 +1,212 @@
+/**
+ * @file SlotMap.hpp
+ * @brief Defines the SlotMap container that stores objects densely and references them through generational handles.
+ */
+
+#ifndef MATF_RG_PROJECT_SLOT_MAP_HPP
+#define MATF_RG_PROJECT_SLOT_MAP_HPP
+
+#include <engine/util/Errors.hpp>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace engine::util::ds {
+/**
+* @struct SlotHandle
+* @brief A stable reference to a value in a @ref SlotMap.
+*
+* The handle stays valid until the value is erased. After that, the slot may be reused, but the
+* generation changes, so the old handle won't resolve to the new value.
+*/
+struct SlotHandle {
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    uint32_t index{INVALID_INDEX};
+    uint32_t generation{0};
+
+    bool is_valid() const {
+        return index != INVALID_INDEX;
+    }
+
+    bool operator==(const SlotHandle &) const = default;
+};
+
+/**
+* @class SlotMap
+* @brief Generational slot map with O(1) insert, erase and lookup, and dense iteration.
+*
+* Values are stored contiguously in insertion order (erase moves the last value into the hole),
+* so iterating over all the values is a linear walk over a `std::vector<T>`. Handles go through
+* one level of indirection (the slot table) to find the current position of the value.
+* @code
+* util::ds::SlotMap<Entity> entities;
+* auto handle = entities.insert(Entity{...});
+* entities.get(handle)->position = ...;
+* for (auto &entity: entities) { ... }
+* entities.erase(handle);
+* @endcode
+*/
+template<typename T>
+class SlotMap {
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /**
+    * @brief Reserves space for `capacity` values so that inserting doesn't reallocate.
+    */
+    void reserve(std::size_t capacity) {
+        m_values.reserve(capacity);
+        m_value_slots.reserve(capacity);
+        m_slots.reserve(capacity);
+    }
+
+    /**
+    * @brief Inserts the value and returns the handle through which it can be accessed.
+    */
+    template<typename... Args>
+    SlotHandle emplace(Args &&... args) {
+        uint32_t slot_index;
+        if (m_free_head != SlotHandle::INVALID_INDEX) {
+            slot_index = m_free_head;
+            m_free_head = m_slots[slot_index].target;
+        } else {
+            slot_index = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back(Slot{});
+        }
+        Slot &slot = m_slots[slot_index];
+        slot.target = static_cast<uint32_t>(m_values.size());
+        m_values.emplace_back(std::forward<Args>(args)...);
+        m_value_slots.push_back(slot_index);
+        return SlotHandle{slot_index, slot.generation};
+    }
+
+    SlotHandle insert(T value) {
+        return emplace(std::move(value));
+    }
+
+    /**
+    * @brief Erases the value referenced by the `handle`.
+    * @returns false if the handle doesn't reference a live value.
+    */
+    bool erase(SlotHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        Slot &slot = m_slots[handle.index];
+        const uint32_t hole = slot.target;
+        const uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+        if (hole != last) {
+            m_values[hole] = std::move(m_values[last]);
+            m_value_slots[hole] = m_value_slots[last];
+            m_slots[m_value_slots[hole]].target = hole;
+        }
+        m_values.pop_back();
+        m_value_slots.pop_back();
+
+        ++slot.generation;
+        slot.target = m_free_head;
+        m_free_head = handle.index;
+        return true;
+    }
+
+    /**
+    * @returns true if the `handle` references a live value.
+    */
+    bool contains(SlotHandle handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+               is_live(handle.index);
+    }
+
+    /**
+    * @returns Pointer to the value referenced by `handle`, or nullptr if it was erased.
+    * The pointer is invalidated by insert and erase, keep the handle instead.
+    */
+    T *get(SlotHandle handle) {
+        return contains(handle) ? &m_values[m_slots[handle.index].target] : nullptr;
+    }
+
+    const T *get(SlotHandle handle) const {
+        return contains(handle) ? &m_values[m_slots[handle.index].target] : nullptr;
+    }
+
+    /**
+    * @returns The value referenced by the `handle`. Throws if the handle doesn't reference a live value.
+    */
+    T &operator[](SlotHandle handle) {
+        RG_GUARANTEE(contains(handle), "SlotMap: stale handle (index={}, generation={}).", handle.index,
+                     handle.generation);
+        return m_values[m_slots[handle.index].target];
+    }
+
+    /**
+    * @returns The handle of the value at the position `dense_index` of the dense storage.
+    */
+    SlotHandle handle_at(std::size_t dense_index) const {
+        const uint32_t slot_index = m_value_slots[dense_index];
+        return SlotHandle{slot_index, m_slots[slot_index].generation};
+    }
+
+    void clear() {
+        for (uint32_t slot_index: m_value_slots) {
+            Slot &slot = m_slots[slot_index];
+            ++slot.generation;
+            slot.target = m_free_head;
+            m_free_head = slot_index;
+        }
+        m_values.clear();
+        m_value_slots.clear();
+    }
+
+    std::size_t size() const {
+        return m_values.size();
+    }
+
+    bool empty() const {
+        return m_values.empty();
+    }
+
+    T *data() {
+        return m_values.data();
+    }
+
+    iterator begin() {
+        return m_values.begin();
+    }
+
+    iterator end() {
+        return m_values.end();
+    }
+
+    const_iterator begin() const {
+        return m_values.begin();
+    }
+
+    const_iterator end() const {
+        return m_values.end();
+    }
+
+private:
+    /**
+    * @brief For live slots `target` is the index into the dense storage, for free slots it's the next free slot.
+    */
+    struct Slot {
+        uint32_t target{SlotHandle::INVALID_INDEX};
+        uint32_t generation{0};
+    };
+
+    bool is_live(uint32_t slot_index) const {
+        const uint32_t target = m_slots[slot_index].target;
+        return target < m_value_slots.size() && m_value_slots[target] == slot_index;
+    }
+
+    std::vector<T> m_values;
+    std::vector<uint32_t> m_value_slots;
+    std::vector<Slot> m_slots;
+    uint32_t m_free_head{SlotHandle::INVALID_INDEX};
+};
+} // namespace engine::util::ds
+
+#endif//MATF_RG_PROJECT_SLOT_MAP_HPP
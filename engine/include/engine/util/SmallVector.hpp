@@ -0,0 +1,270 @@
+/**
+ * @file SmallVector.hpp
+ * @brief Defines the SmallVector container that keeps the first N elements inline, without a heap allocation.
+ */
+
+#ifndef MATF_RG_PROJECT_SMALL_VECTOR_HPP
+#define MATF_RG_PROJECT_SMALL_VECTOR_HPP
+
+#include <engine/util/Errors.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace engine::util::ds {
+/**
+* @class SmallVector
+* @brief A vector that stores up to `N` elements inside the object itself and only goes to the heap when it grows past `N`.
+*
+* Use it for the many small, short lists in the engine (textures of a mesh, children of a node...) where
+* a `std::vector` would cost a heap allocation and a pointer chase for two or three elements.
+* The interface follows `std::vector`.
+*/
+template<typename T, std::size_t N>
+class SmallVector {
+    static_assert(N > 0);
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    SmallVector() = default;
+
+    SmallVector(std::initializer_list<T> values) {
+        reserve(values.size());
+        for (const auto &value: values) {
+            push_back(value);
+        }
+    }
+
+    SmallVector(const SmallVector &other) {
+        reserve(other.size());
+        std::uninitialized_copy(other.begin(), other.end(), m_data);
+        m_size = other.m_size;
+    }
+
+    SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        take(std::move(other));
+    }
+
+    SmallVector &operator=(const SmallVector &other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size());
+            std::uninitialized_copy(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            release_heap();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        clear();
+        release_heap();
+    }
+
+    template<typename... Args>
+    T &emplace_back(Args &&... args) {
+        if (m_size == m_capacity) {
+            return grow_and_emplace_back(std::forward<Args>(args)...);
+        }
+        T *result = std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+        ++m_size;
+        return *result;
+    }
+
+    void push_back(const T &value) {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() {
+        RG_GUARANTEE(m_size > 0, "SmallVector::pop_back on an empty vector.");
+        --m_size;
+        std::destroy_at(m_data + m_size);
+    }
+
+    /**
+    * @brief Makes sure that the vector can hold `capacity` elements without reallocating.
+    */
+    void reserve(size_type capacity) {
+        if (capacity <= m_capacity) {
+            return;
+        }
+        T *data = allocate(capacity);
+        adopt(data, capacity);
+    }
+
+    void resize(size_type size) {
+        reserve(size);
+        while (m_size < size) {
+            emplace_back();
+        }
+        while (m_size > size) {
+            pop_back();
+        }
+    }
+
+    void clear() {
+        std::destroy(m_data, m_data + m_size);
+        m_size = 0;
+    }
+
+    T &operator[](size_type index) {
+        return m_data[index];
+    }
+
+    const T &operator[](size_type index) const {
+        return m_data[index];
+    }
+
+    T &back() {
+        return m_data[m_size - 1];
+    }
+
+    const T &back() const {
+        return m_data[m_size - 1];
+    }
+
+    T *data() {
+        return m_data;
+    }
+
+    const T *data() const {
+        return m_data;
+    }
+
+    size_type size() const {
+        return m_size;
+    }
+
+    size_type capacity() const {
+        return m_capacity;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    /**
+    * @returns true if the elements are stored inline, i.e. the vector never outgrew `N`.
+    */
+    bool is_inline() const {
+        return m_data == inline_data();
+    }
+
+    iterator begin() {
+        return m_data;
+    }
+
+    iterator end() {
+        return m_data + m_size;
+    }
+
+    const_iterator begin() const {
+        return m_data;
+    }
+
+    const_iterator end() const {
+        return m_data + m_size;
+    }
+
+private:
+    T *inline_data() {
+        return std::launder(reinterpret_cast<T *>(m_inline));
+    }
+
+    const T *inline_data() const {
+        return std::launder(reinterpret_cast<const T *>(m_inline));
+    }
+
+    static T *allocate(size_type capacity) {
+        return static_cast<T *>(::operator new(capacity * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+
+    static void deallocate(T *data) {
+        ::operator delete(data, std::align_val_t{alignof(T)});
+    }
+
+    /**
+    * @brief Moves the elements into `data`, a fresh buffer of `capacity` elements, and frees the old buffer.
+    */
+    void adopt(T *data, size_type capacity) {
+        std::uninitialized_move(m_data, m_data + m_size, data);
+        std::destroy(m_data, m_data + m_size);
+        release_heap();
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    /**
+    * @brief Grows the vector by constructing the new element in the new buffer first, and only then moving the old
+    * elements out of the old one. `args` may refer to an element of this vector, as in `v.push_back(v[0])`.
+    */
+    template<typename... Args>
+    T &grow_and_emplace_back(Args &&... args) {
+        const size_type capacity = m_capacity * 2;
+        T *data = allocate(capacity);
+        T *result;
+        try {
+            result = std::construct_at(data + m_size, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(data);
+            throw;
+        }
+        adopt(data, capacity);
+        ++m_size;
+        return *result;
+    }
+
+    void release_heap() {
+        if (!is_inline()) {
+            deallocate(m_data);
+            m_data = inline_data();
+            m_capacity = N;
+        }
+    }
+
+    /**
+    * @brief Steals the heap buffer of `other`, or moves its elements one by one if they are stored inline.
+    * Expects `this` to be empty and inline.
+    */
+    void take(SmallVector &&other) {
+        if (other.is_inline()) {
+            std::uninitialized_move(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+            other.clear();
+        } else {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            other.m_data = other.inline_data();
+            other.m_size = 0;
+            other.m_capacity = N;
+        }
+    }
+
+    alignas(T) std::byte m_inline[N * sizeof(T)];
+    T *m_data{inline_data()};
+    size_type m_size{0};
+    size_type m_capacity{N};
+};
+} // namespace engine::util::ds
+
+#endif//MATF_RG_PROJECT_SMALL_VECTOR_HPP
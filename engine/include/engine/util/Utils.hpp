@@ -85,8 +85,14 @@ void tracing_off();
 * }
 * @endcode
 * Prints: "foo() at foo.cpp:10"
+* Compiles to nothing in Release builds.
 */
+#ifdef RG_ENGINE_TRACE
 void trace(std::source_location location = std::source_location::current());
+#else
+inline void trace(std::source_location = std::source_location::current()) {
+}
+#endif
 
 /**
 * @brief Reads a text file.
@@ -95,6 +101,13 @@ void trace(std::source_location location = std::source_location::current());
 */
 std::string read_text_file(const std::filesystem::path &path);
 
+/**
+* @brief Reads a binary file.
+* @param path The path to the file.
+* @returns The bytes of the file.
+*/
+std::vector<uint8_t> read_binary_file(const std::filesystem::path &path);
+
 /**
 * @brief Calls an action once.
 * @param action The action to call.
@@ -0,0 +1,560 @@
+#include <imgui.h>
+#include <engine/util/AllocationTracker.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Profiler.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <new>
+#include <thread>
+#include <utility>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if __has_include(<dlfcn.h>) && __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#define RG_ALLOCATION_TRACKER_SYMBOLIZE
+#endif
+
+namespace engine::util {
+// Index into Logging::SUBSYSTEMS of the innermost AllocationTracker::Scope.
+static thread_local uint8_t g_allocation_subsystem = 0;
+// Set while the thread is inside the tracker, so the tracker's own allocations aren't counted and can't deadlock.
+static thread_local bool g_inside_tracker = false;
+static thread_local bool g_main_thread = false;
+
+static uint8_t subsystem_index(std::string_view subsystem) {
+    for (std::size_t i = 0; i < std::size(Logging::SUBSYSTEMS); ++i) {
+        if (Logging::SUBSYSTEMS[i] == subsystem) {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    return 0;
+}
+
+static void add(AllocationCounters &counters, uint64_t bytes) {
+    ++counters.allocations;
+    counters.bytes += bytes;
+}
+
+AllocationTracker *AllocationTracker::instance() {
+    // Never destroyed: operator delete still reaches the tracker while the other statics are destroyed.
+    alignas(AllocationTracker) static unsigned char storage[sizeof(AllocationTracker)];
+    static AllocationTracker *tracker = new(storage) AllocationTracker();
+    return tracker;
+}
+
+AllocationTracker::Scope::Scope(std::string_view subsystem) :
+        m_previous(std::exchange(g_allocation_subsystem, subsystem_index(subsystem))) {
+}
+
+AllocationTracker::Scope::~Scope() {
+    g_allocation_subsystem = m_previous;
+}
+
+void AllocationTracker::configure(const nlohmann::json &config) {
+    g_main_thread = true;
+    if (!config.contains("allocations")) {
+        return;
+    }
+    const auto &allocations = config["allocations"];
+    m_report_sites = allocations.value("report_sites", m_report_sites);
+    m_zero_after_frame = allocations.value("zero_after_frame", m_zero_after_frame);
+    const bool enabled = allocations.value("enabled", true);
+    if (enabled && !is_compiled_in()) {
+        logger("engine")->warn("allocations.enabled is set, but the engine was built without RG_ALLOCATION_TRACKING.");
+        return;
+    }
+    set_enabled(enabled);
+}
+
+void AllocationTracker::set_enabled(bool enabled) {
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void AllocationTracker::lock() {
+    g_inside_tracker = true;
+    while (m_lock.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void AllocationTracker::unlock() {
+    m_lock.clear(std::memory_order_release);
+    g_inside_tracker = false;
+}
+
+AllocationSite *AllocationTracker::find_or_insert(SiteTable &entries, const void *key) {
+    std::size_t index = std::hash<const void *>{}(key) % MAX_SITES;
+    for (std::size_t probe = 0; probe < MAX_SITES; ++probe, index = (index + 1) % MAX_SITES) {
+        auto &entry = entries[index];
+        if (entry.key == key) {
+            return &entry;
+        }
+        if (!entry.key) {
+            entry.key = key;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void AllocationTracker::on_allocate(std::size_t bytes, std::size_t usable_bytes, const void *site) {
+    if (g_inside_tracker) {
+        return;
+    }
+    const std::string_view zone = Profiler::current_zone();
+    lock();
+    const uint64_t frame = m_current.frame;
+    add(m_current.total, bytes);
+    add(m_current.subsystems[g_allocation_subsystem], bytes);
+    if (g_main_thread) {
+        add(m_current.main_thread, bytes);
+    }
+    m_live_bytes += static_cast<int64_t>(usable_bytes);
+    if (m_live_bytes > m_peak_live_bytes.load(std::memory_order_relaxed)) {
+        m_peak_live_bytes.store(m_live_bytes, std::memory_order_relaxed);
+    }
+
+    auto count = [&](AllocationSite *entry) {
+        if (!entry) {
+            ++m_dropped_sites;
+            return;
+        }
+        if (entry->frame != frame) {
+            entry->frame = frame;
+            entry->last = {};
+        }
+        add(entry->total, bytes);
+        add(entry->last, bytes);
+    };
+    count(find_or_insert(m_sites, site));
+    if (!zone.empty()) {
+        auto entry = find_or_insert(m_zones, zone.data());
+        if (entry) {
+            entry->zone = zone;
+        }
+        count(entry);
+    }
+    unlock();
+}
+
+void AllocationTracker::on_free(std::size_t usable_bytes) {
+    if (g_inside_tracker) {
+        return;
+    }
+    lock();
+    ++m_current.frees;
+    m_live_bytes -= static_cast<int64_t>(usable_bytes);
+    unlock();
+}
+
+void AllocationTracker::new_frame() {
+    if (!is_enabled()) {
+        return;
+    }
+    lock();
+    const AllocationFrame closed = m_current;
+    m_current = AllocationFrame{.frame = closed.frame + 1};
+    unlock();
+
+    m_last_frame = closed;
+    if (closed.main_thread.allocations > m_peak_frame.main_thread.allocations) {
+        m_peak_frame = closed;
+    }
+    if (m_zero_after_frame == 0 || closed.frame <= m_zero_after_frame || closed.main_thread.allocations == 0) {
+        return;
+    }
+    std::string sites;
+    for (const auto &site: top_sites(m_report_sites, closed.frame)) {
+        sites += std::format("\n  {:>6} allocations {:>10} B  {}", site.last.allocations, site.last.bytes,
+                             site_name(site.key));
+    }
+    RG_GUARANTEE(false, "Frame {} made {} allocations ({} B) on the main thread, but frames after {} must not allocate. "
+                 "Top call sites (of all threads):{}", closed.frame, closed.main_thread.allocations,
+                 closed.main_thread.bytes, m_zero_after_frame, sites);
+}
+
+std::vector<AllocationSite> AllocationTracker::top_entries(const SiteTable &entries, std::size_t count,
+                                                           std::optional<uint64_t> frame) {
+    std::vector<AllocationSite> result;
+    lock();
+    for (const auto &entry: entries) {
+        if (entry.key && (!frame || entry.frame == *frame)) {
+            result.push_back(entry);
+        }
+    }
+    unlock();
+    const auto allocations = [&](const AllocationSite &site) {
+        return frame ? site.last.allocations : site.total.allocations;
+    };
+    count = std::min(count, result.size());
+    std::ranges::partial_sort(result, result.begin() + count, std::greater{}, allocations);
+    result.resize(count);
+    return result;
+}
+
+std::vector<AllocationSite> AllocationTracker::top_sites(std::size_t count, std::optional<uint64_t> frame) {
+    return top_entries(m_sites, count, frame);
+}
+
+std::vector<AllocationSite> AllocationTracker::top_zones(std::size_t count, std::optional<uint64_t> frame) {
+    return top_entries(m_zones, count, frame);
+}
+
+std::string AllocationTracker::describe_site(const void *site) {
+#ifdef RG_ALLOCATION_TRACKER_SYMBOLIZE
+    Dl_info info{};
+    if (dladdr(site, &info) && info.dli_sname) {
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string result = std::format("{}+{:#x}", status == 0 ? demangled : info.dli_sname,
+                                         static_cast<const char *>(site) - static_cast<const char *>(info.dli_saddr));
+        std::free(demangled);
+        return result;
+    }
+    if (info.dli_fname) {
+        // Functions without a dynamic symbol, e.g. without -rdynamic; resolve them with addr2line.
+        return std::format("{}+{:#x}", info.dli_fname,
+                           static_cast<const char *>(site) - static_cast<const char *>(info.dli_fbase));
+    }
+#endif
+    return std::format("{}", site);
+}
+
+const std::string &AllocationTracker::site_name(const void *site) {
+    auto it = m_site_names.find(site);
+    if (it == m_site_names.end()) {
+        it = m_site_names.emplace(site, describe_site(site)).first;
+    }
+    return it->second;
+}
+
+void AllocationTracker::log_report() {
+    if (!is_enabled()) {
+        return;
+    }
+    auto log = logger("engine");
+    const auto &peak = m_peak_frame;
+    log->info("Allocations: peak frame {} with {} allocations ({:.1f} KB) on the main thread, {} on all threads; "
+              "peak heap growth {:.2f} MB.", peak.frame, peak.main_thread.allocations,
+              static_cast<double>(peak.main_thread.bytes) / 1024.0, peak.total.allocations,
+              static_cast<double>(peak_live_bytes()) / (1024.0 * 1024.0));
+    if (m_dropped_sites > 0) {
+        log->warn("{} allocations didn't fit into the call site tables.", m_dropped_sites);
+    }
+    log->info("{:>10} {:>12}  {}", "count", "KB", "call site");
+    for (const auto &site: top_sites(m_report_sites)) {
+        log->info("{:>10} {:>12.1f}  {}", site.total.allocations, static_cast<double>(site.total.bytes) / 1024.0,
+                  site_name(site.key));
+    }
+    log->info("{:>10} {:>12}  {}", "count", "KB", "profiler zone");
+    for (const auto &zone: top_zones(m_report_sites)) {
+        log->info("{:>10} {:>12.1f}  {}", zone.total.allocations, static_cast<double>(zone.total.bytes) / 1024.0,
+                  zone.zone);
+    }
+}
+
+void AllocationTracker::draw_gui() {
+    ImGui::Begin("Allocations");
+    if (!is_enabled()) {
+        ImGui::TextUnformatted(is_compiled_in()
+                               ? "Enable allocations in the config.json."
+                               : "Build the engine with -DRG_ALLOCATION_TRACKING=ON.");
+        ImGui::End();
+        return;
+    }
+    const auto &last = m_last_frame;
+    ImGui::Text("Frame %llu: %llu allocations (%.1f KB) on the main thread, %llu on all threads, %llu frees",
+                static_cast<unsigned long long>(last.frame),
+                static_cast<unsigned long long>(last.main_thread.allocations),
+                static_cast<double>(last.main_thread.bytes) / 1024.0,
+                static_cast<unsigned long long>(last.total.allocations), static_cast<unsigned long long>(last.frees));
+    ImGui::Text("Peak: %llu allocations in frame %llu, heap growth %.2f MB",
+                static_cast<unsigned long long>(m_peak_frame.main_thread.allocations),
+                static_cast<unsigned long long>(m_peak_frame.frame),
+                static_cast<double>(peak_live_bytes()) / (1024.0 * 1024.0));
+    constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg;
+    if (ImGui::BeginTable("subsystems", 3, flags)) {
+        for (const char *column: {"Subsystem", "Allocations", "KB"}) {
+            ImGui::TableSetupColumn(column);
+        }
+        ImGui::TableHeadersRow();
+        for (std::size_t i = 0; i < last.subsystems.size(); ++i) {
+            const auto subsystem = Logging::SUBSYSTEMS[i];
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(subsystem.data(), subsystem.data() + subsystem.size());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(last.subsystems[i].allocations));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(last.subsystems[i].bytes) / 1024.0);
+        }
+        ImGui::EndTable();
+    }
+    if (ImGui::BeginTable("zones", 3, flags)) {
+        for (const char *column: {"Profiler zone", "Allocations", "KB"}) {
+            ImGui::TableSetupColumn(column);
+        }
+        ImGui::TableHeadersRow();
+        for (const auto &zone: top_zones(m_report_sites, last.frame)) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(zone.zone.data(), zone.zone.data() + zone.zone.size());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(zone.last.allocations));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(zone.last.bytes) / 1024.0);
+        }
+        ImGui::EndTable();
+    }
+    if (ImGui::BeginTable("sites", 3, flags)) {
+        for (const char *column: {"Call site", "Allocations", "KB"}) {
+            ImGui::TableSetupColumn(column);
+        }
+        ImGui::TableHeadersRow();
+        for (const auto &site: top_sites(m_report_sites, last.frame)) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(site_name(site.key).c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(site.last.allocations));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(site.last.bytes) / 1024.0);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+} // namespace engine::util
+
+#ifdef RG_ALLOCATION_TRACKING
+#if defined(__GLIBC__)
+// glibc's own allocator under the names it exports for malloc replacements. The replaced malloc family below forwards
+// to them, and so do operator new/delete, so an allocation made through operator new is counted only once.
+extern "C" {
+void *libc_malloc(std::size_t bytes) __asm__("__libc_malloc");
+void *libc_calloc(std::size_t count, std::size_t bytes) __asm__("__libc_calloc");
+void *libc_realloc(void *pointer, std::size_t bytes) __asm__("__libc_realloc");
+void *libc_memalign(std::size_t alignment, std::size_t bytes) __asm__("__libc_memalign");
+void libc_free(void *pointer) __asm__("__libc_free");
+}
+#define RG_ALLOCATION_TRACKER_MALLOC
+#endif
+
+namespace {
+std::size_t usable_size(void *pointer) {
+#if defined(__GLIBC__)
+    return malloc_usable_size(pointer);
+#else
+    (void) pointer;
+    return 0;
+#endif
+}
+
+void *raw_allocate(std::size_t bytes, std::size_t alignment) {
+#ifdef RG_ALLOCATION_TRACKER_MALLOC
+    return alignment == 0 ? libc_malloc(bytes) : libc_memalign(alignment, bytes);
+#else
+    // aligned_alloc wants the size to be a multiple of the alignment.
+    return alignment == 0 ? std::malloc(bytes)
+                          : std::aligned_alloc(alignment, (bytes + alignment - 1) & ~(alignment - 1));
+#endif
+}
+
+void raw_free(void *pointer) {
+#ifdef RG_ALLOCATION_TRACKER_MALLOC
+    libc_free(pointer);
+#else
+    std::free(pointer);
+#endif
+}
+
+void count_allocation(void *pointer, std::size_t bytes, const void *site) {
+    const auto tracker = engine::util::AllocationTracker::instance();
+    if (pointer && tracker->is_enabled()) {
+        tracker->on_allocate(bytes, usable_size(pointer), site);
+    }
+}
+
+void count_free(void *pointer) {
+    const auto tracker = engine::util::AllocationTracker::instance();
+    if (pointer && tracker->is_enabled()) {
+        tracker->on_free(usable_size(pointer));
+    }
+}
+
+void *tracked_allocate(std::size_t bytes, std::size_t alignment, const void *site) {
+    void *pointer = raw_allocate(bytes == 0 ? 1 : bytes, alignment);
+    count_allocation(pointer, bytes, site);
+    return pointer;
+}
+
+void tracked_free(void *pointer) {
+    if (!pointer) {
+        return;
+    }
+    count_free(pointer);
+    raw_free(pointer);
+}
+
+void *tracked_new(std::size_t bytes, std::size_t alignment, const void *site) {
+    void *pointer = tracked_allocate(bytes, alignment, site);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+} // namespace
+
+// Replacements of the global allocation functions. They live in the same translation unit as the tracker, so
+// linking the engine library always pulls them in.
+void *operator new(std::size_t bytes) {
+    return tracked_new(bytes, 0, __builtin_return_address(0));
+}
+
+void *operator new[](std::size_t bytes) {
+    return tracked_new(bytes, 0, __builtin_return_address(0));
+}
+
+void *operator new(std::size_t bytes, const std::nothrow_t &) noexcept {
+    return tracked_allocate(bytes, 0, __builtin_return_address(0));
+}
+
+void *operator new[](std::size_t bytes, const std::nothrow_t &) noexcept {
+    return tracked_allocate(bytes, 0, __builtin_return_address(0));
+}
+
+void *operator new(std::size_t bytes, std::align_val_t alignment) {
+    return tracked_new(bytes, static_cast<std::size_t>(alignment), __builtin_return_address(0));
+}
+
+void *operator new[](std::size_t bytes, std::align_val_t alignment) {
+    return tracked_new(bytes, static_cast<std::size_t>(alignment), __builtin_return_address(0));
+}
+
+void *operator new(std::size_t bytes, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return tracked_allocate(bytes, static_cast<std::size_t>(alignment), __builtin_return_address(0));
+}
+
+void *operator new[](std::size_t bytes, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return tracked_allocate(bytes, static_cast<std::size_t>(alignment), __builtin_return_address(0));
+}
+
+void operator delete(void *pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept {
+    tracked_free(pointer);
+}
+
+#ifdef RG_ALLOCATION_TRACKER_MALLOC
+// Replacements of the malloc family, so the allocations of C code (GLFW, assimp, stb, the driver) are counted too.
+// Defining them in the executable takes precedence over libc's, see "Replacing malloc" in the glibc manual.
+extern "C" {
+void *malloc(std::size_t bytes) {
+    void *pointer = libc_malloc(bytes);
+    count_allocation(pointer, bytes, __builtin_return_address(0));
+    return pointer;
+}
+
+void *calloc(std::size_t count, std::size_t bytes) {
+    void *pointer = libc_calloc(count, bytes);
+    count_allocation(pointer, count * bytes, __builtin_return_address(0));
+    return pointer;
+}
+
+void *realloc(void *pointer, std::size_t bytes) {
+    // Counted as freeing the old block and allocating a new one, even when the block grows in place.
+    const std::size_t old_usable_bytes = pointer ? usable_size(pointer) : 0;
+    void *result = libc_realloc(pointer, bytes);
+    const auto tracker = engine::util::AllocationTracker::instance();
+    if (tracker->is_enabled()) {
+        // realloc(pointer, 0) frees the block and returns null, a failed realloc leaves the block alone.
+        if (pointer && (result || bytes == 0)) {
+            tracker->on_free(old_usable_bytes);
+        }
+        if (result) {
+            tracker->on_allocate(bytes, usable_size(result), __builtin_return_address(0));
+        }
+    }
+    return result;
+}
+
+void free(void *pointer) {
+    count_free(pointer);
+    libc_free(pointer);
+}
+
+int posix_memalign(void **result, std::size_t alignment, std::size_t bytes) {
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0) {
+        return EINVAL;
+    }
+    void *pointer = libc_memalign(alignment, bytes);
+    if (!pointer) {
+        return ENOMEM;
+    }
+    count_allocation(pointer, bytes, __builtin_return_address(0));
+    *result = pointer;
+    return 0;
+}
+
+void *aligned_alloc(std::size_t alignment, std::size_t bytes) {
+    void *pointer = libc_memalign(alignment, bytes);
+    count_allocation(pointer, bytes, __builtin_return_address(0));
+    return pointer;
+}
+
+void *memalign(std::size_t alignment, std::size_t bytes) {
+    void *pointer = libc_memalign(alignment, bytes);
+    count_allocation(pointer, bytes, __builtin_return_address(0));
+    return pointer;
+}
+}
+#endif
+#endif
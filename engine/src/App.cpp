@@ -1,11 +1,16 @@
 #include <spdlog/spdlog.h>
 #include <engine/core/App.hpp>
+#include <engine/core/BenchmarkController.hpp>
 #include <engine/platform/PlatformController.hpp>
 #include <engine/resources/ResourcesController.hpp>
 #include <engine/util/Errors.hpp>
 
+#include <engine/util/AllocationTracker.hpp>
+#include <engine/util/Arena.hpp>
 #include <engine/util/ArgParser.hpp>
 #include <engine/util/Configuration.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
 #include <engine/graphics/GraphicsController.hpp>
 #include <engine/util/Utils.hpp>
 
@@ -16,6 +21,7 @@ int App::run(int argc, char **argv) {
         app_setup();
         initialize();
         while (loop()) {
+            util::ds::frame_arena().reset();
             poll_events();
             update();
             draw();
@@ -25,12 +31,18 @@ int App::run(int argc, char **argv) {
         handle_error(e);
         terminate();
     }
-    return on_exit();
+    const int exit_code = on_exit();
+    util::Logging::instance()->shutdown();
+    return exit_code;
 }
 
 void App::engine_setup(int argc, char **argv) {
+    util::Logging::instance()->initialize();
     util::ArgParser::instance()->initialize(argc, argv);
     util::Configuration::instance()->initialize();
+    util::Logging::instance()->configure(util::Configuration::config());
+    util::Profiler::instance()->configure(util::Configuration::config());
+    util::AllocationTracker::instance()->configure(util::Configuration::config());
 
     // register engine controllers
     auto begin = register_controller<EngineControllersBegin>();
@@ -42,6 +54,13 @@ void App::engine_setup(int argc, char **argv) {
     platform->before(graphics);
     graphics->before(resources);
     resources->before(end);
+
+    const auto benchmark_script = util::ArgParser::instance()->arg<std::string>("--benchmark").value();
+    if (!benchmark_script.empty()) {
+        auto benchmark = register_controller<BenchmarkController>();
+        benchmark->load_script(benchmark_script);
+        end->before(benchmark);
+    }
 }
 
 void App::initialize() {
@@ -55,13 +74,20 @@ void App::initialize() {
         util::alg::topological_sort(range(m_controllers), adjacent_controllers);
     }
     for (auto controller: m_controllers) {
-        spdlog::info("{}::initialize", controller->name());
+        util::logger("engine")->info("{}::initialize", controller->name());
+        RG_PROFILE_SCOPE(controller->name(), "initialize");
+        RG_ALLOCATION_SCOPE(controller->subsystem());
         controller->initialize();
     }
 }
 
 bool App::loop() {
+    util::Profiler::instance()->new_frame();
+    util::AllocationTracker::instance()->new_frame();
+    RG_PROFILE_SCOPE("App::loop");
     for (auto controller: m_controllers) {
+        RG_PROFILE_SCOPE(controller->name(), "loop");
+        RG_ALLOCATION_SCOPE(controller->subsystem());
         if (controller->is_enabled() && !controller->loop()) {
             return false;
         }
@@ -70,34 +96,51 @@ bool App::loop() {
 }
 
 void App::poll_events() {
+    RG_PROFILE_SCOPE("App::poll_events");
     for (auto controller: m_controllers) {
         // We don't check if the controller is enabled for poll_events because the controller may enable itself in the poll_events if it needs to.
         // For example, a GUIController may enable itself in the poll_events method if a button to enable/disable the GUI was pressed.
+        RG_PROFILE_SCOPE(controller->name(), "poll_events");
+        RG_ALLOCATION_SCOPE(controller->subsystem());
         controller->poll_events();
     }
 }
 
 void App::update() {
+    RG_PROFILE_SCOPE("App::update");
     for (auto controller: m_controllers) {
         if (controller->is_enabled()) {
+            RG_PROFILE_SCOPE(controller->name(), "update");
+            RG_ALLOCATION_SCOPE(controller->subsystem());
             controller->update();
         }
     }
 }
 
 void App::draw() {
+    // Nothing would change on screen: the window is hidden, or nothing asked for a redraw in on-demand mode.
+    if (!Controller::get<platform::PlatformController>()->consume_redraw()) {
+        return;
+    }
+    RG_PROFILE_SCOPE("App::draw");
     for (auto controller: m_controllers) {
         if (controller->is_enabled()) {
+            RG_PROFILE_SCOPE(controller->name(), "begin_draw");
+            RG_ALLOCATION_SCOPE(controller->subsystem());
             controller->begin_draw();
         }
     }
     for (auto controller: m_controllers) {
         if (controller->is_enabled()) {
+            RG_PROFILE_SCOPE(controller->name(), "draw");
+            RG_ALLOCATION_SCOPE(controller->subsystem());
             controller->draw();
         }
     }
     for (auto controller: m_controllers) {
         if (controller->is_enabled()) {
+            RG_PROFILE_SCOPE(controller->name(), "end_draw");
+            RG_ALLOCATION_SCOPE(controller->subsystem());
             controller->end_draw();
         }
     }
@@ -107,9 +150,11 @@ void App::terminate() {
     // We terminate controllers in reverse order of their registration to ensure that controllers that depend on other controllers are terminated last.
     for (auto it = m_controllers.rbegin(); it != m_controllers.rend(); ++it) {
         auto controller = *it;
+        RG_ALLOCATION_SCOPE(controller->subsystem());
         controller->terminate();
-        spdlog::info("{}::terminate", controller->name());
+        util::logger("engine")->info("{}::terminate", controller->name());
     }
+    util::AllocationTracker::instance()->log_report();
 }
 
 void App::app_setup() {
@@ -117,7 +162,7 @@ void App::app_setup() {
 }
 
 void App::handle_error(const util::Error &e) {
-    spdlog::error(e.report());
+    util::logger("engine")->error("{}", e.report());
 }
 } // namespace engine
 
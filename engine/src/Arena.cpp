@@ -0,0 +1,122 @@
+#include <engine/util/Arena.hpp>
+#include <engine/util/Errors.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace engine::util::ds {
+
+void *ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    return m_arena->allocate(bytes, alignment);
+}
+
+LinearArena::LinearArena(std::size_t block_size) : m_block_size(block_size) {
+#ifdef NDEBUG
+    m_poison_on_free = false;
+#else
+    m_poison_on_free = true;
+#endif
+}
+
+LinearArena::~LinearArena() {
+    release();
+}
+
+void *LinearArena::allocate(std::size_t bytes, std::size_t alignment) {
+    RG_GUARANTEE(alignment != 0 && (alignment & (alignment - 1)) == 0, "Alignment {} is not a power of two.", alignment);
+    if (!m_blocks.empty()) {
+        Block &block = m_blocks[m_current];
+        const auto address = reinterpret_cast<std::uintptr_t>(block.data) + m_offset;
+        const std::size_t padding = (alignment - address % alignment) % alignment;
+        if (m_offset + padding + bytes <= block.size) {
+            std::byte *result = block.data + m_offset + padding;
+            m_offset += padding + bytes;
+            m_stats.used += padding + bytes;
+            m_stats.high_water_mark = std::max(m_stats.high_water_mark, m_stats.used);
+            ++m_stats.allocations;
+            return result;
+        }
+    }
+    return allocate_slow(bytes, alignment);
+}
+
+void *LinearArena::allocate_slow(std::size_t bytes, std::size_t alignment) {
+    const std::size_t required = bytes + alignment;
+    std::size_t next = 0;
+    if (!m_blocks.empty()) {
+        m_blocks[m_current].offset = m_offset;
+        next = m_current + 1;
+    }
+    if (next >= m_blocks.size() || m_blocks[next].size < required) {
+        m_blocks.insert(m_blocks.begin() + static_cast<std::ptrdiff_t>(next),
+                        allocate_block(std::max(m_block_size, required)));
+    }
+    m_current = next;
+    m_offset = 0;
+    return allocate(bytes, alignment);
+}
+
+void LinearArena::rewind(Marker marker) {
+    if (m_blocks.empty()) {
+        return;
+    }
+    RG_GUARANTEE(marker.block < m_current || (marker.block == m_current && marker.offset <= m_offset),
+                 "Rewinding the arena forward. Markers must be released in the reverse order they were taken.");
+    if (m_poison_on_free) {
+        for (std::size_t i = marker.block; i <= m_current; ++i) {
+            const std::size_t begin = i == marker.block ? marker.offset : 0;
+            const std::size_t end = i == m_current ? m_offset : m_blocks[i].offset;
+            poison(m_blocks[i].data + begin, end - begin);
+        }
+    }
+    m_current = marker.block;
+    m_offset = marker.offset;
+    m_stats.used = marker.used;
+    m_stats.allocations = marker.allocations;
+}
+
+void LinearArena::reset() {
+    rewind(Marker{});
+    if (m_blocks.size() <= 1) {
+        return;
+    }
+    std::size_t merged_size = 0;
+    for (const auto &block: m_blocks) {
+        merged_size += block.size;
+    }
+    release();
+    m_blocks.push_back(allocate_block(merged_size));
+}
+
+void LinearArena::release() {
+    for (const auto &block: m_blocks) {
+        delete[] block.data;
+    }
+    m_blocks.clear();
+    m_current = 0;
+    m_offset = 0;
+    m_stats.used = 0;
+    m_stats.allocations = 0;
+    m_stats.capacity = 0;
+}
+
+LinearArena::Block LinearArena::allocate_block(std::size_t size) {
+    ++m_stats.block_allocations;
+    m_stats.capacity += size;
+    return Block{new std::byte[size], size, 0};
+}
+
+void LinearArena::poison(std::byte *begin, std::size_t size) const {
+    std::memset(begin, std::to_integer<int>(POISON_BYTE), size);
+}
+
+LinearArena &frame_arena() {
+    static LinearArena arena(1024 * 1024);
+    return arena;
+}
+
+LinearArena &scratch_arena() {
+    thread_local LinearArena arena(256 * 1024);
+    return arena;
+}
+
+} // namespace engine::util::ds
@@ -0,0 +1,307 @@
+
+#include <glad/glad.h>
+#include <engine/core/BenchmarkController.hpp>
+#include <engine/graphics/GraphicsController.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/platform/PlatformController.hpp>
+#include <engine/util/ArgParser.hpp>
+#include <engine/util/Configuration.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+
+namespace engine::core {
+static constexpr std::string_view PERCENTILES[] = {"p50_ms", "p95_ms", "p99_ms"};
+
+template<typename T>
+static T catmull_rom(const T &p0, const T &p1, const T &p2, const T &p3, float t) {
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+/**
+ * @returns avg, min, max and the nearest-rank percentiles of `samples`.
+ */
+static nlohmann::json summarize(std::vector<float> samples) {
+    if (samples.empty()) {
+        return nlohmann::json::object();
+    }
+    std::ranges::sort(samples);
+    const auto percentile = [&](float p) {
+        const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<float>(samples.size())));
+        return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1];
+    };
+    double sum = 0.0;
+    for (float sample: samples) {
+        sum += sample;
+    }
+    return {
+            {"avg_ms", sum / static_cast<double>(samples.size())},
+            {"min_ms", samples.front()},
+            {"p50_ms", percentile(0.50f)},
+            {"p95_ms", percentile(0.95f)},
+            {"p99_ms", percentile(0.99f)},
+            {"max_ms", samples.back()},
+    };
+}
+
+void BenchmarkController::load_script(const std::filesystem::path &path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw util::EngineError(util::EngineError::Type::FileNotFound,
+                                std::format("Benchmark script {} doesn't exist.", path.string()));
+    }
+    try {
+        m_script = nlohmann::json::parse(file);
+        m_frames = m_script.at("frames").get<uint32_t>();
+        m_warmup_frames = m_script.value("warmup_frames", 60u);
+        m_fixed_dt = m_script.value("fixed_dt", 1.0f / 60.0f);
+        m_regression_threshold = m_script.value("regression_threshold", 0.05f);
+        m_loop_camera_path = m_script.value("loop_camera_path", false);
+        for (const auto &keyframe: m_script.value("camera_path", nlohmann::json::array())) {
+            const auto &position = keyframe.at("position");
+            m_camera_path.push_back(CameraKeyframe{
+                    .time = keyframe.at("time").get<float>(),
+                    .position = glm::vec3(position.at(0).get<float>(), position.at(1).get<float>(),
+                                          position.at(2).get<float>()),
+                    .yaw = keyframe.value("yaw", graphics::Camera::YAW),
+                    .pitch = keyframe.value("pitch", graphics::Camera::PITCH),
+            });
+        }
+    } catch (const nlohmann::json::exception &e) {
+        throw util::EngineError(util::EngineError::Type::ConfigurationError,
+                                std::format("Failed to parse the benchmark script {}: {}", path.string(), e.what()));
+    }
+    RG_GUARANTEE(m_frames > 0, "Benchmark script {} must run at least one frame.", path.string());
+    RG_GUARANTEE(std::ranges::is_sorted(m_camera_path, {}, &CameraKeyframe::time),
+                 "The camera_path keyframes of {} must be sorted by time.", path.string());
+    RG_GUARANTEE(m_camera_path.empty() || !m_script.contains("input"),
+                 "Benchmark script {} can either follow a camera_path or play back input, not both.", path.string());
+    m_script_path = path;
+
+    auto args = util::ArgParser::instance();
+    m_output_path = args->arg<std::string>("--benchmark-output", m_script.value("output", "benchmark.json")).value();
+    m_baseline_path = args->arg<std::string>("--benchmark-baseline", m_script.value("baseline", "")).value();
+    // Frames run as fast as they can, and are all drawn, unless the script configures it otherwise on purpose.
+    util::Configuration::config().merge_patch(nlohmann::json{
+            {"frame_pacing", {{"target_fps", 0}, {"vsync", "off"}}},
+            {"idle", {{"on_demand", false}, {"throttle", false}}},
+    });
+    if (m_script.contains("config")) {
+        util::Configuration::config().merge_patch(m_script["config"]);
+    }
+}
+
+void BenchmarkController::initialize() {
+    auto platform = get<platform::PlatformController>();
+    platform->set_fixed_timestep(m_fixed_dt);
+    if (m_script.contains("input")) {
+        const std::filesystem::path input = m_script["input"].get<std::string>();
+        platform->play_input_recording(platform::InputRecording::load(input));
+    }
+    // The CPU breakdown is read from the App phase scopes.
+    util::Profiler::instance()->set_enabled(true);
+    if (!platform->null_renderer()) {
+        m_renderer = reinterpret_cast<const char *>(CHECKED_GL_CALL(glGetString, GL_RENDERER));
+    } else {
+        m_renderer = "null";
+    }
+    m_frame_ms.reserve(m_frames);
+    util::logger("engine")->info("Benchmark {}: {} frames after {} warmup frames, fixed dt {}.",
+                                 m_script.value("name", m_script_path.stem().string()), m_frames, m_warmup_frames,
+                                 m_fixed_dt);
+}
+
+bool BenchmarkController::loop() {
+    const uint64_t now = util::Profiler::now_ns();
+    if (m_frame > m_warmup_frames) {
+        record_frame(static_cast<float>(now - m_frame_begin_ns) / 1e6f);
+    }
+    m_frame_begin_ns = now;
+    if (m_frame_ms.size() == m_frames) {
+        write_report();
+        return false;
+    }
+    ++m_frame;
+    return true;
+}
+
+void BenchmarkController::record_frame(float frame_ms) {
+    m_frame_ms.push_back(frame_ms);
+    if (const auto *frame = util::Profiler::instance()->last_frame()) {
+        for (const auto &zone: frame->zones) {
+            if (zone.depth == 0 && zone.name.starts_with("App::")) {
+                m_cpu_ms[std::string(zone.name)].push_back(static_cast<float>(zone.end_ns - zone.begin_ns) / 1e6f);
+            }
+        }
+    }
+    auto graphics = get<graphics::GraphicsController>();
+    for (const auto &pass: graphics->gpu_profiler()->passes()) {
+        m_gpu_ms[std::string(pass.name)].push_back(pass.last_ms);
+    }
+    const auto &stats = graphics->render_stats()->last_frame();
+    m_cpu_ms["submit"].push_back(stats.submit_ms);
+    m_cpu_ms["gpu_wait"].push_back(stats.gpu_wait_ms);
+    m_draw_calls += stats.draw_calls;
+    m_triangles += stats.triangles;
+    m_gl_calls += stats.gl_calls;
+}
+
+void BenchmarkController::begin_draw() {
+    if (m_camera_path.empty()) {
+        return;
+    }
+    const auto keyframe = sample_camera_path(m_path_time);
+    auto camera = get<graphics::GraphicsController>()->camera();
+    camera->Position = keyframe.position;
+    camera->set_orientation(keyframe.yaw, keyframe.pitch);
+    m_path_time += get<platform::PlatformController>()->dt();
+}
+
+CameraKeyframe BenchmarkController::sample_camera_path(float time) const {
+    const auto &path = m_camera_path;
+    if (m_loop_camera_path && path.back().time > path.front().time) {
+        time = path.front().time + std::fmod(time - path.front().time, path.back().time - path.front().time);
+    }
+    if (time <= path.front().time) {
+        return path.front();
+    }
+    if (time >= path.back().time) {
+        return path.back();
+    }
+    const auto next = std::ranges::upper_bound(path, time, {}, &CameraKeyframe::time);
+    const auto i = static_cast<std::size_t>(next - path.begin()) - 1;
+    const auto &k0 = path[i > 0 ? i - 1 : i];
+    const auto &k1 = path[i];
+    const auto &k2 = path[i + 1];
+    const auto &k3 = path[std::min(i + 2, path.size() - 1)];
+    const float t = (time - k1.time) / (k2.time - k1.time);
+    return CameraKeyframe{
+            .time = time,
+            .position = catmull_rom(k0.position, k1.position, k2.position, k3.position, t),
+            .yaw = catmull_rom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, t),
+            .pitch = catmull_rom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, t),
+    };
+}
+
+nlohmann::json BenchmarkController::make_report() const {
+    auto cpu = nlohmann::json::object();
+    for (const auto &[phase, samples]: m_cpu_ms) {
+        cpu[phase] = summarize(samples);
+    }
+    auto gpu = nlohmann::json::object();
+    for (const auto &[pass, samples]: m_gpu_ms) {
+        gpu[pass] = summarize(samples);
+    }
+    const double frames = std::max<double>(static_cast<double>(m_frame_ms.size()), 1.0);
+    // @formatter:off
+    #ifdef NDEBUG
+        constexpr std::string_view build = "release";
+    #else
+        constexpr std::string_view build = "debug";
+    #endif
+    // @formatter:on
+    return {
+            {"version", REPORT_VERSION},
+            {"name", m_script.value("name", m_script_path.stem().string())},
+            {"completed", m_frame_ms.size() == m_frames},
+            {"frames", m_frame_ms.size()},
+            {"warmup_frames", m_warmup_frames},
+            {"fixed_dt", m_fixed_dt},
+            {"frame_ms", summarize(m_frame_ms)},
+            {"cpu_ms", std::move(cpu)},
+            {"gpu_ms", std::move(gpu)},
+            {"render", {
+                    {"draw_calls", static_cast<double>(m_draw_calls) / frames},
+                    {"triangles", static_cast<double>(m_triangles) / frames},
+                    {"gl_calls", static_cast<double>(m_gl_calls) / frames},
+            }},
+            {"environment", {
+                    {"renderer", m_renderer},
+                    {"build", build},
+            }},
+            {"script", m_script},
+            {"config", util::Configuration::config()},
+    };
+}
+
+void BenchmarkController::write_report() {
+    if (m_report_written) {
+        return;
+    }
+    m_report_written = true;
+    const auto report = make_report();
+    std::ofstream file(m_output_path);
+    RG_GUARANTEE(file.is_open(), "Failed to open {} for writing.", m_output_path.string());
+    file << report.dump(4);
+    const auto &frame_ms = report["frame_ms"];
+    util::logger("engine")->info("Benchmark report written to {}: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms.",
+                                 m_output_path.string(), frame_ms.value("p50_ms", 0.0f),
+                                 frame_ms.value("p95_ms", 0.0f), frame_ms.value("p99_ms", 0.0f));
+    if (!m_baseline_path.empty()) {
+        compare_with_baseline(report);
+    }
+}
+
+void BenchmarkController::compare_with_baseline(const nlohmann::json &report) const {
+    std::ifstream file(m_baseline_path);
+    if (!file.is_open()) {
+        util::logger("engine")->warn("Benchmark baseline {} doesn't exist.", m_baseline_path.string());
+        return;
+    }
+    const auto baseline = nlohmann::json::parse(file, nullptr, false);
+    if (baseline.is_discarded() || baseline.value("version", 0u) != REPORT_VERSION) {
+        util::logger("engine")->warn("Benchmark baseline {} isn't a benchmark report.", m_baseline_path.string());
+        return;
+    }
+    if (baseline["script"] != report["script"]) {
+        util::logger("engine")->warn("Benchmark baseline {} was produced by a different script.",
+                                     m_baseline_path.string());
+    }
+    uint32_t regressions = 0;
+    const auto compare = [&](const std::string &name, const nlohmann::json &current, const nlohmann::json &before) {
+        for (auto key: PERCENTILES) {
+            const std::string percentile(key);
+            if (!current.contains(percentile) || !before.contains(percentile)) {
+                continue;
+            }
+            const float now = current[percentile].get<float>();
+            const float then = before[percentile].get<float>();
+            if (then > 0.0f && now > then * (1.0f + m_regression_threshold)) {
+                ++regressions;
+                util::logger("engine")->warn("Benchmark regression in {} {}: {:.3f} ms -> {:.3f} ms (+{:.1f}%).", name,
+                                             percentile, then, now, (now / then - 1.0f) * 100.0f);
+            }
+        }
+    };
+    compare("frame", report["frame_ms"], baseline.value("frame_ms", nlohmann::json::object()));
+    for (const char *section: {"cpu_ms", "gpu_ms"}) {
+        const auto before = baseline.value(section, nlohmann::json::object());
+        for (const auto &[name, current]: report[section].items()) {
+            if (before.contains(name)) {
+                compare(name, current, before[name]);
+            }
+        }
+    }
+    util::logger("engine")->info("Compared with the baseline {}: {} regression(s) over {:.0f}%.",
+                                 m_baseline_path.string(), regressions, m_regression_threshold * 100.0f);
+}
+
+void BenchmarkController::terminate() {
+    // The app was closed before the benchmark finished, report what was measured.
+    if (!m_report_written && !m_frame_ms.empty()) {
+        util::logger("engine")->warn("Benchmark stopped after {} of {} frames.", m_frame_ms.size(), m_frames);
+        write_report();
+    }
+    auto platform = get<platform::PlatformController>();
+    if (platform->is_playing_input() && !platform->input_playback_finished()) {
+        util::logger("engine")->warn("Benchmark ended before the input recording did.");
+    }
+}
+} // namespace engine::core
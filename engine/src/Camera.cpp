@@ -74,6 +74,12 @@ void Camera::zoom(float offset) {
     }
 }
 
+void Camera::set_orientation(float yaw, float pitch) {
+    Yaw = yaw;
+    Pitch = pitch;
+    update_camera_vectors();
+}
+
 // calculates the front vector from the Camera's (updated) Euler Angles
 void Camera::update_camera_vectors() {
     // calculate the new Front vector
@@ -0,0 +1,182 @@
+#include <imgui.h>
+#include <GLFW/glfw3.h>
+#include <engine/platform/FramePacer.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <string>
+#include <thread>
+
+namespace engine::platform {
+/**
+* @brief Weight of a new sample in the sleep estimate.
+*/
+static constexpr double SLEEP_SMOOTHING = 0.05;
+
+std::string_view FramePacer::to_string(VSync vsync) {
+    switch (vsync) {
+        case VSync::Off: return "off";
+        case VSync::On: return "on";
+        case VSync::Adaptive: return "adaptive";
+    }
+    return "unknown";
+}
+
+void FramePacer::configure(const nlohmann::json &config) {
+    const auto pacing = config.value("frame_pacing", nlohmann::json::object());
+    set_target_fps(pacing.value("target_fps", m_target_fps));
+    const std::string vsync = pacing.value("vsync", std::string(to_string(m_vsync)));
+    RG_GUARANTEE(vsync == "off" || vsync == "on" || vsync == "adaptive",
+                 "Unknown frame_pacing.vsync '{}', expected off, on or adaptive.", vsync);
+    m_vsync = vsync == "off" ? VSync::Off : vsync == "on" ? VSync::On : VSync::Adaptive;
+    m_spin_ms = pacing.value("spin_ms", m_spin_ms);
+    m_smoothing = pacing.value("smoothing", m_smoothing);
+    m_stats_window = std::max<std::size_t>(pacing.value("stats_window", m_stats_window), 1);
+    RG_GUARANTEE(m_spin_ms >= 0.0f, "frame_pacing.spin_ms can't be negative.");
+    RG_GUARANTEE(m_smoothing > 0.0f && m_smoothing <= 1.0f, "frame_pacing.smoothing must be in (0, 1].");
+    m_sleep_estimate_ms = m_spin_ms;
+    m_frame_ms.reserve(m_stats_window);
+}
+
+void FramePacer::apply_swap_interval() {
+    int interval = m_vsync == VSync::Off ? 0 : 1;
+    if (m_vsync == VSync::Adaptive) {
+        if (glfwExtensionSupported("GLX_EXT_swap_control_tear") || glfwExtensionSupported("WGL_EXT_swap_control_tear")) {
+            interval = -1;
+        } else {
+            util::logger("platform")->warn("Adaptive vsync isn't supported, using vsync on.");
+        }
+    }
+    glfwSwapInterval(interval);
+    m_swap_interval_applied = true;
+    util::logger("platform")->info("Frame pacing: vsync {}, {}.", to_string(m_vsync),
+                                   m_target_fps > 0.0f ? std::format("capped at {} fps", m_target_fps) : "uncapped");
+}
+
+void FramePacer::set_target_fps(float fps) {
+    RG_GUARANTEE(fps >= 0.0f, "The target frame rate can't be negative.");
+    m_target_fps = fps;
+    restart();
+}
+
+void FramePacer::set_vsync(VSync vsync) {
+    m_vsync = vsync;
+    // Headless and null renderer runs have no window to swap, or no context at all.
+    if (m_swap_interval_applied) {
+        apply_swap_interval();
+    }
+}
+
+float FramePacer::wait() {
+    m_stats.wait_ms = 0.0f;
+    if (m_target_fps <= 0.0f) {
+        return 0.0f;
+    }
+    const auto period_ns = static_cast<uint64_t>(1e9 / m_target_fps);
+    const uint64_t now = util::Profiler::now_ns();
+    if (m_next_frame_ns == 0) {
+        m_next_frame_ns = now + period_ns;
+        return 0.0f;
+    }
+    if (now < m_next_frame_ns) {
+        RG_PROFILE_SCOPE("FramePacer::wait");
+        sleep_until(m_next_frame_ns);
+        m_stats.wait_ms = static_cast<float>(util::Profiler::now_ns() - now) / 1e6f;
+    } else {
+        ++m_stats.missed_frames;
+    }
+    // The boundaries stay on the period grid, so the sleep error doesn't add up. A frame that overran the next boundary
+    // as well starts a new grid instead of letting the following frames run uncapped to catch up.
+    m_next_frame_ns += period_ns;
+    if (m_next_frame_ns <= now) {
+        m_next_frame_ns = now + period_ns;
+    }
+    return m_stats.wait_ms;
+}
+
+void FramePacer::sleep_until(uint64_t deadline_ns) {
+    uint64_t now = util::Profiler::now_ns();
+    while (now < deadline_ns && static_cast<double>(deadline_ns - now) / 1e6 > m_sleep_estimate_ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const uint64_t woke = util::Profiler::now_ns();
+        update_sleep_estimate(static_cast<double>(woke - now) / 1e6);
+        now = woke;
+    }
+    // Less than a sleep is left, the rest is spun. Yielding lets other threads run without giving up the time slice.
+    while (util::Profiler::now_ns() < deadline_ns) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::update_sleep_estimate(double slept_ms) {
+    if (m_sleeps++ == 0) {
+        m_sleep_mean_ms = slept_ms;
+        m_sleep_variance = 0.0;
+    } else {
+        const double delta = slept_ms - m_sleep_mean_ms;
+        m_sleep_mean_ms += SLEEP_SMOOTHING * delta;
+        m_sleep_variance = (1.0 - SLEEP_SMOOTHING) * (m_sleep_variance + SLEEP_SMOOTHING * delta * delta);
+    }
+    m_sleep_estimate_ms = std::max(m_spin_ms,
+                                   static_cast<float>(m_sleep_mean_ms + std::sqrt(m_sleep_variance)));
+}
+
+void FramePacer::end_frame(float dt) {
+    m_smoothed_dt = m_frame == 0 ? dt : m_smoothed_dt + m_smoothing * (dt - m_smoothed_dt);
+    const float frame_ms = dt * 1000.0f;
+    if (m_frame_ms.size() < m_stats_window) {
+        m_frame_ms.push_back(frame_ms);
+    } else {
+        m_frame_ms[m_frame % m_stats_window] = frame_ms;
+    }
+    ++m_frame;
+    update_stats();
+}
+
+void FramePacer::update_stats() {
+    // Two passes over at most stats_window floats, the running sums would lose precision over a long session.
+    double sum = 0.0;
+    float min_ms = m_frame_ms.front();
+    float max_ms = m_frame_ms.front();
+    for (const float ms: m_frame_ms) {
+        sum += ms;
+        min_ms = std::min(min_ms, ms);
+        max_ms = std::max(max_ms, ms);
+    }
+    const double mean = sum / static_cast<double>(m_frame_ms.size());
+    double squares = 0.0;
+    for (const float ms: m_frame_ms) {
+        squares += (ms - mean) * (ms - mean);
+    }
+    const double variance = squares / static_cast<double>(m_frame_ms.size());
+    m_stats.mean_ms = static_cast<float>(mean);
+    m_stats.variance_ms = static_cast<float>(variance);
+    m_stats.stddev_ms = static_cast<float>(std::sqrt(variance));
+    m_stats.min_ms = min_ms;
+    m_stats.max_ms = max_ms;
+}
+
+void FramePacer::draw_gui() {
+    ImGui::Begin("Frame pacing");
+    float target_fps = m_target_fps;
+    if (ImGui::DragFloat("Target FPS (0 uncapped)", &target_fps, 1.0f, 0.0f, 1000.0f, "%.0f")) {
+        set_target_fps(std::max(target_fps, 0.0f));
+    }
+    int vsync = static_cast<int>(m_vsync);
+    if (ImGui::Combo("VSync", &vsync, "off\0on\0adaptive\0")) {
+        set_vsync(static_cast<VSync>(vsync));
+    }
+    const auto &stats = m_stats;
+    ImGui::Text("Frame time: %.2f ms (stddev %.3f ms, variance %.3f ms^2)", stats.mean_ms, stats.stddev_ms,
+                stats.variance_ms);
+    ImGui::Text("Min %.2f ms, max %.2f ms over %zu frames", stats.min_ms, stats.max_ms, m_frame_ms.size());
+    ImGui::Text("Smoothed dt: %.2f ms, waited %.2f ms", m_smoothed_dt * 1000.0f, stats.wait_ms);
+    ImGui::Text("Sleep estimate: %.3f ms, missed boundaries: %llu", m_sleep_estimate_ms,
+                static_cast<unsigned long long>(stats.missed_frames));
+    ImGui::End();
+}
+} // namespace engine::platform
@@ -0,0 +1,70 @@
+#include <glad/glad.h>
+#include <engine/graphics/FramesInFlight.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Profiler.hpp>
+#include <string>
+#include <thread>
+
+namespace engine::graphics {
+static constexpr GLuint64 WAIT_TIMEOUT_NS = 100'000'000;
+
+void FramesInFlight::configure(const nlohmann::json &opengl_config) {
+    m_frames_in_flight = opengl_config.value("frames_in_flight", m_frames_in_flight);
+    RG_GUARANTEE(m_frames_in_flight <= MAX_FRAMES_IN_FLIGHT, "opengl.frames_in_flight can be at most {}.",
+                 MAX_FRAMES_IN_FLIGHT);
+    const std::string wait = opengl_config.value("frame_wait", "block");
+    RG_GUARANTEE(wait == "block" || wait == "poll", "Unknown opengl.frame_wait '{}', expected block or poll.", wait);
+    m_wait = wait == "block" ? FrameWait::Block : FrameWait::Poll;
+}
+
+float FramesInFlight::begin_frame() {
+    ++m_frame;
+    if (!is_enabled()) {
+        return 0.0f;
+    }
+    auto &fence = m_fences[m_frame % m_frames_in_flight];
+    if (!fence) {
+        return 0.0f;
+    }
+    const auto sync = static_cast<GLsync>(fence);
+    const uint64_t begin_ns = util::Profiler::now_ns();
+    GLenum status = CHECKED_GL_CALL(glClientWaitSync, sync, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        RG_PROFILE_SCOPE("FramesInFlight::wait");
+        if (m_wait == FrameWait::Block) {
+            do {
+                status = CHECKED_GL_CALL(glClientWaitSync, sync, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NS);
+            } while (status == GL_TIMEOUT_EXPIRED);
+        } else {
+            // The first poll flushes, so the fence is sure to reach the GPU.
+            status = CHECKED_GL_CALL(glClientWaitSync, sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            while (status == GL_TIMEOUT_EXPIRED) {
+                std::this_thread::yield();
+                status = CHECKED_GL_CALL(glClientWaitSync, sync, 0, 0);
+            }
+        }
+    }
+    RG_GUARANTEE(status != GL_WAIT_FAILED, "Waiting for the fence of frame {} failed.", m_frame - m_frames_in_flight);
+    CHECKED_GL_CALL(glDeleteSync, sync);
+    fence = nullptr;
+    m_completed_frame = m_frame - m_frames_in_flight;
+    return static_cast<float>(util::Profiler::now_ns() - begin_ns) / 1e6f;
+}
+
+void FramesInFlight::end_frame() {
+    if (!is_enabled()) {
+        return;
+    }
+    m_fences[m_frame % m_frames_in_flight] = CHECKED_GL_CALL(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void FramesInFlight::terminate() {
+    for (auto &fence: m_fences) {
+        if (fence) {
+            CHECKED_GL_CALL(glDeleteSync, static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+}
+} // namespace engine::graphics
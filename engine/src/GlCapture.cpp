@@ -0,0 +1,656 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <engine/graphics/GlCapture.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <cstring>
+#include <format>
+#include <string>
+
+namespace engine::graphics {
+static constexpr std::array<char, 8> CAPTURE_MAGIC{'R', 'G', 'G', 'L', 'C', 'A', 'P', '\0'};
+/**
+* @brief Size written for a null data pointer.
+*/
+static constexpr uint64_t NULL_DATA = ~0ull;
+/**
+* @brief Data is aligned in the file, so the replayer can pass pointers into the loaded file straight to the calls.
+*/
+static constexpr std::size_t DATA_ALIGNMENT = 8;
+static constexpr std::size_t FLUSH_SIZE = 1 << 20;
+
+// ARB_buffer_storage isn't part of the 3.3 core profile glad was generated for.
+using BufferStorageFn = void (APIENTRY *)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+static constexpr GLbitfield GL_DYNAMIC_STORAGE_BIT_ARB = 0x0100;
+
+using enum GlArg;
+// @formatter:off
+static constexpr std::array<GlFunctionInfo, static_cast<std::size_t>(GlFunction::FunctionCount)> FUNCTIONS{{
+    {"glActiveTexture",         None,            1, {Value}},
+    {"glAttachShader",          None,            2, {Program, Shader}},
+    {"glBindBuffer",            None,            2, {Value, Buffer}},
+    {"glBindTexture",           None,            2, {Value, Texture}},
+    {"glBindVertexArray",       None,            1, {VertexArray}},
+    {"glBufferData",            None,            4, {Value, Value, Data, Value}},
+    {"glClear",                 None,            1, {Value}},
+    {"glClearColor",            None,            4, {Float, Float, Float, Float}},
+    {"glCompileShader",         None,            1, {Shader}},
+    {"glCreateProgram",         Program,         0, {}},
+    {"glCreateShader",          Shader,          1, {Value}},
+    {"glDeleteBuffers",         None,            2, {Value, BufferNames}},
+    {"glDeleteProgram",         None,            1, {Program}},
+    {"glDeleteShader",          None,            1, {Shader}},
+    {"glDeleteTextures",        None,            2, {Value, TextureNames}},
+    {"glDeleteVertexArrays",    None,            2, {Value, VertexArrayNames}},
+    {"glDepthFunc",             None,            1, {Value}},
+    {"glDisable",               None,            1, {Value}},
+    {"glDrawArrays",            None,            3, {Value, Value, Value}},
+    {"glDrawElements",          None,            4, {Value, Value, Value, Value}},
+    {"glEnable",                None,            1, {Value}},
+    {"glEnableVertexAttribArray", None,          1, {Value}},
+    {"glGenBuffers",            None,            2, {Value, BufferNames}},
+    {"glGenTextures",           None,            2, {Value, TextureNames}},
+    {"glGenVertexArrays",       None,            2, {Value, VertexArrayNames}},
+    {"glGenerateMipmap",        None,            1, {Value}},
+    {"glGetUniformLocation",    UniformLocation, 2, {Program, String}},
+    {"glLinkProgram",           None,            1, {Program}},
+    {"glShaderSource",          None,            4, {Shader, Value, ShaderSources, Value}},
+    {"glTexImage2D",            None,            9, {Value, Value, Value, Value, Value, Value, Value, Value, Data}},
+    {"glTexParameteri",         None,            3, {Value, Value, Value}},
+    {"glUniform1f",             None,            2, {UniformLocation, Float}},
+    {"glUniform1i",             None,            2, {UniformLocation, Value}},
+    {"glUniform2fv",            None,            3, {UniformLocation, Value, Data}},
+    {"glUniform3fv",            None,            3, {UniformLocation, Value, Data}},
+    {"glUniform4fv",            None,            3, {UniformLocation, Value, Data}},
+    {"glUniformMatrix2fv",      None,            4, {UniformLocation, Value, Value, Data}},
+    {"glUniformMatrix3fv",      None,            4, {UniformLocation, Value, Value, Data}},
+    {"glUniformMatrix4fv",      None,            4, {UniformLocation, Value, Value, Data}},
+    {"glUseProgram",            None,            1, {Program}},
+    {"glVertexAttribPointer",   None,            6, {Value, Value, Value, Value, Value, Value}},
+    {"glViewport",              None,            4, {Value, Value, Value, Value}},
+    {"glBindBufferRange",       None,            5, {Value, Value, Buffer, Value, Value}},
+    {"glBufferStorage",         None,            4, {Value, Value, Data, Value}},
+    {"glClientWaitSync",        Value,           3, {Sync, Value, Value}},
+    {"glDeleteSync",            None,            1, {Sync}},
+    {"glFenceSync",             Sync,            2, {Value, Value}},
+    {"glGetUniformBlockIndex",  UniformBlockIndex, 2, {Program, String}},
+    {"glMapBufferRange",        Value,           4, {Value, Value, Value, Value}},
+    {"glUniformBlockBinding",   None,            3, {Program, UniformBlockIndex, Value}},
+    {"glUnmapBuffer",           Value,           1, {Value}},
+    {"glBufferSubData",         None,            4, {Value, Value, Value, Data}},
+}};
+// @formatter:on
+
+const GlFunctionInfo &gl_function_info(GlFunction function) {
+    return FUNCTIONS[static_cast<std::size_t>(function)];
+}
+
+static std::size_t pixel_size(uint64_t format, uint64_t type) {
+    std::size_t components = 0;
+    switch (format) {
+        case GL_RED:
+        case GL_DEPTH_COMPONENT: components = 1;
+            break;
+        case GL_RG: components = 2;
+            break;
+        case GL_RGB:
+        case GL_BGR: components = 3;
+            break;
+        case GL_RGBA:
+        case GL_BGRA: components = 4;
+            break;
+        default: RG_SHOULD_NOT_REACH_HERE("GlCapture: unsupported texture format {:#x}", format);
+    }
+    switch (type) {
+        case GL_UNSIGNED_BYTE:
+        case GL_BYTE: return components;
+        case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
+        case GL_HALF_FLOAT: return components * 2;
+        case GL_UNSIGNED_INT:
+        case GL_INT:
+        case GL_FLOAT: return components * 4;
+        default: RG_SHOULD_NOT_REACH_HERE("GlCapture: unsupported texture type {:#x}", type);
+    }
+}
+
+std::size_t gl_data_size(GlFunction function, std::size_t arg_index, std::span<const uint64_t> args) {
+    switch (function) {
+        case GlFunction::BufferData:
+        case GlFunction::BufferStorage: return args[1];
+        case GlFunction::BufferSubData: return args[2];
+        case GlFunction::TexImage2D: {
+            // Rows are aligned to GL_UNPACK_ALIGNMENT (4, the engine doesn't change it), except the last one.
+            const std::size_t width = args[3], height = args[4];
+            const std::size_t row = width * pixel_size(args[6], args[7]);
+            return height == 0 ? 0 : (row + 3) / 4 * 4 * (height - 1) + row;
+        }
+        case GlFunction::Uniform2fv: return args[1] * 2 * sizeof(float);
+        case GlFunction::Uniform3fv: return args[1] * 3 * sizeof(float);
+        case GlFunction::Uniform4fv: return args[1] * 4 * sizeof(float);
+        case GlFunction::UniformMatrix2fv: return args[1] * 4 * sizeof(float);
+        case GlFunction::UniformMatrix3fv: return args[1] * 9 * sizeof(float);
+        case GlFunction::UniformMatrix4fv: return args[1] * 16 * sizeof(float);
+        default: RG_SHOULD_NOT_REACH_HERE("{} has no data argument {}", gl_function_info(function).name, arg_index);
+    }
+}
+
+void GlCapture::start(const std::filesystem::path &path, uint32_t frames) {
+    stop();
+    m_file.open(path, std::ios::binary);
+    if (!m_file.is_open()) {
+        throw util::EngineError(util::EngineError::Type::FileNotFound,
+                                std::format("Failed to open {} to write the GL capture.", path.string()));
+    }
+    // The glad function pointers identify the calls, they are only valid once OpenGL is loaded.
+    m_functions = {
+            {reinterpret_cast<const void *>(glActiveTexture), GlFunction::ActiveTexture},
+            {reinterpret_cast<const void *>(glAttachShader), GlFunction::AttachShader},
+            {reinterpret_cast<const void *>(glBindBuffer), GlFunction::BindBuffer},
+            {reinterpret_cast<const void *>(glBindTexture), GlFunction::BindTexture},
+            {reinterpret_cast<const void *>(glBindVertexArray), GlFunction::BindVertexArray},
+            {reinterpret_cast<const void *>(glBufferData), GlFunction::BufferData},
+            {reinterpret_cast<const void *>(glClear), GlFunction::Clear},
+            {reinterpret_cast<const void *>(glClearColor), GlFunction::ClearColor},
+            {reinterpret_cast<const void *>(glCompileShader), GlFunction::CompileShader},
+            {reinterpret_cast<const void *>(glCreateProgram), GlFunction::CreateProgram},
+            {reinterpret_cast<const void *>(glCreateShader), GlFunction::CreateShader},
+            {reinterpret_cast<const void *>(glDeleteBuffers), GlFunction::DeleteBuffers},
+            {reinterpret_cast<const void *>(glDeleteProgram), GlFunction::DeleteProgram},
+            {reinterpret_cast<const void *>(glDeleteShader), GlFunction::DeleteShader},
+            {reinterpret_cast<const void *>(glDeleteTextures), GlFunction::DeleteTextures},
+            {reinterpret_cast<const void *>(glDeleteVertexArrays), GlFunction::DeleteVertexArrays},
+            {reinterpret_cast<const void *>(glDepthFunc), GlFunction::DepthFunc},
+            {reinterpret_cast<const void *>(glDisable), GlFunction::Disable},
+            {reinterpret_cast<const void *>(glDrawArrays), GlFunction::DrawArrays},
+            {reinterpret_cast<const void *>(glDrawElements), GlFunction::DrawElements},
+            {reinterpret_cast<const void *>(glEnable), GlFunction::Enable},
+            {reinterpret_cast<const void *>(glEnableVertexAttribArray), GlFunction::EnableVertexAttribArray},
+            {reinterpret_cast<const void *>(glGenBuffers), GlFunction::GenBuffers},
+            {reinterpret_cast<const void *>(glGenTextures), GlFunction::GenTextures},
+            {reinterpret_cast<const void *>(glGenVertexArrays), GlFunction::GenVertexArrays},
+            {reinterpret_cast<const void *>(glGenerateMipmap), GlFunction::GenerateMipmap},
+            {reinterpret_cast<const void *>(glGetUniformLocation), GlFunction::GetUniformLocation},
+            {reinterpret_cast<const void *>(glLinkProgram), GlFunction::LinkProgram},
+            {reinterpret_cast<const void *>(glShaderSource), GlFunction::ShaderSource},
+            {reinterpret_cast<const void *>(glTexImage2D), GlFunction::TexImage2D},
+            {reinterpret_cast<const void *>(glTexParameteri), GlFunction::TexParameteri},
+            {reinterpret_cast<const void *>(glUniform1f), GlFunction::Uniform1f},
+            {reinterpret_cast<const void *>(glUniform1i), GlFunction::Uniform1i},
+            {reinterpret_cast<const void *>(glUniform2fv), GlFunction::Uniform2fv},
+            {reinterpret_cast<const void *>(glUniform3fv), GlFunction::Uniform3fv},
+            {reinterpret_cast<const void *>(glUniform4fv), GlFunction::Uniform4fv},
+            {reinterpret_cast<const void *>(glUniformMatrix2fv), GlFunction::UniformMatrix2fv},
+            {reinterpret_cast<const void *>(glUniformMatrix3fv), GlFunction::UniformMatrix3fv},
+            {reinterpret_cast<const void *>(glUniformMatrix4fv), GlFunction::UniformMatrix4fv},
+            {reinterpret_cast<const void *>(glUseProgram), GlFunction::UseProgram},
+            {reinterpret_cast<const void *>(glVertexAttribPointer), GlFunction::VertexAttribPointer},
+            {reinterpret_cast<const void *>(glViewport), GlFunction::Viewport},
+            {reinterpret_cast<const void *>(glBindBufferRange), GlFunction::BindBufferRange},
+            {reinterpret_cast<const void *>(glClientWaitSync), GlFunction::ClientWaitSync},
+            {reinterpret_cast<const void *>(glDeleteSync), GlFunction::DeleteSync},
+            {reinterpret_cast<const void *>(glFenceSync), GlFunction::FenceSync},
+            {reinterpret_cast<const void *>(glGetUniformBlockIndex), GlFunction::GetUniformBlockIndex},
+            {reinterpret_cast<const void *>(glMapBufferRange), GlFunction::MapBufferRange},
+            {reinterpret_cast<const void *>(glUniformBlockBinding), GlFunction::UniformBlockBinding},
+            {reinterpret_cast<const void *>(glUnmapBuffer), GlFunction::UnmapBuffer},
+            {reinterpret_cast<const void *>(glBufferSubData), GlFunction::BufferSubData},
+    };
+    RG_GUARANTEE(m_functions.size() == FUNCTIONS.size() - 1, "GlCapture: OpenGL is not loaded.");
+    // StreamingBuffer loads glBufferStorage through GLFW, the context hands out the same pointer again.
+    if (const GLFWglproc buffer_storage = glfwGetProcAddress("glBufferStorage")) {
+        m_functions.emplace(reinterpret_cast<const void *>(buffer_storage), GlFunction::BufferStorage);
+    }
+    m_skipped_functions.clear();
+    m_buffer.clear();
+    m_buffer.reserve(FLUSH_SIZE);
+    m_offset = 0;
+    m_frames_left = frames;
+    m_frames_captured = 0;
+    m_skipped_calls = 0;
+    m_in_setup = true;
+    write_bytes(CAPTURE_MAGIC.data(), CAPTURE_MAGIC.size());
+    write(VERSION);
+    write(static_cast<uint32_t>(GlFunction::FunctionCount));
+    g_gl_capture = this;
+    util::logger("graphics")->info("Capturing {} frames of GL calls to {}.", frames, path.string());
+}
+
+void GlCapture::stop() {
+    if (!m_file.is_open()) {
+        return;
+    }
+    flush();
+    m_file.close();
+    if (g_gl_capture == this) {
+        g_gl_capture = nullptr;
+    }
+    util::logger("graphics")->info("GL capture finished: {} frames, {} bytes.", m_frames_captured, m_offset);
+    if (m_skipped_calls > 0) {
+        util::logger("graphics")->warn("GL capture skipped {} calls to {} uncaptured functions.", m_skipped_calls,
+                                       m_skipped_functions.size());
+    }
+}
+
+void GlCapture::begin_frame() {
+    if (m_file.is_open() && m_in_setup) {
+        write(Record::SetupEnd);
+        m_in_setup = false;
+    }
+}
+
+void GlCapture::end_frame() {
+    if (!m_file.is_open() || m_in_setup) {
+        return;
+    }
+    write(Record::FrameEnd);
+    ++m_frames_captured;
+    flush();
+    if (--m_frames_left == 0) {
+        stop();
+    }
+}
+
+void GlCapture::record(std::source_location location, const void *function, std::span<const uint64_t> args,
+                       uint64_t result) {
+    auto it = m_functions.find(function);
+    if (it == m_functions.end()) {
+        ++m_skipped_calls;
+        if (m_skipped_functions.insert(function).second) {
+            util::logger("graphics")->warn("GlCapture: the GL call at {}:{} isn't in GlFunction, it's not captured.",
+                                           location.file_name(), location.line());
+        }
+        return;
+    }
+    const GlFunction id = it->second;
+    const GlFunctionInfo &info = gl_function_info(id);
+    write(Record::Call);
+    write(id);
+    for (std::size_t i = 0; i < info.arg_count; ++i) {
+        const auto *pointer = reinterpret_cast<const char *>(static_cast<uintptr_t>(args[i]));
+        switch (info.args[i]) {
+            case Data:
+            case String: {
+                const uint64_t size = !pointer
+                                      ? NULL_DATA
+                                      : info.args[i] == String
+                                        ? std::strlen(pointer) + 1
+                                        : gl_data_size(id, i, args);
+                write_data(pointer, size);
+                break;
+            }
+            case ShaderSources: {
+                const auto *strings = reinterpret_cast<const char *const *>(pointer);
+                const auto *lengths = reinterpret_cast<const GLint *>(static_cast<uintptr_t>(args[3]));
+                std::string source;
+                for (uint64_t k = 0; k < args[1]; ++k) {
+                    if (lengths && lengths[k] >= 0) {
+                        source.append(strings[k], lengths[k]);
+                    } else {
+                        source.append(strings[k]);
+                    }
+                }
+                write_data(source.c_str(), source.size() + 1);
+                break;
+            }
+            case TextureNames:
+            case BufferNames:
+            case VertexArrayNames: write_data(pointer, args[0] * sizeof(GLuint));
+                break;
+            default: write(args[i]);
+        }
+    }
+    if (info.result != None) {
+        write(result);
+    }
+    if (m_buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+}
+
+void GlCapture::record_buffer_data(uint32_t buffer, std::size_t offset, const void *data, std::size_t size) {
+    const auto location = std::source_location::current();
+    const std::array<uint64_t, 2> bind{GL_COPY_WRITE_BUFFER, buffer};
+    record(location, reinterpret_cast<const void *>(glBindBuffer), bind, 0);
+    const std::array<uint64_t, 4> sub_data{GL_COPY_WRITE_BUFFER, offset, size, encode_arg(data)};
+    record(location, reinterpret_cast<const void *>(glBufferSubData), sub_data, 0);
+    const std::array<uint64_t, 2> unbind{GL_COPY_WRITE_BUFFER, 0};
+    record(location, reinterpret_cast<const void *>(glBindBuffer), unbind, 0);
+}
+
+void GlCapture::write_bytes(const void *data, std::size_t size) {
+    const auto *bytes = static_cast<const char *>(data);
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    m_offset += size;
+}
+
+void GlCapture::write_data(const void *data, uint64_t size) {
+    write(size);
+    if (size == NULL_DATA) {
+        return;
+    }
+    static constexpr std::array<char, DATA_ALIGNMENT> padding{};
+    write_bytes(padding.data(), (DATA_ALIGNMENT - m_offset % DATA_ALIGNMENT) % DATA_ALIGNMENT);
+    write_bytes(data, size);
+}
+
+void GlCapture::flush() {
+    m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+GlReplayer::GlReplayer(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw util::EngineError(util::EngineError::Type::FileNotFound,
+                                std::format("GL capture {} doesn't exist.", path.string()));
+    }
+    m_data.resize(std::filesystem::file_size(path));
+    file.read(m_data.data(), static_cast<std::streamsize>(m_data.size()));
+
+    std::size_t offset = 0;
+    const auto read_bytes = [&](void *out, std::size_t size) {
+        if (offset + size > m_data.size()) {
+            return false;
+        }
+        std::memcpy(out, m_data.data() + offset, size);
+        offset += size;
+        return true;
+    };
+    // Returns a pointer into the loaded file, or 0 for a null pointer.
+    const auto read_data = [&](uint64_t &out) {
+        uint64_t size = 0;
+        if (!read_bytes(&size, sizeof(size))) {
+            return false;
+        }
+        if (size == NULL_DATA) {
+            out = 0;
+            return true;
+        }
+        offset += (DATA_ALIGNMENT - offset % DATA_ALIGNMENT) % DATA_ALIGNMENT;
+        if (offset + size > m_data.size()) {
+            return false;
+        }
+        out = reinterpret_cast<uintptr_t>(m_data.data() + offset);
+        offset += size;
+        return true;
+    };
+
+    std::array<char, CAPTURE_MAGIC.size()> magic{};
+    uint32_t version = 0, function_count = 0;
+    if (!read_bytes(magic.data(), magic.size()) || magic != CAPTURE_MAGIC || !read_bytes(&version, sizeof(version)) ||
+        !read_bytes(&function_count, sizeof(function_count))) {
+        throw util::EngineError(util::EngineError::Type::AssetLoadingError,
+                                std::format("{} is not a GL capture.", path.string()));
+    }
+    if (version != GlCapture::VERSION || function_count != static_cast<uint32_t>(GlFunction::FunctionCount)) {
+        throw util::EngineError(util::EngineError::Type::AssetLoadingError,
+                                std::format("GL capture {} has version {}, expected {}.", path.string(), version,
+                                            GlCapture::VERSION));
+    }
+
+    std::size_t frame_begin = 0;
+    bool complete = true;
+    while (offset < m_data.size() && complete) {
+        GlCapture::Record record{};
+        read_bytes(&record, sizeof(record));
+        switch (record) {
+            case GlCapture::Record::SetupEnd: m_setup = {0, m_calls.size()};
+                frame_begin = m_calls.size();
+                break;
+            case GlCapture::Record::FrameEnd: m_frames.push_back({frame_begin, m_calls.size()});
+                frame_begin = m_calls.size();
+                break;
+            case GlCapture::Record::Call: {
+                Call call{};
+                complete = read_bytes(&call.function, sizeof(call.function)) &&
+                           call.function < GlFunction::FunctionCount;
+                const GlFunctionInfo &info = gl_function_info(complete ? call.function : GlFunction::Clear);
+                for (std::size_t i = 0; complete && i < info.arg_count; ++i) {
+                    switch (info.args[i]) {
+                        case Data:
+                        case String:
+                        case ShaderSources:
+                        case TextureNames:
+                        case BufferNames:
+                        case VertexArrayNames: complete = read_data(call.args[i]);
+                            break;
+                        default: complete = read_bytes(&call.args[i], sizeof(uint64_t));
+                    }
+                }
+                if (complete && info.result != None) {
+                    complete = read_bytes(&call.result, sizeof(call.result));
+                }
+                if (complete) {
+                    m_calls.push_back(call);
+                }
+                break;
+            }
+            default: complete = false;
+        }
+    }
+    if (!complete) {
+        // The app most likely exited in the middle of the capture, the frames recorded until then are still usable.
+        util::logger("graphics")->warn("GL capture {} is truncated, replaying the {} complete frames.", path.string(),
+                                       m_frames.size());
+    }
+}
+
+void GlReplayer::replay_setup() {
+    for (std::size_t i = m_setup.begin; i < m_setup.end; ++i) {
+        replay(m_calls[i]);
+    }
+    glFinish();
+}
+
+GlReplayFrameTiming GlReplayer::replay_frame(std::size_t index) {
+    const Range frame = m_frames[index];
+    const uint64_t begin_ns = util::Profiler::now_ns();
+    for (std::size_t i = frame.begin; i < frame.end; ++i) {
+        replay(m_calls[i]);
+    }
+    const uint64_t submitted_ns = util::Profiler::now_ns();
+    glFinish();
+    const uint64_t finished_ns = util::Profiler::now_ns();
+    return GlReplayFrameTiming{
+            .submit_ms = static_cast<float>(submitted_ns - begin_ns) / 1e6f,
+            .gpu_wait_ms = static_cast<float>(finished_ns - submitted_ns) / 1e6f,
+    };
+}
+
+uint32_t GlReplayer::map_name(const std::unordered_map<uint32_t, uint32_t> &names, uint64_t name) const {
+    auto it = names.find(static_cast<uint32_t>(name));
+    return it == names.end() ? 0 : it->second;
+}
+
+void GlReplayer::replay(const Call &call) {
+    const auto &a = call.args;
+    const auto i32 = [&](std::size_t k) {
+        return static_cast<GLint>(a[k]);
+    };
+    const auto u32 = [&](std::size_t k) {
+        return static_cast<GLuint>(a[k]);
+    };
+    const auto f32 = [&](std::size_t k) {
+        return std::bit_cast<float>(static_cast<uint32_t>(a[k]));
+    };
+    const auto ptr = [&](std::size_t k) {
+        return reinterpret_cast<const void *>(static_cast<uintptr_t>(a[k]));
+    };
+    const auto floats = [&](std::size_t k) {
+        return static_cast<const GLfloat *>(ptr(k));
+    };
+    const auto location = [&](std::size_t k) {
+        auto it = m_uniform_locations.find(static_cast<uint64_t>(m_current_program) << 32 | u32(k));
+        return it == m_uniform_locations.end() ? -1 : it->second;
+    };
+    const auto block_index = [&](std::size_t program, std::size_t k) {
+        auto it = m_uniform_block_indices.find(a[program] << 32 | u32(k));
+        return it == m_uniform_block_indices.end() ? GL_INVALID_INDEX : it->second;
+    };
+    const auto sync = [&](std::size_t k) {
+        auto it = m_syncs.find(a[k]);
+        return it == m_syncs.end() ? nullptr : static_cast<GLsync>(it->second);
+    };
+    // Names are stored unaligned, copy them out.
+    const auto captured_names = [&]() -> std::span<const char> {
+        return {static_cast<const char *>(ptr(1)), a[0] * sizeof(GLuint)};
+    };
+    const auto captured_name = [&](std::size_t k) {
+        GLuint name = 0;
+        std::memcpy(&name, captured_names().data() + k * sizeof(GLuint), sizeof(GLuint));
+        return name;
+    };
+    const auto gen_names = [&](auto gen, std::unordered_map<uint32_t, uint32_t> &names) {
+        m_names_scratch.resize(a[0]);
+        gen(i32(0), m_names_scratch.data());
+        for (std::size_t k = 0; k < a[0]; ++k) {
+            names[captured_name(k)] = m_names_scratch[k];
+        }
+    };
+    const auto delete_names = [&](auto del, std::unordered_map<uint32_t, uint32_t> &names) {
+        m_names_scratch.resize(a[0]);
+        for (std::size_t k = 0; k < a[0]; ++k) {
+            m_names_scratch[k] = map_name(names, captured_name(k));
+            names.erase(captured_name(k));
+        }
+        del(i32(0), m_names_scratch.data());
+    };
+
+    switch (call.function) {
+        case GlFunction::ActiveTexture: glActiveTexture(u32(0));
+            break;
+        case GlFunction::AttachShader: glAttachShader(map_name(m_programs, a[0]), map_name(m_shaders, a[1]));
+            break;
+        case GlFunction::BindBuffer: glBindBuffer(u32(0), map_name(m_buffers, a[1]));
+            break;
+        case GlFunction::BindTexture: glBindTexture(u32(0), map_name(m_textures, a[1]));
+            break;
+        case GlFunction::BindVertexArray: glBindVertexArray(map_name(m_vertex_arrays, a[0]));
+            break;
+        case GlFunction::BufferData: glBufferData(u32(0), static_cast<GLsizeiptr>(a[1]), ptr(2), u32(3));
+            break;
+        case GlFunction::Clear: glClear(u32(0));
+            break;
+        case GlFunction::ClearColor: glClearColor(f32(0), f32(1), f32(2), f32(3));
+            break;
+        case GlFunction::CompileShader: glCompileShader(map_name(m_shaders, a[0]));
+            break;
+        case GlFunction::CreateProgram: m_programs[static_cast<uint32_t>(call.result)] = glCreateProgram();
+            break;
+        case GlFunction::CreateShader: m_shaders[static_cast<uint32_t>(call.result)] = glCreateShader(u32(0));
+            break;
+        case GlFunction::DeleteBuffers: delete_names(glDeleteBuffers, m_buffers);
+            break;
+        case GlFunction::DeleteProgram: glDeleteProgram(map_name(m_programs, a[0]));
+            m_programs.erase(u32(0));
+            break;
+        case GlFunction::DeleteShader: glDeleteShader(map_name(m_shaders, a[0]));
+            m_shaders.erase(u32(0));
+            break;
+        case GlFunction::DeleteTextures: delete_names(glDeleteTextures, m_textures);
+            break;
+        case GlFunction::DeleteVertexArrays: delete_names(glDeleteVertexArrays, m_vertex_arrays);
+            break;
+        case GlFunction::DepthFunc: glDepthFunc(u32(0));
+            break;
+        case GlFunction::Disable: glDisable(u32(0));
+            break;
+        case GlFunction::DrawArrays: glDrawArrays(u32(0), i32(1), i32(2));
+            break;
+        case GlFunction::DrawElements: glDrawElements(u32(0), i32(1), u32(2), ptr(3));
+            break;
+        case GlFunction::Enable: glEnable(u32(0));
+            break;
+        case GlFunction::EnableVertexAttribArray: glEnableVertexAttribArray(u32(0));
+            break;
+        case GlFunction::GenBuffers: gen_names(glGenBuffers, m_buffers);
+            break;
+        case GlFunction::GenTextures: gen_names(glGenTextures, m_textures);
+            break;
+        case GlFunction::GenVertexArrays: gen_names(glGenVertexArrays, m_vertex_arrays);
+            break;
+        case GlFunction::GenerateMipmap: glGenerateMipmap(u32(0));
+            break;
+        case GlFunction::GetUniformLocation: {
+            const GLint replayed = glGetUniformLocation(map_name(m_programs, a[0]), static_cast<const GLchar *>(ptr(1)));
+            m_uniform_locations[a[0] << 32 | static_cast<uint32_t>(call.result)] = replayed;
+            break;
+        }
+        case GlFunction::LinkProgram: glLinkProgram(map_name(m_programs, a[0]));
+            break;
+        case GlFunction::ShaderSource: {
+            const auto *source = static_cast<const GLchar *>(ptr(2));
+            glShaderSource(map_name(m_shaders, a[0]), 1, &source, nullptr);
+            break;
+        }
+        case GlFunction::TexImage2D: glTexImage2D(u32(0), i32(1), i32(2), i32(3), i32(4), i32(5), u32(6), u32(7), ptr(8));
+            break;
+        case GlFunction::TexParameteri: glTexParameteri(u32(0), u32(1), i32(2));
+            break;
+        case GlFunction::Uniform1f: glUniform1f(location(0), f32(1));
+            break;
+        case GlFunction::Uniform1i: glUniform1i(location(0), i32(1));
+            break;
+        case GlFunction::Uniform2fv: glUniform2fv(location(0), i32(1), floats(2));
+            break;
+        case GlFunction::Uniform3fv: glUniform3fv(location(0), i32(1), floats(2));
+            break;
+        case GlFunction::Uniform4fv: glUniform4fv(location(0), i32(1), floats(2));
+            break;
+        case GlFunction::UniformMatrix2fv: glUniformMatrix2fv(location(0), i32(1), static_cast<GLboolean>(a[2]), floats(3));
+            break;
+        case GlFunction::UniformMatrix3fv: glUniformMatrix3fv(location(0), i32(1), static_cast<GLboolean>(a[2]), floats(3));
+            break;
+        case GlFunction::UniformMatrix4fv: glUniformMatrix4fv(location(0), i32(1), static_cast<GLboolean>(a[2]), floats(3));
+            break;
+        case GlFunction::UseProgram: m_current_program = u32(0);
+            glUseProgram(map_name(m_programs, a[0]));
+            break;
+        case GlFunction::VertexAttribPointer:
+            glVertexAttribPointer(u32(0), i32(1), u32(2), static_cast<GLboolean>(a[3]), i32(4), ptr(5));
+            break;
+        case GlFunction::Viewport: glViewport(i32(0), i32(1), i32(2), i32(3));
+            break;
+        case GlFunction::BindBufferRange:
+            glBindBufferRange(u32(0), u32(1), map_name(m_buffers, a[2]), static_cast<GLintptr>(a[3]),
+                              static_cast<GLsizeiptr>(a[4]));
+            break;
+        case GlFunction::BufferStorage: {
+            const auto buffer_storage = reinterpret_cast<BufferStorageFn>(glfwGetProcAddress("glBufferStorage"));
+            RG_GUARANTEE(buffer_storage, "The capture uses glBufferStorage, the replay context doesn't support it.");
+            // The StreamingBuffer's writes through the mapping are replayed as glBufferSubData, which an immutable
+            // buffer only allows with the dynamic storage bit.
+            buffer_storage(u32(0), static_cast<GLsizeiptr>(a[1]), ptr(2), u32(3) | GL_DYNAMIC_STORAGE_BIT_ARB);
+            break;
+        }
+        case GlFunction::ClientWaitSync: glClientWaitSync(sync(0), u32(1), a[2]);
+            break;
+        case GlFunction::DeleteSync: glDeleteSync(sync(0));
+            m_syncs.erase(a[0]);
+            break;
+        case GlFunction::FenceSync: m_syncs[call.result] = glFenceSync(u32(0), u32(1));
+            break;
+        case GlFunction::GetUniformBlockIndex: {
+            const GLuint replayed = glGetUniformBlockIndex(map_name(m_programs, a[0]),
+                                                           static_cast<const GLchar *>(ptr(1)));
+            m_uniform_block_indices[a[0] << 32 | static_cast<uint32_t>(call.result)] = replayed;
+            break;
+        }
+        case GlFunction::MapBufferRange:
+            // The data written through the mapping follows as a BufferSubData, see GlCapture::record_buffer_data.
+            glMapBufferRange(u32(0), static_cast<GLintptr>(a[1]), static_cast<GLsizeiptr>(a[2]), u32(3));
+            break;
+        case GlFunction::UniformBlockBinding:
+            glUniformBlockBinding(map_name(m_programs, a[0]), block_index(0, 1), u32(2));
+            break;
+        case GlFunction::UnmapBuffer: glUnmapBuffer(u32(0));
+            break;
+        case GlFunction::BufferSubData:
+            glBufferSubData(u32(0), static_cast<GLintptr>(a[1]), static_cast<GLsizeiptr>(a[2]), ptr(3));
+            break;
+        default: RG_SHOULD_NOT_REACH_HERE("Unhandled GlFunction {}", static_cast<int>(call.function));
+    }
+}
+} // namespace engine::graphics
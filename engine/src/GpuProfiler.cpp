@@ -0,0 +1,176 @@
+#include <glad/glad.h>
+#include <imgui.h>
+#include <engine/graphics/GpuProfiler.hpp>
+#include <engine/graphics/GpuResourceTracker.hpp>
+#include <engine/graphics/GraphicsController.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <algorithm>
+
+namespace engine::graphics {
+void GpuProfiler::initialize() {
+    GLint counter_bits = 0;
+    if (glQueryCounter && glGetQueryObjectui64v) {
+        CHECKED_GL_CALL(glGetQueryiv, GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counter_bits);
+    }
+    m_supported = counter_bits > 0;
+    if (!m_supported) {
+        util::logger("graphics")->warn("GPU timer queries are not supported, GPU profiling is disabled.");
+        return;
+    }
+    m_profiler_lane = util::Profiler::instance()->register_lane("GPU");
+    calibrate();
+}
+
+void GpuProfiler::terminate() {
+    for (auto &frame: m_frames) {
+        if (!frame.queries.empty()) {
+            CHECKED_GL_CALL(glDeleteQueries, static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            for (const uint32_t query: frame.queries) {
+                GpuResourceTracker::instance()->on_delete(GlObjectType::Query, query);
+            }
+        }
+        frame = Frame{};
+    }
+    m_supported = false;
+}
+
+void GpuProfiler::calibrate() {
+    GLint64 gpu_now = 0;
+    CHECKED_GL_CALL(glGetInteger64v, GL_TIMESTAMP, &gpu_now);
+    m_clock_offset_ns = static_cast<int64_t>(util::Profiler::now_ns()) - gpu_now;
+}
+
+void GpuProfiler::new_frame() {
+    if (!m_supported) {
+        return;
+    }
+    RG_GUARANTEE(m_open_passes.empty(), "GpuProfiler: {} GPU pass(es) not ended by the end of the frame.",
+                 m_open_passes.size());
+    ++m_frame_index;
+    // The GPU clock drifts from the CPU clock, re-align them every few seconds.
+    if (m_frame_index % 600 == 0) {
+        calibrate();
+    }
+    Frame &frame = m_frames[m_frame_index % FRAME_LATENCY];
+    read_back(frame);
+    frame.passes.clear();
+    frame.used_queries = 0;
+}
+
+void GpuProfiler::read_back(Frame &frame) {
+    if (frame.passes.empty()) {
+        return;
+    }
+    // Timestamps complete in the order they were issued, so once the last issued query is available, every query
+    // of the frame is. The last pass isn't enough: with nested passes its end comes before its parent's end.
+    GLuint available = 0;
+    CHECKED_GL_CALL(glGetQueryObjectuiv, frame.queries[frame.used_queries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        ++m_dropped_frames;
+        return;
+    }
+    auto profiler = util::Profiler::instance();
+    for (const auto &pass: frame.passes) {
+        if (pass.end_query == 0) {
+            // Never ended, it has no end timestamp to read.
+            continue;
+        }
+        GLuint64 begin = 0, end = 0;
+        CHECKED_GL_CALL(glGetQueryObjectui64v, pass.begin_query, GL_QUERY_RESULT, &begin);
+        CHECKED_GL_CALL(glGetQueryObjectui64v, pass.end_query, GL_QUERY_RESULT, &end);
+        add_sample(pass.name, static_cast<float>(end - begin) / 1e6f);
+        if (util::Profiler::is_enabled()) {
+            profiler->submit(util::ProfileZone{
+                    pass.name, "gpu",
+                    static_cast<uint64_t>(static_cast<int64_t>(begin) + m_clock_offset_ns),
+                    static_cast<uint64_t>(static_cast<int64_t>(end) + m_clock_offset_ns),
+                    pass.depth, m_profiler_lane
+            });
+        }
+    }
+}
+
+void GpuProfiler::add_sample(std::string_view name, float ms) {
+    auto it = std::ranges::find(m_passes, name, &GpuPassStats::name);
+    if (it == m_passes.end()) {
+        it = m_passes.insert(m_passes.end(), GpuPassStats{.name = name});
+    }
+    GpuPassStats &stats = *it;
+    stats.samples[stats.sample_count % GpuPassStats::WINDOW] = ms;
+    ++stats.sample_count;
+    const std::size_t count = std::min(stats.sample_count, GpuPassStats::WINDOW);
+    float min = ms, max = ms, sum = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        min = std::min(min, stats.samples[i]);
+        max = std::max(max, stats.samples[i]);
+        sum += stats.samples[i];
+    }
+    stats.last_ms = ms;
+    stats.min_ms = min;
+    stats.max_ms = max;
+    stats.avg_ms = sum / static_cast<float>(count);
+}
+
+uint32_t GpuProfiler::next_query(Frame &frame) {
+    if (frame.used_queries == frame.queries.size()) {
+        // Grows only until the number of passes per frame settles.
+        const std::size_t old_size = frame.queries.size();
+        frame.queries.resize(std::max<std::size_t>(16, old_size * 2));
+        CHECKED_GL_CALL(glGenQueries, static_cast<GLsizei>(frame.queries.size() - old_size),
+                        frame.queries.data() + old_size);
+        for (std::size_t i = old_size; i < frame.queries.size(); ++i) {
+            GpuResourceTracker::instance()->on_create(GlObjectType::Query, frame.queries[i], "gpu profiler");
+        }
+    }
+    return frame.queries[frame.used_queries++];
+}
+
+void GpuProfiler::begin(std::string_view name) {
+    if (!m_supported) {
+        return;
+    }
+    Frame &frame = m_frames[m_frame_index % FRAME_LATENCY];
+    const uint32_t query = next_query(frame);
+    CHECKED_GL_CALL(glQueryCounter, query, GL_TIMESTAMP);
+    m_open_passes.push_back(frame.passes.size());
+    frame.passes.push_back(Pass{name, query, 0, static_cast<uint32_t>(m_open_passes.size() - 1)});
+}
+
+void GpuProfiler::end() {
+    if (!m_supported || m_open_passes.empty()) {
+        return;
+    }
+    Frame &frame = m_frames[m_frame_index % FRAME_LATENCY];
+    const uint32_t query = next_query(frame);
+    CHECKED_GL_CALL(glQueryCounter, query, GL_TIMESTAMP);
+    frame.passes[m_open_passes.back()].end_query = query;
+    m_open_passes.pop_back();
+}
+
+void GpuProfiler::draw_gui() {
+    ImGui::Begin("GPU profiler");
+    if (!m_supported) {
+        ImGui::Text("GPU timer queries are not supported by this driver.");
+        ImGui::End();
+        return;
+    }
+    ImGui::Text("%-20s %8s %8s %8s %8s", "pass", "last", "min", "avg", "max");
+    for (const auto &pass: m_passes) {
+        ImGui::Text("%-20.*s %8.3f %8.3f %8.3f %8.3f", static_cast<int>(pass.name.size()), pass.name.data(),
+                    pass.last_ms, pass.min_ms, pass.avg_ms, pass.max_ms);
+    }
+    ImGui::Text("Dropped frames: %llu", static_cast<unsigned long long>(m_dropped_frames));
+    ImGui::End();
+}
+
+GpuScope::GpuScope(std::string_view name) : m_profiler(
+        core::Controller::get<GraphicsController>()->gpu_profiler()) {
+    m_profiler->begin(name);
+}
+
+GpuScope::~GpuScope() {
+    m_profiler->end();
+}
+} // namespace engine::graphics
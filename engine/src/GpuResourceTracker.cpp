@@ -0,0 +1,151 @@
+#include <imgui.h>
+#include <engine/graphics/GpuResourceTracker.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <algorithm>
+#include <ranges>
+#include <tuple>
+#include <vector>
+
+namespace engine::graphics {
+GpuResourceTracker *GpuResourceTracker::instance() {
+    static GpuResourceTracker tracker;
+    return &tracker;
+}
+
+GpuResourceTracker::OwnerScope::OwnerScope(std::string owner) : m_previous(std::move(instance()->m_owner)) {
+    instance()->m_owner = std::move(owner);
+}
+
+GpuResourceTracker::OwnerScope::~OwnerScope() {
+    instance()->m_owner = std::move(m_previous);
+}
+
+void GpuResourceTracker::on_create(GlObjectType type, uint32_t id, std::string_view category, uint64_t bytes) {
+    if (id == 0) {
+        return;
+    }
+    auto [it, inserted] = m_objects.try_emplace(key(type, id), GlObject{type, id, category, m_owner, bytes});
+    if (!inserted) {
+        // The driver reuses the names of deleted objects, so this one was deleted without being reported.
+        util::logger("graphics")->warn("GL {} {} ({}, {}) was created again without being deleted.", to_string(type),
+                                       id, it->second.category, it->second.owner);
+        on_delete(type, id);
+        it = m_objects.try_emplace(key(type, id), GlObject{type, id, category, m_owner, bytes}).first;
+    }
+    auto &usage = m_usage[category];
+    ++usage.objects;
+    usage.bytes += bytes;
+}
+
+void GpuResourceTracker::set_bytes(GlObjectType type, uint32_t id, uint64_t bytes) {
+    auto it = m_objects.find(key(type, id));
+    if (it == m_objects.end()) {
+        return;
+    }
+    auto &usage = m_usage[it->second.category];
+    usage.bytes = usage.bytes - it->second.bytes + bytes;
+    it->second.bytes = bytes;
+}
+
+void GpuResourceTracker::on_delete(GlObjectType type, uint32_t id) {
+    auto it = m_objects.find(key(type, id));
+    if (it == m_objects.end()) {
+        return;
+    }
+    auto &usage = m_usage[it->second.category];
+    --usage.objects;
+    usage.bytes -= it->second.bytes;
+    m_objects.erase(it);
+}
+
+uint64_t GpuResourceTracker::live_bytes() const {
+    uint64_t result = 0;
+    for (const auto &usage: m_usage | std::views::values) {
+        result += usage.bytes;
+    }
+    return result;
+}
+
+std::size_t GpuResourceTracker::report_leaks() const {
+    if (m_objects.empty()) {
+        util::logger("graphics")->info("No GL objects leaked.");
+        return 0;
+    }
+    std::vector<const GlObject *> leaks;
+    leaks.reserve(m_objects.size());
+    for (const auto &object: m_objects | std::views::values) {
+        leaks.push_back(&object);
+    }
+    std::ranges::sort(leaks, [](const GlObject *a, const GlObject *b) {
+        return std::tie(a->category, a->owner, a->type, a->id) < std::tie(b->category, b->owner, b->type, b->id);
+    });
+    auto log = util::logger("graphics");
+    log->warn("{} GL objects ({:.1f} KB) were never deleted:", leaks.size(),
+              static_cast<double>(live_bytes()) / 1024.0);
+    for (const auto object: leaks) {
+        log->warn("  {} {} ({}, owner: {}, {:.1f} KB)", to_string(object->type), object->id, object->category,
+                  object->owner.empty() ? "-" : object->owner, static_cast<double>(object->bytes) / 1024.0);
+    }
+    return leaks.size();
+}
+
+void GpuResourceTracker::draw_gui() {
+    ImGui::Begin("GPU memory");
+    ImGui::Text("%zu objects, %.2f MB", m_objects.size(), static_cast<double>(live_bytes()) / (1024.0 * 1024.0));
+    if (ImGui::BeginTable("categories", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Category");
+        ImGui::TableSetupColumn("Objects");
+        ImGui::TableSetupColumn("MB");
+        ImGui::TableHeadersRow();
+        for (const auto &[category, usage]: m_usage) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(category.data(), category.data() + category.size());
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", usage.objects);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", static_cast<double>(usage.bytes) / (1024.0 * 1024.0));
+        }
+        ImGui::EndTable();
+    }
+    ImGui::Checkbox("Show objects", &m_gui_show_objects);
+    if (m_gui_show_objects && ImGui::BeginTable("objects", 5,
+                                                ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                                                ImGuiTableFlags_ScrollY, ImVec2(0.0f, 300.0f))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        for (const char *column: {"Type", "Id", "Category", "Owner", "KB"}) {
+            ImGui::TableSetupColumn(column);
+        }
+        ImGui::TableHeadersRow();
+        for (const auto &object: m_objects | std::views::values) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(to_string(object.type).data());
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", object.id);
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(object.category.data(), object.category.data() + object.category.size());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(object.owner.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", static_cast<double>(object.bytes) / 1024.0);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+
+std::string_view to_string(GlObjectType type) {
+    switch (type) {
+        case GlObjectType::Buffer: return "buffer";
+        case GlObjectType::VertexArray: return "vertex array";
+        case GlObjectType::Texture: return "texture";
+        case GlObjectType::Renderbuffer: return "renderbuffer";
+        case GlObjectType::Framebuffer: return "framebuffer";
+        case GlObjectType::Program: return "program";
+        case GlObjectType::Query: return "query";
+        default: RG_SHOULD_NOT_REACH_HERE("Unhandled GL object type");
+    }
+}
+} // namespace engine::graphics
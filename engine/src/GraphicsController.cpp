@@ -4,18 +4,35 @@
 #include <imgui_impl_opengl3.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <engine/graphics/GpuResourceTracker.hpp>
 #include <engine/graphics/GraphicsController.hpp>
+#include <engine/graphics/NullRenderer.hpp>
 #include <engine/graphics/OpenGL.hpp>
 #include <engine/platform/PlatformController.hpp>
 #include <engine/resources/Skybox.hpp>
+#include <engine/util/Configuration.hpp>
+#include <engine/util/Logging.hpp>
+#include <algorithm>
+#include <array>
 
 namespace engine::graphics {
 
 void GraphicsController::initialize() {
-    const int opengl_initialized = gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
-    RG_GUARANTEE(opengl_initialized, "OpenGL failed to init!");
-
     auto platform = engine::core::Controller::get<platform::PlatformController>();
+    if (platform->null_renderer()) {
+        NullRenderer::load();
+    } else {
+        const int opengl_initialized = gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
+        RG_GUARANTEE(opengl_initialized, "OpenGL failed to init!");
+    }
+    initialize_error_checking();
+    auto &config = util::Configuration::config();
+    // Started before anything is loaded, so that the capture can recreate all the objects the frames use.
+    if (config.contains("gl_capture")) {
+        m_gl_capture.start(config["gl_capture"].value("path", "frames.rgcap"),
+                           config["gl_capture"].value("frames", 120u));
+    }
+
     auto handle = platform->window()
                           ->handle_();
     m_perspective_params.FOV = glm::radians(m_camera.Zoom);
@@ -42,9 +59,100 @@ void GraphicsController::initialize() {
     (void) io;
     RG_GUARANTEE(ImGui_ImplGlfw_InitForOpenGL(handle, true), "ImGUI failed to initialize for OpenGL");
     RG_GUARANTEE(ImGui_ImplOpenGL3_Init("#version 330 core"), "ImGUI failed to initialize for OpenGL");
+    m_gpu_profiler.initialize();
+    const auto opengl_config = config.value("opengl", util::Configuration::json::object());
+    m_frames_in_flight.configure(opengl_config);
+    const auto streaming_buffer_kb = opengl_config.value<std::size_t>("streaming_buffer_kb", 1024);
+    if (streaming_buffer_kb > 0) {
+        m_streaming_buffer.create(streaming_buffer_kb * 1024, "streaming");
+    }
+    GLint uniform_alignment = 0;
+    CHECKED_GL_CALL(glGetIntegerv, GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_alignment);
+    // std140 blocks are vec4 aligned anyway, and the null renderer reports 0.
+    m_uniform_alignment = std::max<std::size_t>(uniform_alignment, 16);
+    if (platform->headless()) {
+        m_offscreen_target.create(platform->window()->width(), platform->window()->height());
+    }
+
+    if (config.contains("render_stats") && config["render_stats"].contains("csv")) {
+        // The config asked for the stats, so a run that can't write them fails instead of silently losing them.
+        const auto csv = config["render_stats"]["csv"].get<std::string>();
+        if (!m_render_stats.start_csv(csv)) {
+            throw util::EngineError(util::EngineError::Type::FileNotFound,
+                                    std::format("Failed to open {} to write the render stats.", csv));
+        }
+    }
+}
+
+void GraphicsController::initialize_error_checking() {
+    const auto opengl_config = util::Configuration::config()
+            .value("opengl", util::Configuration::json::object());
+    const std::string mode = opengl_config.value("error_check", "debug_output");
+    if (mode == "none") {
+        g_gl_error_check = GlErrorCheck::None;
+    } else if (mode == "get_error") {
+        g_gl_error_check = GlErrorCheck::GetError;
+    } else {
+        RG_GUARANTEE(mode == "debug_output", "Unknown opengl.error_check '{}', expected debug_output, get_error or none.",
+                     mode);
+        const std::string severity = opengl_config.value("debug_severity", "low");
+        constexpr std::array<std::string_view, 4> severities{"notification", "low", "medium", "high"};
+        auto it = std::ranges::find(severities, severity);
+        RG_GUARANTEE(it != severities.end(), "Unknown opengl.debug_severity '{}'.", severity);
+        GlDebugOutputConfig debug_config{
+                .min_severity = static_cast<int>(it - severities.begin()),
+                .synchronous = opengl_config.value("synchronous", true),
+        };
+        // @formatter:off
+        #ifndef NDEBUG
+            if (core::Controller::get<platform::PlatformController>()->null_renderer()) {
+                // The stubs report no errors either way, glGetError is the cheaper check.
+                g_gl_error_check = GlErrorCheck::GetError;
+            } else if (OpenGL::enable_debug_output(reinterpret_cast<void *(*)(const char *)>(glfwGetProcAddress),
+                                                   debug_config)) {
+                g_gl_error_check = GlErrorCheck::DebugOutput;
+            } else {
+                util::logger("graphics")->warn("KHR_debug is not supported, falling back to glGetError.");
+                g_gl_error_check = GlErrorCheck::GetError;
+            }
+        #endif
+        // @formatter:on
+    }
+}
+
+void GraphicsController::begin_draw() {
+    // The wait is not part of the submit time, it's reported separately.
+    const float gpu_wait_ms = m_frames_in_flight.begin_frame();
+    m_render_stats.begin_frame();
+    g_render_stats.gpu_wait_ms = gpu_wait_ms;
+    m_gl_capture.begin_frame();
+    if (m_offscreen_target.is_created()) {
+        // ImGui and the app may have bound other framebuffers during the previous frame.
+        m_offscreen_target.bind();
+    }
+    m_gpu_profiler.new_frame();
+    if (m_streaming_buffer.is_created()) {
+        m_streaming_buffer.begin_frame();
+    }
+}
+
+void GraphicsController::end_draw() {
+    if (m_streaming_buffer.is_created()) {
+        m_streaming_buffer.end_frame();
+    }
+    m_frames_in_flight.end_frame();
+    m_render_stats.end_frame();
+    m_gl_capture.end_frame();
 }
 
 void GraphicsController::terminate() {
+    m_render_stats.stop_csv();
+    m_gl_capture.stop();
+    m_offscreen_target.destroy();
+    m_streaming_buffer.destroy();
+    m_frames_in_flight.terminate();
+    m_gpu_profiler.terminate();
+    GpuResourceTracker::instance()->report_leaks();
     if (ImGui::GetCurrentContext()) {
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
@@ -79,6 +187,11 @@ void GraphicsController::end_gui() {
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+void GraphicsController::bind_uniform_range(uint32_t binding, UniformSlice slice) {
+    CHECKED_GL_CALL(glBindBufferRange, GL_UNIFORM_BUFFER, binding, m_streaming_buffer.buffer(),
+                    static_cast<GLintptr>(slice.offset), static_cast<GLsizeiptr>(slice.size));
+}
+
 void GraphicsController::draw_skybox(const resources::Shader *shader, const resources::Skybox *skybox) {
     glm::mat4 view = glm::mat4(glm::mat3(m_camera.view_matrix()));
     shader->use();
@@ -92,5 +205,10 @@ void GraphicsController::draw_skybox(const resources::Shader *shader, const reso
     CHECKED_GL_CALL(glBindVertexArray, 0);
     CHECKED_GL_CALL(glDepthFunc, GL_LESS); // set depth function back to default
     CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_CUBE_MAP, 0);
+    ++g_render_stats.vao_binds;
+    ++g_render_stats.texture_binds;
+    ++g_render_stats.draw_calls;
+    ++g_render_stats.instances;
+    g_render_stats.triangles += 12;
 }
 }
@@ -0,0 +1,148 @@
+#include <engine/util/HitchDetector.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <algorithm>
+#include <format>
+#include <map>
+
+namespace engine::util {
+void HitchDetector::configure(const nlohmann::json &config) {
+    if (!config.contains("hitches")) {
+        return;
+    }
+    const auto &hitches = config["hitches"];
+    m_enabled = hitches.value("enabled", true);
+    m_threshold = hitches.value("threshold", m_threshold);
+    m_min_ms = hitches.value("min_ms", m_min_ms);
+    m_window = std::max<std::size_t>(hitches.value("window", m_window), 1);
+    m_context_frames = hitches.value("context_frames", m_context_frames);
+    m_path = hitches.value("path", m_path.string());
+    RG_GUARANTEE(m_threshold > 1.0f, "hitches.threshold must be greater than 1, it's a multiple of the median frame time.");
+    if (m_enabled) {
+        m_file.open(m_path, std::ios::app);
+        RG_GUARANTEE(m_file.is_open(), "Failed to open {} to write the hitch log.", m_path.string());
+        m_frame_ms.reserve(m_window);
+        m_frames.reserve(m_context_frames);
+        // The reports list the slowest zones, the profiler only records them while it's enabled.
+        if (!Profiler::is_enabled()) {
+            logger("engine")->info("Hitch detection enables the profiler to record the zones of the hitch frames.");
+            Profiler::instance()->set_enabled(true);
+        }
+    }
+}
+
+float HitchDetector::median_ms() {
+    if (m_frame_ms.empty()) {
+        return 0.0f;
+    }
+    m_sorted_ms = m_frame_ms;
+    const auto middle = m_sorted_ms.begin() + m_sorted_ms.size() / 2;
+    std::nth_element(m_sorted_ms.begin(), middle, m_sorted_ms.end());
+    return *middle;
+}
+
+void HitchDetector::end_frame(float frame_ms) {
+    const auto logging = Logging::instance();
+    const uint64_t log_messages = logging->logged_messages();
+    const uint64_t log_bytes = logging->logged_bytes();
+    const HitchFrame frame{
+            .frame = ++m_frame,
+            // Profiler::new_frame has already opened the next frame.
+            .profiler_frame = Profiler::instance()->frame_index() - 1,
+            .frame_ms = frame_ms,
+            .events = g_frame_events,
+            .log_messages = log_messages - m_log_messages,
+            .log_bytes = log_bytes - m_log_bytes,
+    };
+    g_frame_events = FrameEvents{};
+    m_log_messages = log_messages;
+    m_log_bytes = log_bytes;
+    if (!m_enabled) {
+        return;
+    }
+
+    if (m_frame_ms.size() == m_window) {
+        const float median = median_ms();
+        if (frame_ms >= m_min_ms && frame_ms > m_threshold * median) {
+            report_hitch(frame, median);
+        }
+    }
+
+    // Both histories are rings, in arrival order until they fill up.
+    if (m_frame_ms.size() < m_window) {
+        m_frame_ms.push_back(frame_ms);
+    } else {
+        m_frame_ms[(frame.frame - 1) % m_window] = frame_ms;
+    }
+    if (m_frames.size() < m_context_frames) {
+        m_frames.push_back(frame);
+    } else if (!m_frames.empty()) {
+        m_frames[(frame.frame - 1) % m_frames.size()] = frame;
+    }
+}
+
+void HitchDetector::report_hitch(const HitchFrame &hitch, float median_ms) {
+    ++m_hitch_count;
+    nlohmann::json frames = nlohmann::json::array();
+    std::vector<const HitchFrame *> context;
+    for (const auto &frame: m_frames) {
+        context.push_back(&frame);
+    }
+    std::ranges::sort(context, {}, &HitchFrame::frame);
+    for (const auto frame: context) {
+        frames.push_back(frame_json(*frame));
+    }
+    frames.push_back(frame_json(hitch));
+    m_file << nlohmann::json{
+            {"frame", hitch.frame},
+            {"frame_ms", hitch.frame_ms},
+            {"median_ms", median_ms},
+            {"ratio", hitch.frame_ms / std::max(median_ms, 1e-3f)},
+            {"frames", std::move(frames)},
+    }.dump() << '\n';
+    m_file.flush();
+
+    const auto &events = hitch.events;
+    logger("engine")->warn("Hitch in frame {}: {:.2f} ms, {:.1f}x the median {:.2f} ms. Asset loads: {} ({:.2f} ms), "
+                           "shader compiles: {}, buffer allocations: {} ({:.1f} KB), log messages: {}. See {}.",
+                           hitch.frame, hitch.frame_ms, hitch.frame_ms / std::max(median_ms, 1e-3f), median_ms,
+                           events.asset_loads, static_cast<double>(events.asset_load_ns) / 1e6,
+                           events.shader_compiles, events.buffer_allocations,
+                           static_cast<double>(events.buffer_allocation_bytes) / 1024.0, hitch.log_messages,
+                           m_path.string());
+}
+
+nlohmann::json HitchDetector::frame_json(const HitchFrame &frame) {
+    const auto &events = frame.events;
+    nlohmann::json result{
+            {"frame", frame.frame},
+            {"frame_ms", frame.frame_ms},
+            {"asset_loads", events.asset_loads},
+            {"asset_load_ms", static_cast<double>(events.asset_load_ns) / 1e6},
+            {"shader_compiles", events.shader_compiles},
+            {"buffer_allocations", events.buffer_allocations},
+            {"buffer_allocation_bytes", events.buffer_allocation_bytes},
+            {"log_messages", frame.log_messages},
+            {"log_bytes", frame.log_bytes},
+    };
+    // The slowest zones, with the time of the zones with the same name and category summed up.
+    const ProfileFrame *profile = Profiler::instance()->frame(frame.profiler_frame);
+    if (!profile) {
+        return result;
+    }
+    std::map<std::string, uint64_t> zone_ns;
+    for (const auto &zone: profile->zones) {
+        auto name = zone.category.empty() ? std::string(zone.name) : std::format("{}::{}", zone.name, zone.category);
+        zone_ns[std::move(name)] += zone.end_ns - zone.begin_ns;
+    }
+    std::vector<std::pair<std::string, uint64_t> > zones(zone_ns.begin(), zone_ns.end());
+    const auto count = std::min(zones.size(), MAX_ZONES);
+    std::ranges::partial_sort(zones, zones.begin() + count, std::greater{}, &std::pair<std::string, uint64_t>::second);
+    auto &zones_json = result["zones"] = nlohmann::json::array();
+    for (std::size_t i = 0; i < count; ++i) {
+        zones_json.push_back({{"name", zones[i].first}, {"ms", static_cast<double>(zones[i].second) / 1e6}});
+    }
+    return result;
+}
+} // namespace engine::util
@@ -0,0 +1,59 @@
+
+#include <engine/platform/InputRecording.hpp>
+#include <engine/util/Errors.hpp>
+#include <json.hpp>
+#include <format>
+#include <fstream>
+
+namespace engine::platform {
+InputRecording InputRecording::load(const std::filesystem::path &path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw util::EngineError(util::EngineError::Type::FileNotFound,
+                                std::format("Input recording {} doesn't exist.", path.string()));
+    }
+    InputRecording recording;
+    try {
+        const auto json = nlohmann::json::parse(file);
+        RG_GUARANTEE(json.value("version", 0u) == VERSION, "Input recording {} has an unsupported version.",
+                     path.string());
+        // Every frame is an array of [type, code, action, x, y] events.
+        for (const auto &frame: json.at("frames")) {
+            recording.new_frame();
+            for (const auto &event: frame) {
+                recording.add(RecordedInputEvent{
+                        .type = static_cast<RecordedInputEvent::Type>(event.at(0).get<uint8_t>()),
+                        .code = event.at(1).get<int32_t>(),
+                        .action = event.at(2).get<int32_t>(),
+                        .x = event.at(3).get<double>(),
+                        .y = event.at(4).get<double>(),
+                });
+            }
+        }
+    } catch (const nlohmann::json::exception &e) {
+        throw util::EngineError(util::EngineError::Type::ConfigurationError,
+                                std::format("Failed to parse the input recording {}: {}", path.string(), e.what()));
+    }
+    return recording;
+}
+
+void InputRecording::save(const std::filesystem::path &path) const {
+    auto frames = nlohmann::json::array();
+    for (std::size_t i = 0; i < frame_count(); ++i) {
+        auto events = nlohmann::json::array();
+        for (const auto &event: frame(i)) {
+            events.push_back({static_cast<uint8_t>(event.type), event.code, event.action, event.x, event.y});
+        }
+        frames.push_back(std::move(events));
+    }
+    std::ofstream file(path);
+    RG_GUARANTEE(file.is_open(), "Failed to open {} for writing.", path.string());
+    file << nlohmann::json{{"version", VERSION}, {"frames", std::move(frames)}}.dump();
+}
+
+std::span<const RecordedInputEvent> InputRecording::frame(std::size_t index) const {
+    RG_GUARANTEE(index < m_frame_offsets.size(), "Input recording frame out of bounds!");
+    const std::size_t end = index + 1 < m_frame_offsets.size() ? m_frame_offsets[index + 1] : m_events.size();
+    return std::span(m_events).subspan(m_frame_offsets[index], end - m_frame_offsets[index]);
+}
+} // namespace engine::platform
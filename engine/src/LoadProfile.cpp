@@ -0,0 +1,148 @@
+#include <imgui.h>
+#include <engine/resources/LoadProfile.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/HitchDetector.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <json.hpp>
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <fstream>
+
+namespace engine::resources {
+static double to_ms(uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+LoadProfile::Scope::Scope(LoadProfile *profile, AssetKind kind, std::string name, std::filesystem::path path) :
+        m_profile(profile), m_record{std::move(name), kind, std::move(path), {}, 0},
+        m_outer(g_asset_load_timings), m_begin_ns(util::Profiler::now_ns()),
+        m_uncaught_exceptions(std::uncaught_exceptions()) {
+    g_asset_load_timings = AssetLoadTimings{};
+}
+
+LoadProfile::Scope::~Scope() {
+    const uint64_t total_ns = util::Profiler::now_ns() - m_begin_ns;
+    m_record.timings = g_asset_load_timings;
+    m_record.total_ns = total_ns - std::min(total_ns, m_record.timings.nested_ns);
+    // The outer asset doesn't count this load as its own time.
+    g_asset_load_timings = m_outer;
+    g_asset_load_timings.nested_ns += total_ns;
+    ++util::g_frame_events.asset_loads;
+    util::g_frame_events.asset_load_ns += m_record.total_ns;
+    if (std::uncaught_exceptions() == m_uncaught_exceptions) {
+        m_profile->add_record(std::move(m_record));
+    }
+}
+
+void LoadProfile::add_record(AssetLoadRecord record) {
+    // After the records with the same time, so the order matches a stable sort.
+    auto it = std::ranges::upper_bound(m_slowest_first, record.total_ns, std::greater{}, [this](std::size_t index) {
+        return m_records[index].total_ns;
+    });
+    m_slowest_first.insert(it, m_records.size());
+    m_records.push_back(std::move(record));
+}
+
+std::vector<AssetLoadRecord> LoadProfile::sorted_records() const {
+    std::vector<AssetLoadRecord> result;
+    result.reserve(m_records.size());
+    for (const std::size_t index: m_slowest_first) {
+        result.push_back(m_records[index]);
+    }
+    return result;
+}
+
+void LoadProfile::log_report() const {
+    auto log = util::logger("resources");
+    uint64_t total_ns = 0;
+    for (const auto &record: m_records) {
+        total_ns += record.total_ns;
+    }
+    log->info("Loaded {} assets in {:.2f} ms:", m_records.size(), to_ms(total_ns));
+    log->info("{:<8} {:<32} {:>10} {:>9} {:>9} {:>9} {:>9} {:>12} {:>12}", "kind", "name", "total ms", "io ms",
+              "decode ms", "post ms", "upload ms", "read KB", "GPU KB");
+    for (const auto &record: sorted_records()) {
+        const auto &t = record.timings;
+        log->info("{:<8} {:<32} {:>10.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>12.1f} {:>12.1f}",
+                  to_string(record.kind), record.name, to_ms(record.total_ns), to_ms(t.io_ns), to_ms(t.decode_ns),
+                  to_ms(t.post_process_ns), to_ms(t.upload_ns), static_cast<double>(t.bytes_read) / 1024.0,
+                  static_cast<double>(t.gpu_bytes) / 1024.0);
+    }
+}
+
+void LoadProfile::write_report(const std::filesystem::path &path) const {
+    nlohmann::json assets = nlohmann::json::array();
+    for (const auto &record: sorted_records()) {
+        const auto &t = record.timings;
+        assets.push_back({
+                {"kind", to_string(record.kind)},
+                {"name", record.name},
+                {"path", record.path.string()},
+                {"total_ms", to_ms(record.total_ns)},
+                {"io_ms", to_ms(t.io_ns)},
+                {"decode_ms", to_ms(t.decode_ns)},
+                {"post_process_ms", to_ms(t.post_process_ns)},
+                {"upload_ms", to_ms(t.upload_ns)},
+                {"bytes_read", t.bytes_read},
+                {"gpu_bytes", t.gpu_bytes},
+        });
+    }
+    std::ofstream file(path);
+    RG_GUARANTEE(file.is_open(), "Failed to open {} to write the load report.", path.string());
+    file << nlohmann::json{{"assets", std::move(assets)}}.dump(4);
+    util::logger("resources")->info("Load report written to {}.", path.string());
+}
+
+void LoadProfile::draw_gui() {
+    ImGui::Begin("Asset loading");
+    uint64_t total_ns = 0;
+    uint64_t gpu_bytes = 0;
+    for (const auto &record: m_records) {
+        total_ns += record.total_ns;
+        gpu_bytes += record.timings.gpu_bytes;
+    }
+    ImGui::Text("%zu assets, %.2f ms, %.1f MB on the GPU", m_records.size(), to_ms(total_ns),
+                static_cast<double>(gpu_bytes) / (1024.0 * 1024.0));
+    constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY |
+                                      ImGuiTableFlags_Resizable;
+    if (ImGui::BeginTable("assets", 9, flags)) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        for (const char *column: {"Kind", "Name", "Total ms", "IO ms", "Decode ms", "Post ms", "Upload ms", "Read KB",
+                                  "GPU KB"}) {
+            ImGui::TableSetupColumn(column);
+        }
+        ImGui::TableHeadersRow();
+        for (const std::size_t index: m_slowest_first) {
+            const auto &record = m_records[index];
+            const auto &t = record.timings;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(to_string(record.kind).data());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(record.name.c_str());
+            for (const uint64_t ns: {record.total_ns, t.io_ns, t.decode_ns, t.post_process_ns, t.upload_ns}) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", to_ms(ns));
+            }
+            for (const uint64_t bytes: {t.bytes_read, t.gpu_bytes}) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", static_cast<double>(bytes) / 1024.0);
+            }
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+
+std::string_view to_string(AssetKind kind) {
+    switch (kind) {
+        case AssetKind::Model: return "model";
+        case AssetKind::Texture: return "texture";
+        case AssetKind::Skybox: return "skybox";
+        case AssetKind::Shader: return "shader";
+        default: RG_SHOULD_NOT_REACH_HERE("Unhandled asset kind");
+    }
+}
+} // namespace engine::resources
@@ -0,0 +1,207 @@
+#include <engine/util/Logging.hpp>
+#include <engine/util/Errors.hpp>
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <chrono>
+
+namespace engine::util {
+/**
+ * @brief How long the background thread sleeps when it finds the queue empty.
+ */
+static constexpr auto BACKEND_IDLE_SLEEP = std::chrono::milliseconds(1);
+
+static spdlog::level::level_enum parse_level(const std::string &value) {
+    const auto level = spdlog::level::from_str(value);
+    if (level == spdlog::level::off && value != "off") {
+        throw EngineError(EngineError::Type::ConfigurationError,
+                          std::format("Unknown log level \"{}\". Use one of: trace, debug, info, warn, error, critical, off.",
+                                      value));
+    }
+    return level;
+}
+
+/**
+ * @brief Counts the messages for @ref Logging::logged_messages. Only the background thread writes to the sinks.
+ */
+class CountingSink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
+public:
+    CountingSink(std::atomic<uint64_t> *messages, std::atomic<uint64_t> *bytes) : m_messages(messages), m_bytes(bytes) {
+    }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        m_messages->fetch_add(1, std::memory_order_relaxed);
+        m_bytes->fetch_add(msg.payload.size(), std::memory_order_relaxed);
+    }
+
+    void flush_() override {
+    }
+
+private:
+    std::atomic<uint64_t> *m_messages;
+    std::atomic<uint64_t> *m_bytes;
+};
+
+Logging *Logging::instance() {
+    static Logging logging;
+    return &logging;
+}
+
+Logging::Logging() {
+    m_sinks = {
+            std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+            std::make_shared<CountingSink>(&m_logged_messages, &m_logged_bytes),
+    };
+    for (auto name: SUBSYSTEMS) {
+        m_loggers.push_back(std::make_unique<Logger>(std::string(name), static_cast<uint32_t>(m_loggers.size())));
+    }
+    set_default_logger();
+}
+
+void Logging::initialize() {
+    if (!m_async) {
+        start_backend(m_queue_size);
+    }
+}
+
+void Logging::start_backend(std::size_t queue_size) {
+    if (!m_queue || queue_size != m_queue_size) {
+        m_queue = std::make_unique<ds::MpscRing<LogRecord> >(queue_size);
+        m_queue_size = queue_size;
+    }
+    m_async.store(true, std::memory_order_release);
+    m_backend = std::jthread([this](std::stop_token stop) {
+        run_backend(std::move(stop));
+    });
+}
+
+void Logging::stop_backend() {
+    // New log calls are written synchronously from here on; the background thread drains the queue and exits.
+    m_async.store(false, std::memory_order_release);
+    m_backend.request_stop();
+    m_backend.join();
+}
+
+void Logging::run_backend(std::stop_token stop) {
+    std::string payload;
+    const auto write_record = [&](LogRecord &record) {
+        if (!record.format_arguments) {
+            return;
+        }
+        record.format_arguments(record.format, record.arguments, payload);
+        write(record.logger, record.time, record.location, record.thread_id, record.level, payload);
+    };
+    for (;;) {
+        bool written = false;
+        while (m_queue->try_pop(write_record)) {
+            written = true;
+        }
+        if (!written) {
+            if (stop.stop_requested()) {
+                break;
+            }
+            std::this_thread::sleep_for(BACKEND_IDLE_SLEEP);
+        }
+    }
+}
+
+void Logging::write(uint32_t logger, spdlog::log_clock::time_point time, spdlog::source_loc location,
+                    std::size_t thread_id, spdlog::level::level_enum level, std::string_view payload) {
+    spdlog::details::log_msg msg(time, location, m_loggers[logger]->name(), level,
+                                 spdlog::string_view_t(payload.data(), payload.size()));
+    msg.thread_id = thread_id;
+    for (const auto &sink: m_sinks) {
+        if (sink->should_log(level)) {
+            sink->log(msg);
+        }
+    }
+    if (level >= spdlog::level::warn) {
+        for (const auto &sink: m_sinks) {
+            sink->flush();
+        }
+    }
+}
+
+void Logging::set_default_logger() {
+    // spdlog::info etc. don't go through the queue, but they end up in the same console and file.
+    spdlog::set_default_logger(std::make_shared<spdlog::logger>("engine", m_sinks.begin(), m_sinks.end()));
+}
+
+void Logging::configure(const nlohmann::json &config) {
+    if (!config.contains("logging")) {
+        return;
+    }
+    const auto &logging = config["logging"];
+    const auto queue_size = logging.value<std::size_t>("queue_size", DEFAULT_QUEUE_SIZE);
+    // The file sink follows the configuration, so configuring twice doesn't write every line twice.
+    const auto file = logging.value<std::string>("file", "");
+    if (file != m_file_path || queue_size != m_queue_size) {
+        // The background thread reads the sinks and the queue, so it is stopped while they change.
+        const bool async = m_async;
+        if (async) {
+            stop_backend();
+        }
+        if (file != m_file_path) {
+            if (m_file_sink) {
+                std::erase(m_sinks, m_file_sink);
+                m_file_sink.reset();
+            }
+            if (!file.empty()) {
+                m_file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(file, true);
+                m_sinks.push_back(m_file_sink);
+            }
+            m_file_path = file;
+            set_default_logger();
+        }
+        if (async) {
+            start_backend(queue_size);
+        } else {
+            m_queue_size = queue_size;
+            m_queue.reset();
+        }
+    }
+
+    const auto level = parse_level(logging.value<std::string>("level", "info"));
+    for (const auto &logger: m_loggers) {
+        logger->set_level(level);
+    }
+    if (logging.contains("subsystems")) {
+        for (const auto &[subsystem, subsystem_level]: logging["subsystems"].items()) {
+            set_level(subsystem, parse_level(subsystem_level.get<std::string>()));
+        }
+    }
+}
+
+void Logging::shutdown() {
+    if (!m_async) {
+        return;
+    }
+    if (const auto dropped = dropped_messages(); dropped > 0) {
+        logger("engine")->warn(
+                "{} log messages were dropped because the log queue was full. Increase logging.queue_size in the config.json.",
+                dropped);
+    }
+    stop_backend();
+}
+
+void Logging::set_level(std::string_view subsystem, spdlog::level::level_enum level) {
+    auto it = std::ranges::find_if(m_loggers, [&](const auto &logger) {
+        return logger->name() == subsystem;
+    });
+    RG_GUARANTEE(it != m_loggers.end(), "Unknown logging subsystem: {}.", subsystem);
+    (*it)->set_level(level);
+}
+
+Logger *Logging::logger(std::string_view subsystem) const {
+    for (const auto &logger: m_loggers) {
+        if (logger->name() == subsystem) {
+            return logger.get();
+        }
+    }
+    return m_loggers.front().get();
+}
+
+} // namespace engine::util
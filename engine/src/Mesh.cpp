@@ -1,70 +1,114 @@
 #include<glad/glad.h>
+#include <engine/util/HitchDetector.hpp>
 #include <engine/util/Utils.hpp>
+#include <engine/resources/LoadProfile.hpp>
 #include <engine/resources/Mesh.hpp>
+#include <engine/graphics/GpuResourceTracker.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/graphics/RenderStats.hpp>
 #include <engine/resources/Shader.hpp>
-#include <unordered_map>
+#include <engine/util/Profiler.hpp>
+#include <array>
+#include <format>
 
 namespace engine::resources {
+static constexpr std::size_t TEXTURE_TYPE_COUNT = static_cast<std::size_t>(TextureType::Height) + 1;
 
-Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices,
-           std::vector<Texture *> textures) {
+/**
+ * @brief Returns the sampler uniform name for the `index`-th texture of a `type`, e.g. texture_diffuse1.
+ * Names are built once and cached, so drawing doesn't allocate.
+ */
+static const std::string &texture_uniform_name(TextureType type, uint32_t index) {
+    static std::array<std::vector<std::string>, TEXTURE_TYPE_COUNT> cache;
+    auto &names = cache[static_cast<std::size_t>(type)];
+    while (names.size() < index) {
+        names.push_back(std::format("{}{}", Texture::uniform_name_convention(type), names.size() + 1));
+    }
+    return names[index - 1];
+}
+
+Mesh::Mesh(std::span<const Vertex> vertices, std::span<const uint32_t> indices,
+           MeshTextures textures) {
     // NOLINTBEGIN
     static_assert(std::is_trivial_v<Vertex>);
+    const uint64_t upload_begin = util::Profiler::now_ns();
     uint32_t VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    CHECKED_GL_CALL(glGenVertexArrays, 1, &VAO);
+    CHECKED_GL_CALL(glGenBuffers, 1, &VBO);
+    CHECKED_GL_CALL(glGenBuffers, 1, &EBO);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(vertices[0]), vertices.data(), GL_STATIC_DRAW);
+    CHECKED_GL_CALL(glBindVertexArray, VAO);
+    CHECKED_GL_CALL(glBindBuffer, GL_ARRAY_BUFFER, VBO);
+    CHECKED_GL_CALL(glBufferData, GL_ARRAY_BUFFER, vertices.size() * sizeof(vertices[0]), vertices.data(),
+                    GL_STATIC_DRAW);
+    graphics::g_render_stats.buffer_bytes_uploaded += vertices.size_bytes();
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(indices[0]), indices.data(), GL_STATIC_DRAW);
+    CHECKED_GL_CALL(glBindBuffer, GL_ELEMENT_ARRAY_BUFFER, EBO);
+    CHECKED_GL_CALL(glBufferData, GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(indices[0]), indices.data(),
+                    GL_STATIC_DRAW);
+    graphics::g_render_stats.buffer_bytes_uploaded += indices.size_bytes();
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, Position));
+    CHECKED_GL_CALL(glEnableVertexAttribArray, 0);
+    CHECKED_GL_CALL(glVertexAttribPointer, 0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, Position));
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, Normal));
+    CHECKED_GL_CALL(glEnableVertexAttribArray, 1);
+    CHECKED_GL_CALL(glVertexAttribPointer, 1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, Normal));
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, TexCoords));
+    CHECKED_GL_CALL(glEnableVertexAttribArray, 2);
+    CHECKED_GL_CALL(glVertexAttribPointer, 2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, TexCoords));
 
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, Tangent));
+    CHECKED_GL_CALL(glEnableVertexAttribArray, 3);
+    CHECKED_GL_CALL(glVertexAttribPointer, 3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, Tangent));
 
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, Bitangent));
+    CHECKED_GL_CALL(glEnableVertexAttribArray, 4);
+    CHECKED_GL_CALL(glVertexAttribPointer, 4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *) offsetof(Vertex, Bitangent));
 
-    glBindVertexArray(0);
+    CHECKED_GL_CALL(glBindVertexArray, 0);
     // NOLINTEND
+    g_asset_load_timings.upload_ns += util::Profiler::now_ns() - upload_begin;
+    g_asset_load_timings.gpu_bytes += vertices.size_bytes() + indices.size_bytes();
+    util::g_frame_events.buffer_allocations += 2;
+    util::g_frame_events.buffer_allocation_bytes += vertices.size_bytes() + indices.size_bytes();
+    auto tracker = graphics::GpuResourceTracker::instance();
+    tracker->on_create(graphics::GlObjectType::VertexArray, VAO, "mesh");
+    tracker->on_create(graphics::GlObjectType::Buffer, VBO, "mesh", vertices.size_bytes());
+    tracker->on_create(graphics::GlObjectType::Buffer, EBO, "mesh", indices.size_bytes());
     m_vao = VAO;
+    m_vbo = VBO;
+    m_ebo = EBO;
     m_num_indices = indices.size();
     m_textures = std::move(textures);
 }
 
 void Mesh::draw(const Shader *shader) {
-    std::unordered_map<std::string_view, uint32_t> counts;
-    std::string uniform_name;
-    uniform_name.reserve(32);
+    std::array<uint32_t, TEXTURE_TYPE_COUNT> counts{};
     for (int i = 0; i < m_textures.size(); i++) {
-        glActiveTexture(GL_TEXTURE0 + i);
-        const auto &texture_type = Texture::uniform_name_convention(m_textures[i]->type());
-        uniform_name.append(texture_type);
-        const auto count = (counts[texture_type] += 1);
-        uniform_name.append(std::to_string(count));
-        shader->set_int(uniform_name, i);
-        glBindTexture(GL_TEXTURE_2D, m_textures[i]->id());
-        uniform_name.clear();
+        CHECKED_GL_CALL(glActiveTexture, GL_TEXTURE0 + i);
+        const auto type = m_textures[i]->type();
+        const auto count = (counts[static_cast<std::size_t>(type)] += 1);
+        shader->set_int(texture_uniform_name(type, count), i);
+        CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_2D, m_textures[i]->id());
     }
-    glBindVertexArray(m_vao);
-    glDrawElements(GL_TRIANGLES, m_num_indices, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    CHECKED_GL_CALL(glBindVertexArray, m_vao);
+    CHECKED_GL_CALL(glDrawElements, GL_TRIANGLES, m_num_indices, GL_UNSIGNED_INT, nullptr);
+    CHECKED_GL_CALL(glBindVertexArray, 0);
+    auto &stats = graphics::g_render_stats;
+    stats.texture_binds += m_textures.size();
+    ++stats.vao_binds;
+    ++stats.draw_calls;
+    ++stats.instances;
+    stats.triangles += m_num_indices / 3;
 }
 
 void Mesh::destroy() {
-    glDeleteVertexArrays(1, &m_vao);
+    CHECKED_GL_CALL(glDeleteVertexArrays, 1, &m_vao);
+    CHECKED_GL_CALL(glDeleteBuffers, 1, &m_vbo);
+    CHECKED_GL_CALL(glDeleteBuffers, 1, &m_ebo);
+    auto tracker = graphics::GpuResourceTracker::instance();
+    tracker->on_delete(graphics::GlObjectType::VertexArray, m_vao);
+    tracker->on_delete(graphics::GlObjectType::Buffer, m_vbo);
+    tracker->on_delete(graphics::GlObjectType::Buffer, m_ebo);
+    m_vao = m_vbo = m_ebo = 0;
 }
 
 }
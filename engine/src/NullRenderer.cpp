@@ -0,0 +1,226 @@
+#include <glad/glad.h>
+#include <engine/graphics/NullRenderer.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <algorithm>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace engine::graphics {
+static uint64_t g_null_gl_calls = 0;
+static GLuint g_null_next_name = 1;
+
+/**
+* @brief Number of values a glGet* query writes for `pname`, so the stubs don't write past the caller's storage.
+*/
+static int null_value_count(GLenum pname) {
+    switch (pname) {
+        case GL_VIEWPORT:
+        case GL_SCISSOR_BOX:
+        case GL_COLOR_CLEAR_VALUE:
+        case GL_COLOR_WRITEMASK:
+        case GL_BLEND_COLOR: return 4;
+        case GL_POLYGON_MODE:
+        case GL_DEPTH_RANGE:
+        case GL_MAX_VIEWPORT_DIMS: return 2;
+        default: return 1;
+    }
+}
+
+template<typename T>
+static void null_get(GLenum pname, T *data) {
+    ++g_null_gl_calls;
+    std::fill_n(data, null_value_count(pname), T{});
+    switch (pname) {
+        // glad requires an extension list and GL 3.3 to load.
+        case GL_NUM_EXTENSIONS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: data[0] = pname == GL_NUM_EXTENSIONS ? 1 : 16;
+            break;
+        case GL_MAJOR_VERSION:
+        case GL_MINOR_VERSION: data[0] = 3;
+            break;
+        case GL_POLYGON_MODE: data[0] = data[1] = GL_FILL;
+            break;
+        default: break;
+    }
+}
+
+static void null_gen_names(GLsizei n, GLuint *names) {
+    ++g_null_gl_calls;
+    for (GLsizei i = 0; i < n; ++i) {
+        names[i] = g_null_next_name++;
+    }
+}
+
+/**
+* @brief Memory for the buffer mappings. All mappings share it, the writes are thrown away anyway. Grown blocks are kept,
+* so pointers of persistent mappings stay valid.
+*/
+static std::vector<std::unique_ptr<uint8_t[]> > g_null_mappings;
+static std::size_t g_null_mapping_size = 0;
+
+static void *null_mapping(std::size_t length) {
+    // glMapBuffer maps the whole buffer, whose size the stubs don't know; a block that fits the usual buffers stands in.
+    length = std::max<std::size_t>(length, 1 << 20);
+    if (length > g_null_mapping_size) {
+        g_null_mappings.push_back(std::make_unique<uint8_t[]>(length));
+        g_null_mapping_size = length;
+    }
+    return g_null_mappings.back().get();
+}
+
+static void null_noop() {
+    ++g_null_gl_calls;
+}
+
+template<typename TProc>
+static void *null_stub(TProc proc) {
+    return reinterpret_cast<void *>(proc);
+}
+
+void *NullRenderer::get_proc_address(const char *name) {
+    // @formatter:off
+    static const std::unordered_map<std::string_view, void *> stubs{
+        {"glGetString", null_stub<PFNGLGETSTRINGPROC>([](GLenum name) -> const GLubyte * {
+            ++g_null_gl_calls;
+            switch (name) {
+                case GL_VERSION: return reinterpret_cast<const GLubyte *>("3.3.0 Null");
+                case GL_SHADING_LANGUAGE_VERSION: return reinterpret_cast<const GLubyte *>("3.30");
+                case GL_RENDERER: return reinterpret_cast<const GLubyte *>("Null renderer");
+                case GL_VENDOR: return reinterpret_cast<const GLubyte *>("matf-rg");
+                default: return reinterpret_cast<const GLubyte *>("");
+            }
+        })},
+        {"glGetStringi", null_stub<PFNGLGETSTRINGIPROC>([](GLenum, GLuint) -> const GLubyte * {
+            ++g_null_gl_calls;
+            return reinterpret_cast<const GLubyte *>("GL_MATF_null_renderer");
+        })},
+        {"glGetError", null_stub<PFNGLGETERRORPROC>([]() -> GLenum {
+            ++g_null_gl_calls;
+            return GL_NO_ERROR;
+        })},
+        {"glGetIntegerv", null_stub<PFNGLGETINTEGERVPROC>(null_get<GLint>)},
+        {"glGetInteger64v", null_stub<PFNGLGETINTEGER64VPROC>(null_get<GLint64>)},
+        {"glGetFloatv", null_stub<PFNGLGETFLOATVPROC>(null_get<GLfloat>)},
+        {"glGetBooleanv", null_stub<PFNGLGETBOOLEANVPROC>(null_get<GLboolean>)},
+        {"glIsEnabled", null_stub<PFNGLISENABLEDPROC>([](GLenum) -> GLboolean {
+            ++g_null_gl_calls;
+            return GL_FALSE;
+        })},
+        {"glGenTextures", null_stub<PFNGLGENTEXTURESPROC>(null_gen_names)},
+        {"glGenBuffers", null_stub<PFNGLGENBUFFERSPROC>(null_gen_names)},
+        {"glGenVertexArrays", null_stub<PFNGLGENVERTEXARRAYSPROC>(null_gen_names)},
+        {"glGenFramebuffers", null_stub<PFNGLGENFRAMEBUFFERSPROC>(null_gen_names)},
+        {"glGenRenderbuffers", null_stub<PFNGLGENRENDERBUFFERSPROC>(null_gen_names)},
+        {"glGenQueries", null_stub<PFNGLGENQUERIESPROC>(null_gen_names)},
+        {"glGenSamplers", null_stub<PFNGLGENSAMPLERSPROC>(null_gen_names)},
+        {"glCreateShader", null_stub<PFNGLCREATESHADERPROC>([](GLenum) -> GLuint {
+            ++g_null_gl_calls;
+            return g_null_next_name++;
+        })},
+        {"glCreateProgram", null_stub<PFNGLCREATEPROGRAMPROC>([]() -> GLuint {
+            ++g_null_gl_calls;
+            return g_null_next_name++;
+        })},
+        {"glGetShaderiv", null_stub<PFNGLGETSHADERIVPROC>([](GLuint, GLenum pname, GLint *params) {
+            ++g_null_gl_calls;
+            *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+        })},
+        {"glGetProgramiv", null_stub<PFNGLGETPROGRAMIVPROC>([](GLuint, GLenum pname, GLint *params) {
+            ++g_null_gl_calls;
+            *params = pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS ? GL_TRUE : 0;
+        })},
+        {"glGetShaderInfoLog", null_stub<PFNGLGETSHADERINFOLOGPROC>([](GLuint, GLsizei size, GLsizei *length, GLchar *log) {
+            ++g_null_gl_calls;
+            if (length) {
+                *length = 0;
+            }
+            if (size > 0) {
+                log[0] = '\0';
+            }
+        })},
+        {"glGetProgramInfoLog", null_stub<PFNGLGETPROGRAMINFOLOGPROC>([](GLuint, GLsizei size, GLsizei *length, GLchar *log) {
+            ++g_null_gl_calls;
+            if (length) {
+                *length = 0;
+            }
+            if (size > 0) {
+                log[0] = '\0';
+            }
+        })},
+        {"glGetUniformLocation", null_stub<PFNGLGETUNIFORMLOCATIONPROC>([](GLuint, const GLchar *) -> GLint {
+            ++g_null_gl_calls;
+            return 0;
+        })},
+        {"glGetAttribLocation", null_stub<PFNGLGETATTRIBLOCATIONPROC>([](GLuint, const GLchar *) -> GLint {
+            ++g_null_gl_calls;
+            return 0;
+        })},
+        // No uniform blocks, so Shader::bind_uniform_block has nothing to check.
+        {"glGetUniformBlockIndex", null_stub<PFNGLGETUNIFORMBLOCKINDEXPROC>([](GLuint, const GLchar *) -> GLuint {
+            ++g_null_gl_calls;
+            return GL_INVALID_INDEX;
+        })},
+        {"glCheckFramebufferStatus", null_stub<PFNGLCHECKFRAMEBUFFERSTATUSPROC>([](GLenum) -> GLenum {
+            ++g_null_gl_calls;
+            return GL_FRAMEBUFFER_COMPLETE;
+        })},
+        // Reports no timer bits, which disables the GpuProfiler.
+        {"glGetQueryiv", null_stub<PFNGLGETQUERYIVPROC>([](GLenum, GLenum, GLint *params) {
+            ++g_null_gl_calls;
+            *params = 0;
+        })},
+        {"glGetQueryObjectuiv", null_stub<PFNGLGETQUERYOBJECTUIVPROC>([](GLuint, GLenum, GLuint *params) {
+            ++g_null_gl_calls;
+            *params = 0;
+        })},
+        {"glGetQueryObjectui64v", null_stub<PFNGLGETQUERYOBJECTUI64VPROC>([](GLuint, GLenum, GLuint64 *params) {
+            ++g_null_gl_calls;
+            *params = 0;
+        })},
+        {"glFenceSync", null_stub<PFNGLFENCESYNCPROC>([](GLenum, GLbitfield) -> GLsync {
+            ++g_null_gl_calls;
+            return reinterpret_cast<GLsync>(static_cast<uintptr_t>(g_null_next_name++));
+        })},
+        {"glClientWaitSync", null_stub<PFNGLCLIENTWAITSYNCPROC>([](GLsync, GLbitfield, GLuint64) -> GLenum {
+            ++g_null_gl_calls;
+            return GL_ALREADY_SIGNALED;
+        })},
+        {"glMapBufferRange", null_stub<PFNGLMAPBUFFERRANGEPROC>([](GLenum, GLintptr, GLsizeiptr length, GLbitfield) -> void * {
+            ++g_null_gl_calls;
+            return null_mapping(static_cast<std::size_t>(length));
+        })},
+        {"glMapBuffer", null_stub<PFNGLMAPBUFFERPROC>([](GLenum, GLenum) -> void * {
+            ++g_null_gl_calls;
+            return null_mapping(0);
+        })},
+        {"glUnmapBuffer", null_stub<PFNGLUNMAPBUFFERPROC>([](GLenum) -> GLboolean {
+            ++g_null_gl_calls;
+            return GL_TRUE;
+        })},
+        {"glIsProgram", null_stub<PFNGLISPROGRAMPROC>([](GLuint) -> GLboolean {
+            ++g_null_gl_calls;
+            return GL_TRUE;
+        })},
+    };
+    // @formatter:on
+    auto it = stubs.find(name);
+    // The remaining functions return nothing and write nothing, one no-op stands in for all of them. Calling it through
+    // a different function pointer type is what no-op GL dispatch tables do, it is safe on the caller-cleanup ABIs.
+    return it != stubs.end() ? it->second : reinterpret_cast<void *>(null_noop);
+}
+
+void NullRenderer::load() {
+    const int loaded = gladLoadGLLoader(reinterpret_cast<GLADloadproc>(get_proc_address));
+    RG_GUARANTEE(loaded, "The null renderer failed to load.");
+    g_null_gl_calls = 0;
+    util::logger("graphics")->info("Using the null renderer, no OpenGL calls reach a driver.");
+}
+
+uint64_t NullRenderer::call_count() {
+    return g_null_gl_calls;
+}
+} // namespace engine::graphics
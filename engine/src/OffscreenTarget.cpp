@@ -0,0 +1,67 @@
+#include <glad/glad.h>
+#include <engine/graphics/GpuResourceTracker.hpp>
+#include <engine/graphics/OffscreenTarget.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/util/Errors.hpp>
+
+namespace engine::graphics {
+void OffscreenTarget::create(int width, int height) {
+    destroy();
+    m_width = width;
+    m_height = height;
+    CHECKED_GL_CALL(glGenFramebuffers, 1, &m_framebuffer);
+    CHECKED_GL_CALL(glBindFramebuffer, GL_FRAMEBUFFER, m_framebuffer);
+
+    CHECKED_GL_CALL(glGenRenderbuffers, 1, &m_color);
+    CHECKED_GL_CALL(glBindRenderbuffer, GL_RENDERBUFFER, m_color);
+    CHECKED_GL_CALL(glRenderbufferStorage, GL_RENDERBUFFER, GL_RGBA8, width, height);
+    CHECKED_GL_CALL(glFramebufferRenderbuffer, GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color);
+
+    CHECKED_GL_CALL(glGenRenderbuffers, 1, &m_depth_stencil);
+    CHECKED_GL_CALL(glBindRenderbuffer, GL_RENDERBUFFER, m_depth_stencil);
+    CHECKED_GL_CALL(glRenderbufferStorage, GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    CHECKED_GL_CALL(glFramebufferRenderbuffer, GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                    m_depth_stencil);
+    CHECKED_GL_CALL(glBindRenderbuffer, GL_RENDERBUFFER, 0);
+
+    const GLenum status = CHECKED_GL_CALL(glCheckFramebufferStatus, GL_FRAMEBUFFER);
+    RG_GUARANTEE(status == GL_FRAMEBUFFER_COMPLETE, "Offscreen framebuffer {}x{} is incomplete: {:#x}", width, height,
+                 status);
+    // Both attachments take 4 bytes per pixel.
+    const uint64_t attachment_bytes = static_cast<uint64_t>(width) * height * 4;
+    auto tracker = GpuResourceTracker::instance();
+    tracker->on_create(GlObjectType::Framebuffer, m_framebuffer, "render target");
+    tracker->on_create(GlObjectType::Renderbuffer, m_color, "render target", attachment_bytes);
+    tracker->on_create(GlObjectType::Renderbuffer, m_depth_stencil, "render target", attachment_bytes);
+    bind();
+}
+
+void OffscreenTarget::destroy() {
+    if (!is_created()) {
+        return;
+    }
+    CHECKED_GL_CALL(glBindFramebuffer, GL_FRAMEBUFFER, 0);
+    CHECKED_GL_CALL(glDeleteRenderbuffers, 1, &m_color);
+    CHECKED_GL_CALL(glDeleteRenderbuffers, 1, &m_depth_stencil);
+    CHECKED_GL_CALL(glDeleteFramebuffers, 1, &m_framebuffer);
+    auto tracker = GpuResourceTracker::instance();
+    tracker->on_delete(GlObjectType::Renderbuffer, m_color);
+    tracker->on_delete(GlObjectType::Renderbuffer, m_depth_stencil);
+    tracker->on_delete(GlObjectType::Framebuffer, m_framebuffer);
+    m_framebuffer = m_color = m_depth_stencil = 0;
+}
+
+void OffscreenTarget::bind() const {
+    CHECKED_GL_CALL(glBindFramebuffer, GL_FRAMEBUFFER, m_framebuffer);
+    CHECKED_GL_CALL(glViewport, 0, 0, m_width, m_height);
+}
+
+std::vector<uint8_t> OffscreenTarget::read_pixels() const {
+    RG_GUARANTEE(is_created(), "The offscreen target is not created.");
+    std::vector<uint8_t> pixels(static_cast<std::size_t>(m_width) * m_height * 4);
+    CHECKED_GL_CALL(glBindFramebuffer, GL_READ_FRAMEBUFFER, m_framebuffer);
+    CHECKED_GL_CALL(glPixelStorei, GL_PACK_ALIGNMENT, 1);
+    CHECKED_GL_CALL(glReadPixels, 0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+} // namespace engine::graphics
@@ -2,12 +2,18 @@
 #include <filesystem>
 #include <array>
 #include <stb_image.h>
+#include <engine/graphics/GpuResourceTracker.hpp>
 #include <engine/graphics/OpenGL.hpp>
+#include <engine/resources/LoadProfile.hpp>
 #include <engine/resources/Shader.hpp>
 #include <engine/resources/ShaderCompiler.hpp>
 #include <engine/resources/Skybox.hpp>
 #include <engine/util/Errors.hpp>
+#include <engine/util/HitchDetector.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
 #include <engine/util/Utils.hpp>
+#include <mutex>
 
 namespace engine::graphics {
 int32_t OpenGL::shader_type_to_opengl_type(resources::ShaderType type) {
@@ -20,30 +26,48 @@ int32_t OpenGL::shader_type_to_opengl_type(resources::ShaderType type) {
 }
 
 uint32_t OpenGL::generate_texture(const std::filesystem::path &path, bool flip_uvs) {
-    uint32_t texture_id = 0;
-    CHECKED_GL_CALL(glGenTextures, 1, &texture_id);
+    if (!std::filesystem::exists(path)) {
+        throw util::EngineError(util::EngineError::Type::AssetLoadingError,
+                                std::format("Failed to load texture {}", path.string()));
+    }
+    auto &timings = resources::g_asset_load_timings;
+    uint64_t stage_begin = util::Profiler::now_ns();
+    const std::vector<uint8_t> file = util::read_binary_file(path);
+    timings.io_ns += util::Profiler::now_ns() - stage_begin;
+    timings.bytes_read += file.size();
 
+    stage_begin = util::Profiler::now_ns();
     int32_t width, height, nr_components;
     stbi_set_flip_vertically_on_load(flip_uvs);
-    uint8_t *data = stbi_load(path.c_str(), &width, &height, &nr_components, 0);
+    uint8_t *data = stbi_load_from_memory(file.data(), static_cast<int>(file.size()), &width, &height,
+                                          &nr_components, 0);
     defer {
         stbi_image_free(data);
     };
-    if (data) {
-        int32_t format = texture_format(nr_components);
-
-        CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_2D, texture_id);
-        CHECKED_GL_CALL(glTexImage2D, GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        CHECKED_GL_CALL(glGenerateMipmap, GL_TEXTURE_2D);
-
-        CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    } else {
+    timings.decode_ns += util::Profiler::now_ns() - stage_begin;
+    if (!data) {
         throw util::EngineError(util::EngineError::Type::AssetLoadingError,
                                 std::format("Failed to load texture {}", path.string()));
     }
+
+    stage_begin = util::Profiler::now_ns();
+    uint32_t texture_id = 0;
+    CHECKED_GL_CALL(glGenTextures, 1, &texture_id);
+    int32_t format = texture_format(nr_components);
+
+    CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_2D, texture_id);
+    CHECKED_GL_CALL(glTexImage2D, GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    CHECKED_GL_CALL(glGenerateMipmap, GL_TEXTURE_2D);
+
+    CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    timings.upload_ns += util::Profiler::now_ns() - stage_begin;
+    // The mip chain adds a third on top of the base level.
+    const uint64_t bytes = static_cast<uint64_t>(width) * height * nr_components * 4 / 3;
+    timings.gpu_bytes += bytes;
+    GpuResourceTracker::instance()->on_create(GlObjectType::Texture, texture_id, "texture", bytes);
     return texture_id;
 }
 
@@ -56,25 +80,44 @@ int32_t OpenGL::texture_format(int32_t number_of_channels) {
     }
 }
 
+static uint32_t g_skybox_vao = 0;
+static uint32_t g_skybox_vbo = 0;
+
 uint32_t OpenGL::init_skybox_cube() {
-    static unsigned int skybox_vao = 0;
-    if (skybox_vao != 0) {
-        return skybox_vao;
+    if (g_skybox_vao != 0) {
+        return g_skybox_vao;
     }
     float vertices[] = {
             // @formatter:off
         #include <skybox_vertices.include>
         // @formatter:on
     };
-    uint32_t skybox_vbo = 0;
-    CHECKED_GL_CALL(glGenVertexArrays, 1, &skybox_vao);
-    CHECKED_GL_CALL(glGenBuffers, 1, &skybox_vbo);
-    CHECKED_GL_CALL(glBindVertexArray, skybox_vao);
-    CHECKED_GL_CALL(glBindBuffer, GL_ARRAY_BUFFER, skybox_vbo);
+    CHECKED_GL_CALL(glGenVertexArrays, 1, &g_skybox_vao);
+    CHECKED_GL_CALL(glGenBuffers, 1, &g_skybox_vbo);
+    CHECKED_GL_CALL(glBindVertexArray, g_skybox_vao);
+    CHECKED_GL_CALL(glBindBuffer, GL_ARRAY_BUFFER, g_skybox_vbo);
     CHECKED_GL_CALL(glBufferData, GL_ARRAY_BUFFER, sizeof(vertices), &vertices, GL_STATIC_DRAW);
+    g_render_stats.buffer_bytes_uploaded += sizeof(vertices);
+    ++util::g_frame_events.buffer_allocations;
+    util::g_frame_events.buffer_allocation_bytes += sizeof(vertices);
     CHECKED_GL_CALL(glEnableVertexAttribArray, 0);
     CHECKED_GL_CALL(glVertexAttribPointer, 0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *) 0); // NOLINT
-    return skybox_vao;
+    // Shared by all the skyboxes, so it has no owner.
+    GpuResourceTracker::OwnerScope owner("");
+    GpuResourceTracker::instance()->on_create(GlObjectType::VertexArray, g_skybox_vao, "skybox");
+    GpuResourceTracker::instance()->on_create(GlObjectType::Buffer, g_skybox_vbo, "skybox", sizeof(vertices));
+    return g_skybox_vao;
+}
+
+void OpenGL::destroy_skybox_cube() {
+    if (g_skybox_vao == 0) {
+        return;
+    }
+    CHECKED_GL_CALL(glDeleteVertexArrays, 1, &g_skybox_vao);
+    CHECKED_GL_CALL(glDeleteBuffers, 1, &g_skybox_vbo);
+    GpuResourceTracker::instance()->on_delete(GlObjectType::VertexArray, g_skybox_vao);
+    GpuResourceTracker::instance()->on_delete(GlObjectType::Buffer, g_skybox_vbo);
+    g_skybox_vao = g_skybox_vbo = 0;
 }
 
 bool OpenGL::shader_compiled_successfully(uint32_t shader_id) {
@@ -131,6 +174,123 @@ void OpenGL::assert_no_error(std::source_location location) {
     };
 }
 
+// KHR_debug isn't part of the 3.3 core profile glad was generated for.
+static constexpr GLint GL_CONTEXT_FLAG_DEBUG_BIT_KHR = 0x2;
+static constexpr GLenum GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR = 0x8242;
+static constexpr GLenum GL_DEBUG_TYPE_ERROR_KHR = 0x824C;
+static constexpr GLenum GL_DEBUG_SEVERITY_NOTIFICATION_KHR = 0x826B;
+static constexpr GLenum GL_DEBUG_OUTPUT_KHR = 0x92E0;
+static constexpr GLenum GL_DEBUG_SEVERITY_HIGH_KHR = 0x9146;
+static constexpr GLenum GL_DEBUG_SEVERITY_MEDIUM_KHR = 0x9147;
+static constexpr GLenum GL_DEBUG_SEVERITY_LOW_KHR = 0x9148;
+
+using DebugMessageCallbackFn = void (APIENTRY *)(GLDEBUGPROC callback, const void *user_param);
+using DebugMessageControlFn = void (APIENTRY *)(GLenum source, GLenum type, GLenum severity, GLsizei count,
+                                               const GLuint *ids, GLboolean enabled);
+
+static std::mutex g_gl_debug_error_mutex;
+static std::string g_gl_debug_error_message;
+/**
+* @brief Whether the callback runs inside the offending call, on the thread that made it.
+*/
+static bool g_gl_debug_synchronous{true};
+
+static int debug_severity_level(GLenum severity) {
+    switch (severity) {
+        case GL_DEBUG_SEVERITY_HIGH_KHR: return 3;
+        case GL_DEBUG_SEVERITY_MEDIUM_KHR: return 2;
+        case GL_DEBUG_SEVERITY_LOW_KHR: return 1;
+        default: return 0;
+    }
+}
+
+static void gl_debug_message_callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                                      const GLchar *message, const void *user_param) {
+    const std::string_view text = length < 0 ? std::string_view(message) : std::string_view(message, length);
+    const int level = debug_severity_level(severity);
+    if (type == GL_DEBUG_TYPE_ERROR_KHR) {
+        // Exceptions can't be thrown through the driver, the next checked call throws it instead.
+        std::scoped_lock lock(g_gl_debug_error_mutex);
+        if (!g_gl_debug_error_pending.load(std::memory_order_relaxed)) {
+            g_gl_debug_error_message = std::format("OpenGL debug output [{}]: '{}'", id, text);
+            g_gl_debug_error_pending.store(true, std::memory_order_release);
+        }
+        return;
+    }
+    // Performance, portability and other messages aren't errors, even at high severity.
+    auto log = util::logger("graphics");
+    const auto log_level = level == 3 ? spdlog::level::err
+                           : level == 2 ? spdlog::level::warn
+                           : level == 1 ? spdlog::level::info
+                           : spdlog::level::debug;
+    if (!g_gl_debug_synchronous) {
+        // The callback may run on a driver thread, where g_gl_call_location was never set.
+        log->log(log_level, "OpenGL [{}] {}", id, text);
+        return;
+    }
+    const std::source_location &location = g_gl_call_location;
+    log->log(log_level, "OpenGL [{}] {} (last call at {}:{})", id, text, location.file_name(), location.line());
+}
+
+bool OpenGL::enable_debug_output(void *(*get_proc_address)(const char *), const GlDebugOutputConfig &config) {
+    const auto load = [get_proc_address](std::initializer_list<const char *> names) -> void * {
+        for (const char *name: names) {
+            if (void *function = get_proc_address(name)) {
+                return function;
+            }
+        }
+        return nullptr;
+    };
+    auto debug_message_callback = reinterpret_cast<DebugMessageCallbackFn>(
+            load({"glDebugMessageCallback", "glDebugMessageCallbackKHR", "glDebugMessageCallbackARB"}));
+    auto debug_message_control = reinterpret_cast<DebugMessageControlFn>(
+            load({"glDebugMessageControl", "glDebugMessageControlKHR", "glDebugMessageControlARB"}));
+    if (!debug_message_callback || !debug_message_control) {
+        return false;
+    }
+    GLint context_flags = 0;
+    CHECKED_GL_CALL(glGetIntegerv, GL_CONTEXT_FLAGS, &context_flags);
+    if (!(context_flags & GL_CONTEXT_FLAG_DEBUG_BIT_KHR)) {
+        util::logger("graphics")->warn("Not a debug context, the driver might not report all OpenGL errors.");
+    }
+
+    CHECKED_GL_CALL(glEnable, GL_DEBUG_OUTPUT_KHR);
+    g_gl_debug_synchronous = config.synchronous;
+    if (config.synchronous) {
+        CHECKED_GL_CALL(glEnable, GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR);
+    } else {
+        CHECKED_GL_CALL(glDisable, GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR);
+    }
+    // The lambda converts to the APIENTRY calling convention GLDEBUGPROC requires on 32-bit Windows.
+    debug_message_callback([](GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                              const GLchar *message, const void *user_param) {
+        gl_debug_message_callback(source, type, id, severity, length, message, user_param);
+    }, nullptr);
+    // Filter in the driver so the callback isn't called for messages that would be dropped anyway.
+    constexpr std::array severities{
+            GL_DEBUG_SEVERITY_NOTIFICATION_KHR, GL_DEBUG_SEVERITY_LOW_KHR, GL_DEBUG_SEVERITY_MEDIUM_KHR,
+            GL_DEBUG_SEVERITY_HIGH_KHR
+    };
+    for (int level = 0; level < static_cast<int>(severities.size()); ++level) {
+        debug_message_control(GL_DONT_CARE, GL_DONT_CARE, severities[level], 0, nullptr,
+                              level >= config.min_severity || level == 3);
+    }
+    // Errors are reported regardless of their severity.
+    debug_message_control(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR_KHR, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+    return true;
+}
+
+void OpenGL::throw_debug_output_error(std::source_location location) {
+    std::string message;
+    {
+        std::scoped_lock lock(g_gl_debug_error_mutex);
+        message = std::move(g_gl_debug_error_message);
+        g_gl_debug_error_message.clear();
+        g_gl_debug_error_pending.store(false, std::memory_order_relaxed);
+    }
+    throw util::EngineError(util::EngineError::Type::OpenGLError, std::move(message), location);
+}
+
 uint32_t face_index(std::string_view name);
 
 uint32_t OpenGL::load_skybox_textures(const std::filesystem::path &path, bool flip_uvs) {
@@ -141,14 +301,25 @@ uint32_t OpenGL::load_skybox_textures(const std::filesystem::path &path, bool fl
     CHECKED_GL_CALL(glGenTextures, 1, &texture_id);
     CHECKED_GL_CALL(glBindTexture, GL_TEXTURE_CUBE_MAP, texture_id);
 
+    auto &timings = resources::g_asset_load_timings;
+    uint64_t bytes_allocated = 0;
     int width, height, nr_channels;
     for (const auto &file: std::filesystem::directory_iterator(path)) {
+        uint64_t stage_begin = util::Profiler::now_ns();
+        const std::vector<uint8_t> bytes = util::read_binary_file(file.path());
+        timings.io_ns += util::Profiler::now_ns() - stage_begin;
+        timings.bytes_read += bytes.size();
+
+        stage_begin = util::Profiler::now_ns();
         stbi_set_flip_vertically_on_load(flip_uvs);
-        unsigned char *data = stbi_load(absolute(file).c_str(), &width, &height, &nr_channels, 0);
+        unsigned char *data = stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()), &width, &height,
+                                                    &nr_channels, 0);
         defer {
             stbi_image_free(data);
         };
+        timings.decode_ns += util::Profiler::now_ns() - stage_begin;
         if (data) {
+            stage_begin = util::Profiler::now_ns();
             uint32_t i = face_index(file.path()
                                         .stem()
                                         .c_str());
@@ -156,6 +327,8 @@ uint32_t OpenGL::load_skybox_textures(const std::filesystem::path &path, bool fl
             CHECKED_GL_CALL(glTexImage2D, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, format, width, height, 0, format,
                             GL_UNSIGNED_BYTE,
                             data);
+            timings.upload_ns += util::Profiler::now_ns() - stage_begin;
+            bytes_allocated += static_cast<uint64_t>(width) * height * nr_channels;
         } else {
             throw util::EngineError(util::EngineError::Type::AssetLoadingError,
                                     std::format("Failed to load skybox texture {}", path.string()));
@@ -166,6 +339,8 @@ uint32_t OpenGL::load_skybox_textures(const std::filesystem::path &path, bool fl
     CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     CHECKED_GL_CALL(glTexParameteri, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    timings.gpu_bytes += bytes_allocated;
+    GpuResourceTracker::instance()->on_create(GlObjectType::Texture, texture_id, "skybox", bytes_allocated);
 
     return texture_id;
 }
@@ -182,6 +357,26 @@ void OpenGL::clear_buffers() {
     CHECKED_GL_CALL(glClear, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
 
+bool OpenGL::has_version(int major, int minor) {
+    GLint context_major = 0;
+    GLint context_minor = 0;
+    CHECKED_GL_CALL(glGetIntegerv, GL_MAJOR_VERSION, &context_major);
+    CHECKED_GL_CALL(glGetIntegerv, GL_MINOR_VERSION, &context_minor);
+    return context_major > major || (context_major == major && context_minor >= minor);
+}
+
+bool OpenGL::has_extension(std::string_view name) {
+    GLint count = 0;
+    CHECKED_GL_CALL(glGetIntegerv, GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const auto extension = reinterpret_cast<const char *>(CHECKED_GL_CALL(glGetStringi, GL_EXTENSIONS, i));
+        if (extension && name == extension) {
+            return true;
+        }
+    }
+    return false;
+}
+
 uint32_t face_index(std::string_view name) {
     if (name == "right") {
         return 0;
@@ -3,10 +3,15 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <engine/graphics/OpenGL.hpp>
 #include <engine/platform/PlatformController.hpp>
+#include <engine/util/ArgParser.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
 #include <engine/util/Utils.hpp>
 
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <utility>
 #include <engine/util/Configuration.hpp>
 
@@ -28,12 +33,26 @@ static void glfw_window_close_callback(GLFWwindow *window);
 
 static void glfw_mouse_button_callback(GLFWwindow *window, int button, int action, int mods);
 
-static int glfw_platform_action(GLFWwindow *window, int glfw_key_code);
+static void glfw_window_focus_callback(GLFWwindow *window, int focused);
+
+static void glfw_window_iconify_callback(GLFWwindow *window, int iconified);
 
 void initialize_key_maps();
 
 void PlatformController::initialize() {
-    if (glfwPlatformSupported(GLFW_PLATFORM_X11)) {
+    util::Configuration::json &config = util::Configuration::config();
+    const auto platform_config = config.value("platform", util::Configuration::json::object());
+    m_headless = util::ArgParser::instance()
+                         ->arg<bool>("--headless", platform_config.value("headless", false))
+                         .value();
+    const auto opengl_config = config.value("opengl", util::Configuration::json::object());
+    m_null_renderer = util::ArgParser::instance()
+                              ->arg<bool>("--null-renderer", opengl_config.value("null_renderer", false))
+                              .value();
+    if (m_headless) {
+        // No display connection, only the offscreen context, see PlatformController::set_headless_window_hints.
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    } else if (glfwPlatformSupported(GLFW_PLATFORM_X11)) {
         glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11);
     } else if (glfwPlatformSupported(GLFW_PLATFORM_WAYLAND)) {
         glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WAYLAND);
@@ -45,8 +64,26 @@ void PlatformController::initialize() {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    util::Configuration::json &config = util::Configuration::config();
+    if (m_null_renderer) {
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    } else if (m_headless) {
+        set_headless_window_hints(platform_config.value("context_api", "egl"));
+    }
+    // @formatter:off
+    #ifndef NDEBUG
+        if (opengl_config.value("error_check", "debug_output") == "debug_output") {
+            glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+        }
+        if (opengl_config.value("no_error_context", false)) {
+            util::logger("platform")->warn("opengl.no_error_context is ignored in debug builds.");
+        }
+    #else
+        // Lets the driver skip error validation entirely. Invalid calls have undefined behavior instead.
+        if (opengl_config.value("no_error_context", false)) {
+            glfwWindowHint(GLFW_CONTEXT_NO_ERROR, GLFW_TRUE);
+        }
+    #endif
+    // @formatter:on
     int window_width = config["window"]["width"];
     int window_height = config["window"]["height"];
     std::string window_title = config["window"]["title"];
@@ -54,26 +91,71 @@ void PlatformController::initialize() {
     RG_GUARANTEE(handle, "GLFW3 platform failed to create a Window.");
     m_window = Window(handle, window_width, window_height, window_title);
 
-    glfwMakeContextCurrent(m_window.handle_());
-    glfwSetCursorPosCallback(m_window.handle_(), glfw_mouse_callback);
-    glfwSetScrollCallback(m_window.handle_(), glfw_scroll_callback);
-    glfwSetKeyCallback(m_window.handle_(), glfw_key_callback);
-    glfwSetFramebufferSizeCallback(m_window.handle_(), glfw_framebuffer_size_callback);
-    glfwSetMouseButtonCallback(m_window.handle_(), glfw_mouse_button_callback);
-    glfwSetWindowCloseCallback(m_window.handle_(), glfw_window_close_callback);
+    m_frame_pacer.configure(config);
+    if (!m_null_renderer) {
+        glfwMakeContextCurrent(m_window.handle_());
+        if (!m_headless) {
+            m_frame_pacer.apply_swap_interval();
+        }
+    }
+    // Without a display there is no input, only the key state is set up for the controllers that query it.
+    if (!m_headless) {
+        glfwSetCursorPosCallback(m_window.handle_(), glfw_mouse_callback);
+        glfwSetScrollCallback(m_window.handle_(), glfw_scroll_callback);
+        glfwSetKeyCallback(m_window.handle_(), glfw_key_callback);
+        glfwSetFramebufferSizeCallback(m_window.handle_(), glfw_framebuffer_size_callback);
+        glfwSetMouseButtonCallback(m_window.handle_(), glfw_mouse_button_callback);
+        glfwSetWindowCloseCallback(m_window.handle_(), glfw_window_close_callback);
+        glfwSetWindowFocusCallback(m_window.handle_(), glfw_window_focus_callback);
+        glfwSetWindowIconifyCallback(m_window.handle_(), glfw_window_iconify_callback);
+        _platform_on_window_state_change();
+    }
 
     int major, minor, revision;
     glfwGetVersion(&major, &minor, &revision);
-    spdlog::info("Platform[GLFW {}.{}.{}]", major, minor, revision);
+    util::logger("platform")->info("Platform[GLFW {}.{}.{}]{}", major, minor, revision, m_headless ? " headless" : "");
     initialize_key_maps();
     m_keys.resize(KEY_COUNT);
     for (int key = 0; key < m_keys.size(); ++key) {
         m_keys[key].m_key = static_cast<KeyId>(key);
     }
+    m_key_events.reserve(64);
+    if (config.contains("input") && !m_headless) {
+        set_raw_mouse_motion(config["input"].value("raw_mouse_motion", false));
+    }
+    m_input_recording_path = util::ArgParser::instance()->arg<std::string>("--record-input").value();
+    if (!m_input_recording_path.empty()) {
+        util::logger("platform")->info("Recording input into {}.", m_input_recording_path.string());
+    }
+    const auto idle_config = config.value("idle", util::Configuration::json::object());
+    m_idle_throttle = idle_config.value("throttle", m_idle_throttle);
+    m_unfocused_fps = idle_config.value("unfocused_fps", m_unfocused_fps);
+    m_idle_timeout_s = idle_config.value("timeout_ms", m_idle_timeout_s * 1000.0) / 1000.0;
+    RG_GUARANTEE(m_unfocused_fps >= 0.0f, "idle.unfocused_fps can't be negative.");
+    RG_GUARANTEE(m_idle_timeout_s > 0.0, "idle.timeout_ms must be positive.");
+    set_on_demand(idle_config.value("on_demand", false));
+    m_main_thread = std::this_thread::get_id();
+    m_hitch_detector.configure(config);
+    m_last_loop_time = glfwGetTime();
+}
+
+void PlatformController::set_headless_window_hints(std::string_view context_api) {
+    RG_GUARANTEE(context_api == "egl" || context_api == "osmesa",
+                 "Unknown context API '{}', expected egl or osmesa.", context_api);
+    // The context is a surfaceless EGL (e.g. Mesa llvmpipe) or an OSMesa one, and the frames are rendered into
+    // an OffscreenTarget.
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, context_api == "egl" ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 }
 
 void PlatformController::terminate() {
     m_platform_event_observers.clear();
+    if (!m_input_recording_path.empty()) {
+        m_input_recording.save(m_input_recording_path);
+        util::logger("platform")->info("Saved {} frames of input into {}.", m_input_recording.frame_count(),
+                                       m_input_recording_path.string());
+        m_input_recording_path.clear();
+    }
     if (m_window.handle_()) {
         glfwDestroyWindow(m_window.handle_());
         glfwTerminate();
@@ -81,9 +163,17 @@ void PlatformController::terminate() {
 }
 
 bool PlatformController::loop() {
+    // The frame boundary is the start of the loop, so the wait is part of the frame that finished.
+    m_frame_pacer.wait();
+    const double now = glfwGetTime();
+    const auto measured_dt = static_cast<float>(now - m_last_loop_time);
     m_frame_time.previous = m_frame_time.current;
-    m_frame_time.current = glfwGetTime();
+    m_frame_time.current = m_fixed_dt > 0.0f ? m_frame_time.previous + m_fixed_dt : now;
     m_frame_time.dt = m_frame_time.current - m_frame_time.previous;
+    m_frame_pacer.end_frame(measured_dt);
+    m_frame_time.smoothed_dt = m_fixed_dt > 0.0f ? m_fixed_dt : m_frame_pacer.smoothed_dt();
+    m_hitch_detector.end_frame(static_cast<float>((measured_dt - m_idle_wait_s) * 1000.0));
+    m_last_loop_time = now;
 
     return !glfwWindowShouldClose(m_window.handle_());
 }
@@ -91,67 +181,207 @@ bool PlatformController::loop() {
 void PlatformController::poll_events() {
     g_mouse_position.dx = g_mouse_position.dy = 0.0f;
     g_mouse_position.scroll = 0.0f;
+    m_key_events.clear();
+    m_mouse_samples.clear();
+    const double last_input_time = m_last_input_time;
+    if (!m_input_recording_path.empty()) {
+        m_input_recording.new_frame();
+    }
+    wait_events();
     glfwPollEvents();
-    for (int i = 0; i < KEY_COUNT; ++i) {
-        update_key(key_ref(static_cast<KeyId>(i)));
+    if (m_playing_input) {
+        play_input_frame();
+    }
+    // A held key counts as input too, the controllers usually act on it every frame.
+    if (m_mouse_moved || m_mouse_scrolled || !m_key_events.empty() || !m_keys_pending.empty()) {
+        m_redraw_requested.store(true, std::memory_order_relaxed);
+    }
+    m_frame_input_time = m_last_input_time != last_input_time ? m_last_input_time : -1.0;
+    update_mouse();
+    update_keys();
+    for (const auto &event: m_key_events) {
+        const Key result = key(event.key);
+        for (auto &observer: m_platform_event_observers) {
+            observer->on_key(result);
+        }
+    }
+}
+
+void PlatformController::wait_events() {
+    m_idle_wait_s = 0.0;
+    // There are no events to wait for without a display, and a played back recording feeds one frame per poll.
+    if (m_headless || m_playing_input) {
+        return;
+    }
+    const bool hidden = m_idle_throttle && m_window_activity == WindowActivity::Hidden;
+    const bool unfocused = m_idle_throttle && m_window_activity == WindowActivity::Unfocused && m_unfocused_fps > 0.0f;
+    const bool idle = m_on_demand && !m_redraw_requested.load(std::memory_order_relaxed);
+    if (!hidden && !unfocused && !idle) {
+        return;
+    }
+    RG_PROFILE_SCOPE("PlatformController::wait_events");
+    const double begin = glfwGetTime();
+    if (hidden || idle) {
+        // Any event wakes the loop up, the input, a window change or a redraw request from another thread.
+        glfwWaitEventsTimeout(m_idle_timeout_s);
+    } else {
+        // The events are handled as they come, but the next frame waits for the unfocused frame period.
+        const double deadline = m_last_loop_time + 1.0 / m_unfocused_fps;
+        for (double now = begin; now < deadline && m_window_activity == WindowActivity::Unfocused &&
+                                 !glfwWindowShouldClose(m_window.handle_()); now = glfwGetTime()) {
+            glfwWaitEventsTimeout(deadline - now);
+        }
+    }
+    m_idle_wait_s = glfwGetTime() - begin;
+    // The frame after a wait is late by design, it's not a missed frame boundary.
+    m_frame_pacer.restart();
+}
+
+void PlatformController::set_on_demand(bool enabled) {
+    m_on_demand = enabled;
+    m_redraw_requested.store(true, std::memory_order_relaxed);
+}
+
+void PlatformController::request_redraw() {
+    if (!m_redraw_requested.exchange(true) && std::this_thread::get_id() != m_main_thread) {
+        // Wakes up the main thread if it's waiting for events.
+        glfwPostEmptyEvent();
+    }
+}
+
+bool PlatformController::consume_redraw() {
+    const bool requested = m_redraw_requested.exchange(false);
+    if (m_idle_throttle && m_window_activity == WindowActivity::Hidden) {
+        return false;
+    }
+    return requested || !m_on_demand;
+}
+
+void PlatformController::_platform_on_window_state_change() {
+    GLFWwindow *handle = m_window.handle_();
+    WindowActivity activity = WindowActivity::Focused;
+    if (glfwGetWindowAttrib(handle, GLFW_ICONIFIED) || !glfwGetWindowAttrib(handle, GLFW_VISIBLE) ||
+        m_window.width() == 0 || m_window.height() == 0) {
+        activity = WindowActivity::Hidden;
+    } else if (!glfwGetWindowAttrib(handle, GLFW_FOCUSED)) {
+        activity = WindowActivity::Unfocused;
+    }
+    if (activity != m_window_activity) {
+        static constexpr std::array<std::string_view, 3> ACTIVITY_NAMES{"focused", "unfocused", "hidden"};
+        util::logger("platform")->debug("Window is {}.", ACTIVITY_NAMES[static_cast<int>(activity)]);
+        m_window_activity = activity;
+        // Whatever was skipped while the window was hidden is drawn when it shows up again.
+        m_redraw_requested.store(true, std::memory_order_relaxed);
     }
 }
 
 void PlatformController::swap_buffers() {
-    glfwSwapBuffers(m_window.handle_());
+    if (!m_null_renderer) {
+        glfwSwapBuffers(m_window.handle_());
+    }
+    if (m_frame_input_time >= 0.0) {
+        const float latency_ms = static_cast<float>((glfwGetTime() - m_frame_input_time) * 1000.0);
+        auto &stats = m_input_latency;
+        stats.last_ms = latency_ms;
+        stats.average_ms = stats.frames == 0 ? latency_ms : stats.average_ms + 0.1f * (latency_ms - stats.average_ms);
+        stats.max_ms = std::max(stats.max_ms, latency_ms);
+        ++stats.frames;
+        m_frame_input_time = -1.0;
+    }
+}
+
+void PlatformController::set_fixed_timestep(float dt) {
+    RG_GUARANTEE(dt >= 0.0f, "Fixed timestep can't be negative.");
+    m_fixed_dt = dt;
 }
 
-int glfw_platform_action(GLFWwindow *window, int glfw_key_code) {
-    if (glfw_key_code >= GLFW_MOUSE_BUTTON_1 && glfw_key_code <= GLFW_MOUSE_BUTTON_LAST) {
-        return glfwGetMouseButton(window, glfw_key_code);
+void PlatformController::play_input_recording(InputRecording recording) {
+    RG_GUARANTEE(m_input_recording_path.empty(), "Can't play input back while recording it.");
+    m_input_playback = std::move(recording);
+    m_input_playback_frame = 0;
+    m_playing_input = true;
+}
+
+void PlatformController::play_input_frame() {
+    if (m_input_playback_frame == m_input_playback.frame_count()) {
+        return;
+    }
+    for (const auto &event: m_input_playback.frame(m_input_playback_frame++)) {
+        switch (event.type) {
+            case RecordedInputEvent::Type::Mouse: _platform_on_mouse(event.x, event.y);
+                break;
+            case RecordedInputEvent::Type::Scroll: _platform_on_scroll(event.x, event.y);
+                break;
+            case RecordedInputEvent::Type::Keyboard: _platform_on_keyboard(event.code, event.action);
+                break;
+            case RecordedInputEvent::Type::MouseButton: _platform_on_mouse_button(event.code, event.action);
+                break;
+        }
     }
-    return glfwGetKey(window, glfw_key_code);
+}
+
+MousePosition PlatformController::latch_mouse() {
+    double x, y;
+    glfwGetCursorPos(m_window.handle_(), &x, &y);
+    MousePosition result{};
+    result.x = x;
+    result.y = y;
+    result.dx = x - g_mouse_position.x;
+    result.dy = g_mouse_position.y - y;
+    if (result.dx != 0.0f || result.dy != 0.0f) {
+        // The next cursor events are measured from here, so this motion isn't applied twice.
+        g_mouse_position.x = x;
+        g_mouse_position.y = y;
+        // The input latency stays measured from the input events the frame consumed. Restarting it here would report
+        // latch-to-present, and the latched motion has no event timestamp to measure from.
+    }
+    return result;
+}
+
+void PlatformController::on_key_event(KeyId key, int action) {
+    const double timestamp = glfwGetTime();
+    m_last_input_time = timestamp;
+    KeyEvent::Action event_action = KeyEvent::Action::Repeat;
+    if (action == GLFW_PRESS) {
+        event_action = KeyEvent::Action::Press;
+        m_keys_pending.set(key);
+        m_keys[key].m_timestamp = timestamp;
+    } else if (action == GLFW_RELEASE) {
+        event_action = KeyEvent::Action::Release;
+        m_keys_pending.set(key, false);
+        m_keys[key].m_timestamp = timestamp;
+    }
+    m_key_events.push_back(KeyEvent{key, event_action, timestamp});
 }
 
 /**
- * @brief Updates the state of a key.
- * Key states are repesented as a state machine with the following states: Released, JustPressed, Pressed, JustReleased.
+ * @brief Updates the key states from the events received in this frame.
+ * Key states are represented as a state machine with the following states: Released, JustPressed, Pressed, JustReleased.
  * The state machine transitions are as follows:
  * - Released -> JustPressed if the key is pressed.
  * - JustPressed -> Pressed if the key is still pressed.
  * - Pressed -> JustReleased if the key is released.
  * - JustReleased -> Released if the key is released.
- * @param key_data The key to update.
+ * The transitions are computed for all the keys at once on the packed sets. Only the @ref Key objects of keys
+ * that changed in this or the previous frame are touched.
  */
-void PlatformController::update_key(Key &key_data) const {
-    int engine_key_code = key_data.id();
-    int glfw_key_code = g_engine_to_glfw_key.at(engine_key_code);
-    int action = glfw_platform_action(m_window.handle_(), glfw_key_code);
-    switch (key_data.state()) {
-        case Key::State::Released: {
-            if (action == GLFW_PRESS) {
-                key_data.m_state = Key::State::JustPressed;
-            }
-            break;
-        }
-        case Key::State::JustReleased: {
-            if (action == GLFW_PRESS) {
-                key_data.m_state = Key::State::JustPressed;
-            } else if (action == GLFW_RELEASE) {
-                key_data.m_state = Key::State::Released;
-            }
-            break;
+void PlatformController::update_keys() {
+    const KeySet settling = m_keys_just_pressed | m_keys_just_released;
+    m_keys_previous = m_keys_current;
+    m_keys_current = m_keys_pending;
+    m_keys_just_pressed = m_keys_current - m_keys_previous;
+    m_keys_just_released = m_keys_previous - m_keys_current;
+    (settling | m_keys_just_pressed | m_keys_just_released).for_each([this](KeyId id) {
+        const bool down = m_keys_current.test(id);
+        const bool was_down = m_keys_previous.test(id);
+        Key::State state;
+        if (down) {
+            state = was_down ? Key::State::Pressed : Key::State::JustPressed;
+        } else {
+            state = was_down ? Key::State::JustReleased : Key::State::Released;
         }
-        case Key::State::JustPressed: {
-            if (action == GLFW_RELEASE) {
-                key_data.m_state = Key::State::JustReleased;
-            } else if (action == GLFW_PRESS) {
-                key_data.m_state = Key::State::Pressed;
-            }
-            break;
-        }
-        case Key::State::Pressed: {
-            if (action == GLFW_RELEASE) {
-                key_data.m_state = Key::State::JustReleased;
-            }
-            break;
-        }
-    }
+        m_keys[id].m_state = state;
+    });
 }
 
 std::string_view Key::name() {
@@ -191,37 +421,78 @@ void PlatformController::register_platform_event_observer(std::unique_ptr<Platfo
 }
 
 void PlatformController::_platform_on_mouse(double x, double y) {
+    record_input(RecordedInputEvent{RecordedInputEvent::Type::Mouse, 0, 0, x, y});
     double last_x = g_mouse_position.x;
     double last_y = g_mouse_position.y;
-    g_mouse_position.dx = x - last_x;
-    g_mouse_position.dy = last_y - y; // because in glfw the top left corner is the (0,0)
+    g_mouse_position.dx += x - last_x;
+    g_mouse_position.dy += last_y - y; // because in glfw the top left corner is the (0,0)
     g_mouse_position.x = x;
     g_mouse_position.y = y;
-    for (auto &observer: m_platform_event_observers) {
-        observer->on_mouse_move(g_mouse_position);
+    m_mouse_moved = true;
+    m_last_input_time = glfwGetTime();
+    if (m_mouse_samples_enabled) {
+        m_mouse_samples.push_back(MouseSample{static_cast<float>(x), static_cast<float>(y), m_last_input_time});
     }
 }
 
 void PlatformController::_platform_on_keyboard(int key_code, int action) {
-    const Key result = key(g_glfw_key_to_engine[key_code]);
-    for (auto &observer: m_platform_event_observers) {
-        observer->on_key(result);
+    record_input(RecordedInputEvent{RecordedInputEvent::Type::Keyboard, key_code, action, 0.0, 0.0});
+    if (key_code < 0 || key_code > GLFW_KEY_LAST) {
+        return;
     }
+    on_key_event(g_glfw_key_to_engine[key_code], action);
 }
 
 void PlatformController::_platform_on_scroll(double x, double y) {
-    g_mouse_position.scroll = y;
-    for (auto &observer: m_platform_event_observers) {
-        observer->on_scroll(g_mouse_position);
+    record_input(RecordedInputEvent{RecordedInputEvent::Type::Scroll, 0, 0, x, y});
+    g_mouse_position.scroll += y;
+    m_mouse_scrolled = true;
+    m_last_input_time = glfwGetTime();
+}
+
+void PlatformController::update_mouse() {
+    if (m_mouse_moved) {
+        m_mouse_moved = false;
+        for (auto &observer: m_platform_event_observers) {
+            observer->on_mouse_move(g_mouse_position);
+        }
+    }
+    if (m_mouse_scrolled) {
+        m_mouse_scrolled = false;
+        for (auto &observer: m_platform_event_observers) {
+            observer->on_scroll(g_mouse_position);
+        }
+    }
+    if (!m_mouse_samples.empty()) {
+        for (auto &observer: m_platform_event_observers) {
+            observer->on_mouse_samples(m_mouse_samples);
+        }
+    }
+}
+
+void PlatformController::set_mouse_samples_enabled(bool enabled) {
+    m_mouse_samples_enabled = enabled;
+    if (enabled) {
+        m_mouse_samples.reserve(256);
     }
 }
 
+void PlatformController::set_raw_mouse_motion(bool enabled) {
+    if (enabled && !glfwRawMouseMotionSupported()) {
+        util::logger("platform")->warn("Raw mouse motion is not supported on this platform.");
+        enabled = false;
+    }
+    m_raw_mouse_motion = enabled;
+    glfwSetInputMode(m_window.handle_(), GLFW_RAW_MOUSE_MOTION, enabled ? GLFW_TRUE : GLFW_FALSE);
+}
+
 void PlatformController::_platform_on_framebuffer_resize(int width, int height) {
     m_window.m_width = width;
     m_window.m_height = height;
     for (auto &observer: m_platform_event_observers) {
         observer->on_window_resize(width, height);
     }
+    _platform_on_window_state_change();
 }
 
 void PlatformController::_platform_on_window_close(GLFWwindow *window) {
@@ -231,9 +502,18 @@ void PlatformController::_platform_on_window_close(GLFWwindow *window) {
 }
 
 void PlatformController::_platform_on_mouse_button(int button, int action) {
-    for (auto &observer: m_platform_event_observers) {
-        auto result = key(g_glfw_key_to_engine[button]);
-        observer->on_key(result);
+    record_input(RecordedInputEvent{RecordedInputEvent::Type::MouseButton, button, action, 0.0, 0.0});
+    // Several engine keys name the same button (MOUSE_BUTTON_1 and MOUSE_BUTTON_LEFT...), keep all of them in sync.
+    for (int key = MOUSE_BUTTON_1; key <= MOUSE_BUTTON_MIDDLE; ++key) {
+        if (g_engine_to_glfw_key[key] == button) {
+            on_key_event(static_cast<KeyId>(key), action);
+        }
+    }
+}
+
+void PlatformController::record_input(const RecordedInputEvent &event) {
+    if (!m_input_recording_path.empty()) {
+        m_input_recording.add(event);
     }
 }
 
@@ -252,25 +532,37 @@ void initialize_key_maps() {
     // @formatter:on
 }
 
+// While a recording is played back the live input is dropped, so it can't change the outcome.
 static void glfw_mouse_callback(GLFWwindow *window, double x, double y) {
-    core::Controller::get<PlatformController>()->_platform_on_mouse(x, y);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_playing_input()) {
+        platform->_platform_on_mouse(x, y);
+    }
 }
 
 void glfw_mouse_button_callback(GLFWwindow *window, int button, int action, int mods) {
-    core::Controller::get<PlatformController>()->_platform_on_mouse_button(button, action);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_playing_input()) {
+        platform->_platform_on_mouse_button(button, action);
+    }
 }
 
 static void glfw_scroll_callback(GLFWwindow *window, double x_offset, double y_offset) {
-    g_mouse_position.scroll = y_offset;
-    core::Controller::get<PlatformController>()->_platform_on_scroll(x_offset, y_offset);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_playing_input()) {
+        platform->_platform_on_scroll(x_offset, y_offset);
+    }
 }
 
 static void glfw_key_callback(GLFWwindow *window, int key, int scancode, int action, int mods) {
-    core::Controller::get<PlatformController>()->_platform_on_keyboard(key, action);
+    auto platform = core::Controller::get<PlatformController>();
+    if (!platform->is_playing_input()) {
+        platform->_platform_on_keyboard(key, action);
+    }
 }
 
 static void glfw_framebuffer_size_callback(GLFWwindow *window, int width, int height) {
-    glViewport(0, 0, width, height);
+    CHECKED_GL_CALL(glViewport, 0, 0, width, height);
     core::Controller::get<PlatformController>()->_platform_on_framebuffer_resize(width, height);
 }
 
@@ -278,4 +570,12 @@ void glfw_window_close_callback(GLFWwindow *window) {
     core::Controller::get<PlatformController>()->_platform_on_window_close(window);
 }
 
+static void glfw_window_focus_callback(GLFWwindow *window, int focused) {
+    core::Controller::get<PlatformController>()->_platform_on_window_state_change();
+}
+
+static void glfw_window_iconify_callback(GLFWwindow *window, int iconified) {
+    core::Controller::get<PlatformController>()->_platform_on_window_state_change();
+}
+
 } // namespace engine
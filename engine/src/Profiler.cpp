@@ -0,0 +1,310 @@
+#include <engine/util/Profiler.hpp>
+#include <engine/util/Arena.hpp>
+#include <engine/util/Logging.hpp>
+#include <imgui.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <utility>
+
+namespace engine::util {
+static thread_local Profiler::ThreadRing *g_thread_ring = nullptr;
+
+Profiler *Profiler::instance() {
+    static Profiler profiler;
+    return &profiler;
+}
+
+uint64_t Profiler::now_ns() {
+    static const auto epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::set_enabled(bool enabled) {
+    g_profiler_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::configure(const nlohmann::json &config) {
+    set_thread_name("main");
+    if (!config.contains("profiler")) {
+        return;
+    }
+    const auto &profiler = config["profiler"];
+    set_enabled(profiler.value("enabled", false));
+    m_gui_capture_path = profiler.value<std::string>("capture_path", "profile.json");
+    if (const auto frames = profiler.value<uint32_t>("capture_frames", 0); frames > 0) {
+        start_capture(frames, m_gui_capture_path);
+    }
+}
+
+Profiler::ThreadRing *Profiler::thread_ring() {
+    if (!g_thread_ring) {
+        std::lock_guard lock(m_lanes_mutex);
+        auto ring = std::make_shared<ThreadRing>();
+        ring->lane = static_cast<uint32_t>(m_lane_names.size());
+        m_lane_names.push_back(std::format("thread {}", ring->lane));
+        g_thread_ring = ring.get();
+        // The profiler keeps the ring alive, so zones of a thread that exited are still collected.
+        m_rings.push_back(std::move(ring));
+    }
+    return g_thread_ring;
+}
+
+std::string_view Profiler::current_zone() {
+    return g_thread_ring ? g_thread_ring->zone : std::string_view{};
+}
+
+void Profiler::set_thread_name(std::string name) {
+    const uint32_t lane = thread_ring()->lane;
+    std::lock_guard lock(m_lanes_mutex);
+    m_lane_names[lane] = std::move(name);
+}
+
+uint32_t Profiler::register_lane(std::string name) {
+    std::lock_guard lock(m_lanes_mutex);
+    m_lane_names.push_back(std::move(name));
+    return static_cast<uint32_t>(m_lane_names.size() - 1);
+}
+
+std::string Profiler::lane_name(uint32_t lane) const {
+    std::lock_guard lock(m_lanes_mutex);
+    return m_lane_names.at(lane);
+}
+
+void Profiler::submit(const ProfileZone &zone) {
+    m_current.zones.push_back(zone);
+}
+
+void Profiler::collect_thread_zones(ProfileFrame &frame) {
+    std::lock_guard lock(m_lanes_mutex);
+    for (auto &ring: m_rings) {
+        const uint64_t written = ring->written.load(std::memory_order_acquire);
+        for (uint64_t read = ring->read.load(std::memory_order_relaxed); read < written; ++read) {
+            frame.zones.push_back(ring->zones[read % THREAD_RING_SIZE]);
+        }
+        // Releases the copied slots to the owning thread only now, so it can't overwrite a zone during the copy.
+        ring->read.store(written, std::memory_order_release);
+        m_dropped_zones += ring->dropped.exchange(0, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::new_frame() {
+    const uint64_t now = now_ns();
+    if (is_enabled() || !m_current.zones.empty()) {
+        m_current.end_ns = now;
+        collect_thread_zones(m_current);
+        if (m_capture_remaining > 0) {
+            m_capture.push_back(m_current);
+            if (--m_capture_remaining == 0) {
+                export_chrome_trace(m_capture, m_capture_path);
+                m_capture.clear();
+            }
+        }
+        // Recycles the oldest frame of the history, so that in a steady state the zone vectors don't reallocate.
+        if (m_history.size() < HISTORY_SIZE) {
+            m_history.push_back(std::move(m_current));
+            m_current = ProfileFrame{};
+        } else {
+            std::swap(m_history[m_history_head], m_current);
+        }
+        m_history_head = (m_history_head + 1) % HISTORY_SIZE;
+    }
+    m_current.zones.clear();
+    m_current.index = ++m_frame_index;
+    m_current.begin_ns = now;
+    m_current.end_ns = now;
+}
+
+const ProfileFrame *Profiler::last_frame() const {
+    if (m_history.empty()) {
+        return nullptr;
+    }
+    return &m_history[(m_history_head + HISTORY_SIZE - 1) % HISTORY_SIZE];
+}
+
+const ProfileFrame *Profiler::frame(uint64_t index) const {
+    auto it = std::ranges::find(m_history, index, &ProfileFrame::index);
+    return it != m_history.end() ? &*it : nullptr;
+}
+
+void Profiler::start_capture(uint32_t frame_count, std::filesystem::path path) {
+    set_enabled(true);
+    m_capture.clear();
+    m_capture.reserve(frame_count);
+    m_capture_remaining = frame_count;
+    m_capture_path = std::move(path);
+}
+
+void Profiler::export_chrome_trace(const std::vector<ProfileFrame> &frames, const std::filesystem::path &path) const {
+    auto to_us = [](uint64_t ns) {
+        return static_cast<double>(ns) / 1000.0;
+    };
+    nlohmann::json events = nlohmann::json::array();
+    {
+        std::lock_guard lock(m_lanes_mutex);
+        for (uint32_t lane = 0; lane < m_lane_names.size(); ++lane) {
+            events.push_back({
+                    {"name", "thread_name"},
+                    {"ph", "M"},
+                    {"pid", 0},
+                    {"tid", lane},
+                    {"args", {{"name", m_lane_names[lane]}}}
+            });
+        }
+    }
+    for (const auto &frame: frames) {
+        events.push_back({
+                {"name", std::format("Frame {}", frame.index)},
+                {"cat", "frame"},
+                {"ph", "X"},
+                {"ts", to_us(frame.begin_ns)},
+                {"dur", to_us(frame.end_ns - frame.begin_ns)},
+                {"pid", 0},
+                {"tid", 0}
+        });
+        for (const auto &zone: frame.zones) {
+            events.push_back({
+                    {"name", std::string(zone.name)},
+                    {"cat", zone.category.empty() ? std::string("zone") : std::string(zone.category)},
+                    {"ph", "X"},
+                    {"ts", to_us(zone.begin_ns)},
+                    {"dur", to_us(zone.end_ns - zone.begin_ns)},
+                    {"pid", 0},
+                    {"tid", zone.lane}
+            });
+        }
+    }
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        logger("engine")->error("Profiler: failed to open {} to write the trace.", path.string());
+        return;
+    }
+    file << nlohmann::json{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}};
+    logger("engine")->info("Profiler: wrote {} frames to {}.", frames.size(), path.string());
+}
+
+static ImU32 zone_color(std::string_view name) {
+    static constexpr std::array<ImU32, 6> PALETTE = {
+            IM_COL32(86, 156, 214, 255), IM_COL32(78, 201, 176, 255), IM_COL32(220, 160, 90, 255),
+            IM_COL32(197, 134, 192, 255), IM_COL32(181, 206, 108, 255), IM_COL32(214, 110, 110, 255),
+    };
+    return PALETTE[std::hash<std::string_view>{}(name) % PALETTE.size()];
+}
+
+void Profiler::draw_gui() {
+    ImGui::Begin("CPU profiler");
+    bool enabled = is_enabled();
+    if (ImGui::Checkbox("Enabled", &enabled)) {
+        set_enabled(enabled);
+    }
+    ImGui::SameLine();
+    const bool pause_toggled = ImGui::Checkbox("Pause", &m_gui_paused);
+    ImGui::SameLine();
+    if (is_capturing()) {
+        ImGui::Text("Capturing, %u frames left", m_capture_remaining);
+    } else if (ImGui::Button("Capture 300 frames")) {
+        start_capture(300, m_gui_capture_path);
+    }
+    const ProfileFrame *frame = last_frame();
+    if (!frame) {
+        ImGui::End();
+        return;
+    }
+    // The live frame is drawn in place. It's copied only when the panel is paused, so the panel doesn't allocate
+    // every frame; the copy assignment reuses the zones' capacity of the previous pause.
+    if (pause_toggled && m_gui_paused) {
+        m_gui_frame = *frame;
+    }
+    const ProfileFrame &shown = m_gui_paused ? m_gui_frame : *frame;
+    const double frame_ns = static_cast<double>(std::max<uint64_t>(shown.end_ns - shown.begin_ns, 1));
+    ImGui::Text("Frame %llu: %.3f ms, %zu zones, %llu zones dropped", static_cast<unsigned long long>(shown.index),
+                frame_ns / 1e6, shown.zones.size(), static_cast<unsigned long long>(m_dropped_zones));
+
+    // Flame chart: one band per lane, one row per nesting depth.
+    constexpr float ROW_HEIGHT = 18.0f;
+    constexpr float LABEL_WIDTH = 80.0f;
+    // Other threads add and rename lanes. The copy reuses the strings' capacity, so it doesn't allocate every frame.
+    {
+        std::lock_guard lock(m_lanes_mutex);
+        m_gui_lane_names.assign(m_lane_names.begin(), m_lane_names.end());
+    }
+    // The layout of the lanes only lives for this frame.
+    auto &arena = ds::frame_arena();
+    const auto lane_depth = arena.allocate_array<uint32_t>(m_gui_lane_names.size());
+    std::ranges::fill(lane_depth, 0u);
+    for (const auto &zone: shown.zones) {
+        if (zone.lane < lane_depth.size()) {
+            lane_depth[zone.lane] = std::max(lane_depth[zone.lane], zone.depth + 1);
+        }
+    }
+    const auto lane_y = arena.allocate_array<float>(lane_depth.size());
+    float height = 0.0f;
+    for (std::size_t lane = 0; lane < lane_depth.size(); ++lane) {
+        lane_y[lane] = height;
+        height += lane_depth[lane] > 0 ? lane_depth[lane] * ROW_HEIGHT + 4.0f : 0.0f;
+    }
+
+    ImDrawList *draw_list = ImGui::GetWindowDrawList();
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float width = std::max(ImGui::GetContentRegionAvail().x - LABEL_WIDTH, 1.0f);
+    const float timeline_x = origin.x + LABEL_WIDTH;
+    for (std::size_t lane = 0; lane < lane_depth.size(); ++lane) {
+        if (lane_depth[lane] > 0) {
+            draw_list->AddText(ImVec2(origin.x, origin.y + lane_y[lane]), ImGui::GetColorU32(ImGuiCol_Text),
+                               m_gui_lane_names[lane].c_str());
+        }
+    }
+    for (const auto &zone: shown.zones) {
+        // Zones that belong to an earlier frame, like the GPU zones that are read back a few frames late, are only in the trace.
+        if (zone.lane >= lane_y.size() || zone.end_ns < shown.begin_ns || zone.begin_ns > shown.end_ns) {
+            continue;
+        }
+        const double begin = std::clamp((static_cast<double>(zone.begin_ns) - shown.begin_ns) / frame_ns, 0.0, 1.0);
+        const double end = std::clamp((static_cast<double>(zone.end_ns) - shown.begin_ns) / frame_ns, 0.0, 1.0);
+        const ImVec2 min(timeline_x + static_cast<float>(begin) * width,
+                         origin.y + lane_y[zone.lane] + zone.depth * ROW_HEIGHT);
+        const ImVec2 max(std::max(timeline_x + static_cast<float>(end) * width, min.x + 1.0f), min.y + ROW_HEIGHT - 1.0f);
+        draw_list->AddRectFilled(min, max, zone_color(zone.name));
+        if (max.x - min.x > 30.0f) {
+            draw_list->PushClipRect(min, max, true);
+            draw_list->AddText(ImVec2(min.x + 2.0f, min.y + 1.0f), IM_COL32(0, 0, 0, 255), zone.name.data(),
+                               zone.name.data() + zone.name.size());
+            draw_list->PopClipRect();
+        }
+        if (ImGui::IsMouseHoveringRect(min, max)) {
+            ImGui::SetTooltip("%.*s %.*s\n%.3f ms", static_cast<int>(zone.name.size()), zone.name.data(),
+                              static_cast<int>(zone.category.size()), zone.category.data(),
+                              static_cast<double>(zone.end_ns - zone.begin_ns) / 1e6);
+        }
+    }
+    ImGui::Dummy(ImVec2(LABEL_WIDTH + width, height));
+    ImGui::End();
+}
+
+void ProfileScope::begin(std::string_view name, std::string_view category) {
+    m_ring = Profiler::instance()->thread_ring();
+    m_name = name;
+    m_category = category;
+    m_depth = m_ring->depth++;
+    m_parent_zone = std::exchange(m_ring->zone, name);
+    m_begin_ns = Profiler::now_ns();
+}
+
+void ProfileScope::end() {
+    const uint64_t end_ns = Profiler::now_ns();
+    --m_ring->depth;
+    m_ring->zone = m_parent_zone;
+    const uint64_t written = m_ring->written.load(std::memory_order_relaxed);
+    if (written - m_ring->read.load(std::memory_order_acquire) >= Profiler::THREAD_RING_SIZE) {
+        // Full until the next Profiler::new_frame collects it, which may be copying the oldest zone right now.
+        m_ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_ring->zones[written % Profiler::THREAD_RING_SIZE] = ProfileZone{
+            m_name, m_category, m_begin_ns, end_ns, m_depth, m_ring->lane
+    };
+    m_ring->written.store(written + 1, std::memory_order_release);
+}
+} // namespace engine::util
@@ -0,0 +1,75 @@
+#include <imgui.h>
+#include <engine/graphics/RenderStats.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <format>
+
+namespace engine::graphics {
+void RenderStatsRecorder::begin_frame() {
+    g_render_stats = RenderStats{};
+    g_render_stats.frame = ++m_frame;
+    m_frame_begin_ns = util::Profiler::now_ns();
+}
+
+void RenderStatsRecorder::end_frame() {
+    g_render_stats.submit_ms = static_cast<float>(util::Profiler::now_ns() - m_frame_begin_ns) / 1e6f;
+    m_last = g_render_stats;
+    m_submit_ms_history[m_history_head] = m_last.submit_ms;
+    m_draw_calls_history[m_history_head] = static_cast<float>(m_last.draw_calls);
+    m_history_head = (m_history_head + 1) % HISTORY_SIZE;
+    if (m_csv.is_open()) {
+        write_csv_row(m_last);
+    }
+}
+
+bool RenderStatsRecorder::start_csv(const std::filesystem::path &path) {
+    stop_csv();
+    m_csv.open(path);
+    if (!m_csv.is_open()) {
+        util::logger("graphics")->warn("Failed to open {} to write the render stats.", path.string());
+        return false;
+    }
+    m_csv << "frame,draw_calls,triangles,instances,program_binds,vao_binds,texture_binds,uniform_uploads,"
+            "buffer_bytes_uploaded,gl_calls,submit_ms,gpu_wait_ms\n";
+    util::logger("graphics")->info("Writing render stats to {}.", path.string());
+    return true;
+}
+
+void RenderStatsRecorder::stop_csv() {
+    if (m_csv.is_open()) {
+        m_csv.close();
+    }
+}
+
+void RenderStatsRecorder::write_csv_row(const RenderStats &stats) {
+    m_csv << std::format("{},{},{},{},{},{},{},{},{},{},{:.4f},{:.4f}\n", stats.frame, stats.draw_calls,
+                         stats.triangles, stats.instances, stats.program_binds, stats.vao_binds, stats.texture_binds,
+                         stats.uniform_uploads, stats.buffer_bytes_uploaded, stats.gl_calls, stats.submit_ms,
+                         stats.gpu_wait_ms);
+}
+
+void RenderStatsRecorder::draw_gui() {
+    const auto &s = m_last;
+    ImGui::Begin("Renderer stats");
+    ImGui::Text("Frame %llu", static_cast<unsigned long long>(s.frame));
+    ImGui::Text("Draw calls: %u", s.draw_calls);
+    ImGui::Text("Triangles: %llu", static_cast<unsigned long long>(s.triangles));
+    ImGui::Text("Instances: %u", s.instances);
+    ImGui::Text("Binds: program %u, VAO %u, texture %u", s.program_binds, s.vao_binds, s.texture_binds);
+    ImGui::Text("Uniform uploads: %u", s.uniform_uploads);
+    ImGui::Text("Buffer uploads: %.1f KB", static_cast<double>(s.buffer_bytes_uploaded) / 1024.0);
+    ImGui::Text("Checked GL calls: %u", s.gl_calls);
+    ImGui::Text("CPU submit: %.3f ms", s.submit_ms);
+    ImGui::Text("GPU wait: %.3f ms", s.gpu_wait_ms);
+    ImGui::PlotLines("Submit ms", m_submit_ms_history.data(), HISTORY_SIZE, static_cast<int>(m_history_head));
+    ImGui::PlotLines("Draw calls", m_draw_calls_history.data(), HISTORY_SIZE, static_cast<int>(m_history_head));
+    if (m_csv.is_open()) {
+        if (ImGui::Button("Stop CSV")) {
+            stop_csv();
+        }
+    } else if (ImGui::Button("Write CSV to render_stats.csv")) {
+        start_csv("render_stats.csv");
+    }
+    ImGui::End();
+}
+} // namespace engine::graphics
@@ -1,13 +1,19 @@
+#include <ranges>
 #include <unordered_set>
 #include <utility>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <engine/graphics/GpuResourceTracker.hpp>
 #include <engine/graphics/OpenGL.hpp>
+#include <engine/resources/AssimpSceneProcessor.hpp>
 #include <engine/resources/ResourcesController.hpp>
 #include <engine/resources/ShaderCompiler.hpp>
+#include <engine/util/Arena.hpp>
 #include <engine/util/Configuration.hpp>
 #include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
 #include <spdlog/spdlog.h>
 
 namespace engine::resources {
@@ -17,11 +23,40 @@ void ResourcesController::initialize() {
     load_models();
     load_textures();
     load_skyboxes();
+
+    m_load_profile.log_report();
+    const auto &config = util::Configuration::config();
+    const std::string report_path = config.contains("resources")
+                                        ? config["resources"].value("load_report", "load_report.json")
+                                        : "load_report.json";
+    if (!report_path.empty()) {
+        m_load_profile.write_report(report_path);
+    }
+}
+
+void ResourcesController::terminate() {
+    for (auto &model: m_models | std::views::values) {
+        model->destroy();
+    }
+    for (auto &texture: m_textures | std::views::values) {
+        texture->destroy();
+    }
+    for (auto &skybox: m_sky_boxes | std::views::values) {
+        skybox->destroy();
+    }
+    for (auto &shader: m_shaders | std::views::values) {
+        shader->destroy();
+    }
+    graphics::OpenGL::destroy_skybox_cube();
+    m_models.clear();
+    m_textures.clear();
+    m_sky_boxes.clear();
+    m_shaders.clear();
 }
 
 void ResourcesController::load_shaders() {
     if (!exists(m_shaders_path)) {
-        spdlog::info("[ResourcesController]: no {} found to load the shaders from", m_shaders_path.string());
+        util::logger("resources")->info("[ResourcesController]: no {} found to load the shaders from", m_shaders_path.string());
         return;
     }
     for (const auto &shader_path: std::filesystem::directory_iterator(m_shaders_path)) {
@@ -34,7 +69,7 @@ void ResourcesController::load_shaders() {
 
 void ResourcesController::load_models() {
     if (!exists(m_models_path)) {
-        spdlog::info("[ResourcesController]: no {} found to load the models from", m_models_path.string());
+        util::logger("resources")->info("[ResourcesController]: no {} found to load the models from", m_models_path.string());
         return;
     }
     const auto &config = util::Configuration::config();
@@ -49,7 +84,7 @@ void ResourcesController::load_models() {
 
 void ResourcesController::load_textures() {
     if (!exists(m_textures_path)) {
-        spdlog::info("[ResourcesController]: no {} found to load the textures from", m_textures_path.string());
+        util::logger("resources")->info("[ResourcesController]: no {} found to load the textures from", m_textures_path.string());
         return;
     }
     for (const auto &texture_entry: std::filesystem::directory_iterator(m_textures_path)) {
@@ -61,7 +96,7 @@ void ResourcesController::load_textures() {
 
 void ResourcesController::load_skyboxes() {
     if (!exists(m_skyboxes_path)) {
-        spdlog::info("[ResourcesController]: no {} found to load the skyboxes from", m_skyboxes_path.string());
+        util::logger("resources")->info("[ResourcesController]: no {} found to load the skyboxes from", m_skyboxes_path.string());
         return;
     }
     for (const auto &sky_boxes_entry: std::filesystem::directory_iterator(m_skyboxes_path)) {
@@ -71,110 +106,96 @@ void ResourcesController::load_skyboxes() {
     }
 }
 
-/**
- * @class AssimpSceneProcessor
- * @brief Processes the meshes in an Assimp scene.
- */
-class AssimpSceneProcessor {
-public:
-    /**
-     * @brief Processes the meshes in the scene.
-     * @returns The meshes in the scene.
-     */
-    std::vector<Mesh> process_meshes();
-
-    explicit AssimpSceneProcessor(ResourcesController *resources_controller, const aiScene *scene,
-                                  std::filesystem::path model_path) :
-            m_scene(scene), m_model_path(std::move(model_path)), m_resources_controller(resources_controller) {
-    }
-
-private:
-    void process_node(const aiNode *node);
-
-    void process_mesh(aiMesh *mesh);
-
-    std::vector<Texture *> process_materials(const aiMaterial *material);
-
-    void process_material_type(std::vector<Texture *> &textures, const aiMaterial *material, aiTextureType type);
-
-    static TextureType assimp_texture_type_to_engine(aiTextureType type);
-
-    std::vector<Mesh> m_meshes;
-    const aiScene *m_scene;
-    std::filesystem::path m_model_path;
-    ResourcesController *m_resources_controller;
-};
-
 Model *ResourcesController::model(
         const std::string &name) {
-    auto &result = m_models[name];
-    if (!result) {
-        auto &config = util::Configuration::config();
-        if (!config["resources"]["models"].contains(name)) {
-            throw util::EngineError(util::EngineError::Type::ConfigurationError, std::format(
-                    "No model ({}) specify in config.json. Please add the model to the config.json.",
-                    name));
-        }
-        std::filesystem::path model_path = m_models_path /
-                                           std::filesystem::path(
-                                                   config["resources"]["models"][name]["path"].get<
-                                                           std::string>());
-        Assimp::Importer importer;
-        int flags = aiProcess_Triangulate | aiProcess_GenSmoothNormals |
-                    aiProcess_CalcTangentSpace;
-        if (config["resources"]["models"][name].value<bool>("flip_uvs", false)) {
-            flags |= aiProcess_FlipUVs;
-        }
+    // The slot is only added once the load succeeded, a failed load leaves no null entry behind for terminate.
+    if (auto it = m_models.find(name); it != m_models.end()) {
+        return it->second.get();
+    }
+    auto &config = util::Configuration::config();
+    if (!config["resources"]["models"].contains(name)) {
+        throw util::EngineError(util::EngineError::Type::ConfigurationError, std::format(
+                "No model ({}) specify in config.json. Please add the model to the config.json.",
+                name));
+    }
+    std::filesystem::path model_path = m_models_path /
+                                       std::filesystem::path(
+                                               config["resources"]["models"][name]["path"].get<
+                                                       std::string>());
+    Assimp::Importer importer;
+    int flags = aiProcess_Triangulate | aiProcess_GenSmoothNormals |
+                aiProcess_CalcTangentSpace;
+    if (config["resources"]["models"][name].value<bool>("flip_uvs", false)) {
+        flags |= aiProcess_FlipUVs;
+    }
 
-        spdlog::info("load_model(name={}, path={})", name, model_path.string());
-        const aiScene *scene =
-                importer.ReadFile(model_path, flags);
+    util::logger("resources")->info("load_model(name={}, path={})", name, model_path.string());
+    LoadProfile::Scope load_scope(&m_load_profile, AssetKind::Model, name, model_path);
+    graphics::GpuResourceTracker::OwnerScope owner(name);
+    auto &timings = g_asset_load_timings;
+    // Assimp reads and imports the file in one call, the import time includes the file I/O.
+    uint64_t stage_begin = util::Profiler::now_ns();
+    const aiScene *scene =
+            importer.ReadFile(model_path, 0);
+    if (scene) {
+        timings.decode_ns += util::Profiler::now_ns() - stage_begin;
+        timings.bytes_read += std::filesystem::file_size(model_path);
+        stage_begin = util::Profiler::now_ns();
+        scene = importer.ApplyPostProcessing(flags);
+    }
 
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-            throw util::EngineError(util::EngineError::Type::AssetLoadingError,
-                                    std::format("Assimp error while reading model: {} from path {}.",
-                                                model_path.string(), name));
-        }
-        AssimpSceneProcessor scene_processor(this, scene, model_path);
-        std::vector<Mesh> meshes = scene_processor.process_meshes();
-        result = std::make_unique<Model>(Model(std::move(meshes), model_path,
-                                               name));
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        throw util::EngineError(util::EngineError::Type::AssetLoadingError,
+                                std::format("Assimp error while reading model: {} from path {}.",
+                                            model_path.string(), name));
     }
-    return result.get();
+    AssimpSceneProcessor scene_processor(this, scene, model_path);
+    std::vector<Mesh> meshes = scene_processor.process_meshes();
+    // The mesh uploads and the textures the materials load are measured on their own.
+    timings.post_process_ns += util::Profiler::now_ns() - stage_begin - timings.upload_ns - timings.nested_ns;
+    auto model = std::make_unique<Model>(Model(std::move(meshes), model_path,
+                                               name));
+    return m_models.emplace(name, std::move(model)).first->second.get();
 }
 
 Texture *ResourcesController::texture(const std::string &name,
                                       const std::filesystem::path &path,
                                       TextureType type, bool flip_uvs) {
-    auto &result = m_textures[name];
-    if (!result) {
-        spdlog::info("load_texture(path={})", path.string());
-        result = std::make_unique<Texture>(Texture(graphics::OpenGL::generate_texture(path, flip_uvs), type, path,
-                                                   path.stem()));
+    if (auto it = m_textures.find(name); it != m_textures.end()) {
+        return it->second.get();
     }
-    return result.get();
+    util::logger("resources")->info("load_texture(path={})", path.string());
+    LoadProfile::Scope load_scope(&m_load_profile, AssetKind::Texture, name, path);
+    graphics::GpuResourceTracker::OwnerScope owner(name);
+    auto texture = std::make_unique<Texture>(Texture(graphics::OpenGL::generate_texture(path, flip_uvs), type, path,
+                                                     path.stem()));
+    return m_textures.emplace(name, std::move(texture)).first->second.get();
 }
 
 Skybox *ResourcesController::skybox(const std::string &name,
                                     const std::filesystem::path &path,
                                     bool flip_uvs) {
-    auto &result = m_sky_boxes[name];
-    if (!result) {
-        spdlog::info("load_skybox(path={})", path.string());
-        result = std::make_unique<Skybox>(Skybox(graphics::OpenGL::init_skybox_cube(),
-                                                 graphics::OpenGL::load_skybox_textures(path, flip_uvs),
-                                                 path, name));
+    if (auto it = m_sky_boxes.find(name); it != m_sky_boxes.end()) {
+        return it->second.get();
     }
-    return result.get();
+    util::logger("resources")->info("load_skybox(path={})", path.string());
+    LoadProfile::Scope load_scope(&m_load_profile, AssetKind::Skybox, name, path);
+    graphics::GpuResourceTracker::OwnerScope owner(name);
+    auto skybox = std::make_unique<Skybox>(Skybox(graphics::OpenGL::init_skybox_cube(),
+                                                  graphics::OpenGL::load_skybox_textures(path, flip_uvs),
+                                                  path, name));
+    return m_sky_boxes.emplace(name, std::move(skybox)).first->second.get();
 }
 
 Shader *ResourcesController::shader(const std::string &name, const std::filesystem::path &path) {
-    auto &result = m_shaders[name];
-    if (!result) {
-        spdlog::info("load_shader(path={})", path.string());
-        result = std::make_unique<Shader>(ShaderCompiler::compile_from_file(name, path));
+    if (auto it = m_shaders.find(name); it != m_shaders.end()) {
+        return it->second.get();
     }
-    return result.get();
+    util::logger("resources")->info("load_shader(path={})", path.string());
+    LoadProfile::Scope load_scope(&m_load_profile, AssetKind::Shader, name, path);
+    graphics::GpuResourceTracker::OwnerScope owner(name);
+    auto shader = std::make_unique<Shader>(ShaderCompiler::compile_from_file(name, path));
+    return m_shaders.emplace(name, std::move(shader)).first->second.get();
 }
 
 std::vector<Mesh> AssimpSceneProcessor::process_meshes() {
@@ -194,7 +215,9 @@ void AssimpSceneProcessor::process_node(const aiNode *node) {
 }
 
 void AssimpSceneProcessor::process_mesh(aiMesh *mesh) {
-    std::vector<Vertex> vertices;
+    // Vertex and index data only live until they are uploaded to the GPU, so they go into the scratch arena.
+    util::ds::ScratchScope scratch;
+    std::pmr::vector<Vertex> vertices(scratch.resource());
     vertices.reserve(mesh->mNumVertices);
     for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
         Vertex vertex{};
@@ -237,7 +260,8 @@ void AssimpSceneProcessor::process_mesh(aiMesh *mesh) {
         vertices.push_back(vertex);
     }
 
-    std::vector<uint32_t> indices;
+    std::pmr::vector<uint32_t> indices(scratch.resource());
+    indices.reserve(mesh->mNumFaces * 3);
     for (uint32_t i = 0; i < mesh->mNumFaces; ++i) {
         aiFace face = mesh->mFaces[i];
 
@@ -247,12 +271,12 @@ void AssimpSceneProcessor::process_mesh(aiMesh *mesh) {
     }
 
     auto material = m_scene->mMaterials[mesh->mMaterialIndex];
-    std::vector<Texture *> textures = process_materials(material);
+    MeshTextures textures = process_materials(material);
     m_meshes.emplace_back(Mesh(vertices, indices, std::move(textures)));
 }
 
-std::vector<Texture *> AssimpSceneProcessor::process_materials(const aiMaterial *material) {
-    std::vector<Texture *> textures;
+MeshTextures AssimpSceneProcessor::process_materials(const aiMaterial *material) {
+    MeshTextures textures;
     auto ai_texture_types = {
             aiTextureType_DIFFUSE,
             aiTextureType_SPECULAR,
@@ -266,7 +290,7 @@ std::vector<Texture *> AssimpSceneProcessor::process_materials(const aiMaterial
     return textures;
 }
 
-void AssimpSceneProcessor::process_material_type(std::vector<Texture *> &textures, const aiMaterial *material,
+void AssimpSceneProcessor::process_material_type(MeshTextures &textures, const aiMaterial *material,
                                                  aiTextureType type) {
     auto material_count = material->GetTextureCount(type);
     for (uint32_t i = 0; i < material_count; ++i) {
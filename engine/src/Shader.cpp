@@ -1,15 +1,20 @@
 #include <glad/glad.h>
 #include <engine/resources/Shader.hpp>
+#include <engine/graphics/GpuResourceTracker.hpp>
 #include <engine/graphics/OpenGL.hpp>
+#include <engine/util/Errors.hpp>
+#include <format>
 
 namespace engine::resources {
 
 void Shader::use() const {
-    glUseProgram(m_shader_id);
+    CHECKED_GL_CALL(glUseProgram, m_shader_id);
+    ++graphics::g_render_stats.program_binds;
 }
 
 void Shader::destroy() const {
-    glDeleteProgram(m_shader_id);
+    CHECKED_GL_CALL(glDeleteProgram, m_shader_id);
+    graphics::GpuResourceTracker::instance()->on_delete(graphics::GlObjectType::Program, m_shader_id);
 }
 
 unsigned Shader::id() const {
@@ -18,49 +23,91 @@ unsigned Shader::id() const {
 
 void Shader::set_bool(const std::string &name, bool value) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniform1i, location, static_cast<int>(value));
 }
 
 void Shader::set_int(const std::string &name, int value) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniform1i, location, value);
 }
 
 void Shader::set_float(const std::string &name, float value) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniform1f, location, value);
 }
 
 void Shader::set_vec2(const std::string &name, const glm::vec2 &value) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniform2fv, location, 1, &value[0]);
 }
 
 void Shader::set_vec3(const std::string &name, const glm::vec3 &value) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniform3fv, location, 1, &value[0]);
 }
 
 void Shader::set_vec4(const std::string &name, const glm::vec4 &value) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniform4fv, location, 1, &value[0]);
 }
 
 void Shader::set_mat2(const std::string &name, const glm::mat2 &mat) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniformMatrix2fv, location, 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::set_mat3(const std::string &name, const glm::mat3 &mat) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniformMatrix3fv, location, 1, GL_FALSE, &mat[0][0]);
 }
 
 void Shader::set_mat4(const std::string &name, const glm::mat4 &mat) const {
     uint32_t location = CHECKED_GL_CALL(glGetUniformLocation, m_shader_id, name.c_str());
+    ++graphics::g_render_stats.uniform_uploads;
     CHECKED_GL_CALL(glUniformMatrix4fv, location, 1, GL_FALSE, &mat[0][0]);
 }
 
+bool Shader::bind_uniform_block(std::string_view block, uint32_t binding,
+                                std::span<const graphics::UniformMember> members, std::size_t size) const {
+    const std::string block_name(block);
+    const GLuint block_index = CHECKED_GL_CALL(glGetUniformBlockIndex, m_shader_id, block_name.c_str());
+    if (block_index == GL_INVALID_INDEX) {
+        return false;
+    }
+    GLint block_size = 0;
+    CHECKED_GL_CALL(glGetActiveUniformBlockiv, m_shader_id, block_index, GL_UNIFORM_BLOCK_DATA_SIZE, &block_size);
+    RG_GUARANTEE(static_cast<std::size_t>(block_size) == size,
+                 "Uniform block {} of shader {} is {} B, but its C++ struct is {} B.", block, m_name, block_size, size);
+    for (const auto &member: members) {
+        // Members of a block with an instance name are reflected as Block.member.
+        GLuint index = GL_INVALID_INDEX;
+        for (const std::string &name: {std::string(member.name), std::format("{}.{}", block, member.name)}) {
+            const GLchar *names[] = {name.c_str()};
+            CHECKED_GL_CALL(glGetUniformIndices, m_shader_id, 1, names, &index);
+            if (index != GL_INVALID_INDEX) {
+                break;
+            }
+        }
+        RG_GUARANTEE(index != GL_INVALID_INDEX, "Uniform block {} of shader {} has no member {}.", block, m_name,
+                     member.name);
+        GLint offset = 0;
+        CHECKED_GL_CALL(glGetActiveUniformsiv, m_shader_id, 1, &index, GL_UNIFORM_OFFSET, &offset);
+        RG_GUARANTEE(static_cast<std::size_t>(offset) == member.offset,
+                     "Member {} of uniform block {} in shader {} is at offset {}, but at {} in its C++ struct.",
+                     member.name, block, m_name, offset, member.offset);
+    }
+    CHECKED_GL_CALL(glUniformBlockBinding, m_shader_id, block_index, binding);
+    return true;
+}
+
 Shader::Shader(unsigned shader_id, std::string name, std::string source, std::filesystem::path source_path) :
         m_shader_id(shader_id)
         , m_name(std::move(name))
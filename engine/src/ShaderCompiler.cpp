@@ -1,8 +1,13 @@
 #include <glad/glad.h>
+#include <engine/resources/LoadProfile.hpp>
 #include <engine/resources/ShaderCompiler.hpp>
 #include <engine/util/Errors.hpp>
+#include <engine/util/HitchDetector.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
 #include <format>
 #include <spdlog/spdlog.h>
+#include <engine/graphics/GpuResourceTracker.hpp>
 #include <engine/graphics/OpenGL.hpp>
 
 namespace engine::resources {
@@ -11,7 +16,7 @@ using namespace graphics;
 int to_opengl_type(ShaderType type);
 
 Shader ShaderCompiler::compile_from_source(std::string shader_name, std::string shader_source) {
-    spdlog::info("ShaderCompiler::Compiling: {}", shader_name);
+    util::logger("resources")->info("ShaderCompiler::Compiling: {}", shader_name);
     ShaderCompiler compiler(std::move(shader_name), std::move(shader_source));
     ShaderParsingResult parsing_result = compiler.parse_source();
     OpenGL::ShaderProgramId shader_program = compiler.compile(parsing_result);
@@ -20,27 +25,32 @@ Shader ShaderCompiler::compile_from_source(std::string shader_name, std::string
 }
 
 OpenGL::ShaderProgramId ShaderCompiler::compile(const ShaderParsingResult &shader_sources) {
-    uint32_t shader_program_id = glCreateProgram();
+    uint32_t shader_program_id = CHECKED_GL_CALL(glCreateProgram);
     uint32_t vertex_shader_id = 0;
     uint32_t fragment_shader_id = 0;
     uint32_t geometry_shader_id = 0;
     defer {
-        glDeleteShader(vertex_shader_id);
-        glDeleteShader(fragment_shader_id);
-        glDeleteShader(geometry_shader_id);
+        // The shaders that weren't created are 0, there is nothing to delete or to capture for them.
+        for (const uint32_t shader_id: {vertex_shader_id, fragment_shader_id, geometry_shader_id}) {
+            if (shader_id != 0) {
+                CHECKED_GL_CALL(glDeleteShader, shader_id);
+            }
+        }
     };
 
     vertex_shader_id = compile(shader_sources.vertex_shader, ShaderType::Vertex);
-    glAttachShader(shader_program_id, vertex_shader_id);
+    CHECKED_GL_CALL(glAttachShader, shader_program_id, vertex_shader_id);
     fragment_shader_id = compile(shader_sources.fragment_shader, ShaderType::Fragment);
-    glAttachShader(shader_program_id, fragment_shader_id);
+    CHECKED_GL_CALL(glAttachShader, shader_program_id, fragment_shader_id);
 
     if (!shader_sources.geometry_shader
                        .empty()) {
         geometry_shader_id = compile(shader_sources.geometry_shader, ShaderType::Geometry);
-        glAttachShader(shader_program_id, geometry_shader_id);
+        CHECKED_GL_CALL(glAttachShader, shader_program_id, geometry_shader_id);
     }
-    glLinkProgram(shader_program_id);
+    CHECKED_GL_CALL(glLinkProgram, shader_program_id);
+    ++util::g_frame_events.shader_compiles;
+    GpuResourceTracker::instance()->on_create(GlObjectType::Program, shader_program_id, "shader");
     return shader_program_id;
 }
 
@@ -86,10 +96,20 @@ Shader ShaderCompiler::compile_from_file(std::string shader_name,
                                             shader_path.string(),
                                             shader_name));
     }
+    auto &timings = g_asset_load_timings;
+    uint64_t stage_begin = util::Profiler::now_ns();
     std::string shader_source = util::read_text_file(shader_path);
+    timings.io_ns += util::Profiler::now_ns() - stage_begin;
+    timings.bytes_read += shader_source.size();
+
+    stage_begin = util::Profiler::now_ns();
     ShaderCompiler compiler(std::move(shader_name), std::move(shader_source));
     ShaderParsingResult parsing_result = compiler.parse_source();
+    timings.decode_ns += util::Profiler::now_ns() - stage_begin;
+
+    stage_begin = util::Profiler::now_ns();
     OpenGL::ShaderProgramId shader_program = compiler.compile(parsing_result);
+    timings.upload_ns += util::Profiler::now_ns() - stage_begin;
     Shader result(shader_program, shader_name, shader_source, shader_path);
     return result;
 }
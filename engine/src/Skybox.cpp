@@ -0,0 +1,13 @@
+#include <glad/glad.h>
+#include <engine/graphics/GpuResourceTracker.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/resources/Skybox.hpp>
+
+namespace engine::resources {
+void Skybox::destroy() {
+    // The cube VAO is shared by all the skyboxes, see graphics::OpenGL::destroy_skybox_cube.
+    CHECKED_GL_CALL(glDeleteTextures, 1, &m_texture_id);
+    graphics::GpuResourceTracker::instance()->on_delete(graphics::GlObjectType::Texture, m_texture_id);
+    m_texture_id = 0;
+}
+} // namespace engine::resources
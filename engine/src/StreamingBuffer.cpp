@@ -0,0 +1,163 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <engine/graphics/GpuResourceTracker.hpp>
+#include <engine/graphics/OpenGL.hpp>
+#include <engine/graphics/StreamingBuffer.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/HitchDetector.hpp>
+#include <engine/util/Logging.hpp>
+#include <engine/util/Profiler.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace engine::graphics {
+// ARB_buffer_storage isn't part of the 3.3 core profile glad was generated for.
+static constexpr GLbitfield GL_MAP_PERSISTENT_BIT_ARB = 0x0040;
+static constexpr GLbitfield GL_MAP_COHERENT_BIT_ARB = 0x0080;
+
+using BufferStorageFn = void (APIENTRY *)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+static constexpr GLuint64 STALL_TIMEOUT_NS = 100'000'000;
+
+static BufferStorageFn load_buffer_storage() {
+    if (!OpenGL::has_version(4, 4) && !OpenGL::has_extension("GL_ARB_buffer_storage")) {
+        return nullptr;
+    }
+    return reinterpret_cast<BufferStorageFn>(glfwGetProcAddress("glBufferStorage"));
+}
+
+void StreamingBuffer::create(std::size_t frame_capacity, std::string_view category) {
+    RG_GUARANTEE(!is_created(), "The streaming buffer is already created.");
+    RG_GUARANTEE(frame_capacity > 0, "The streaming buffer needs a non-zero capacity.");
+    m_frame_capacity = frame_capacity;
+    const auto size = static_cast<GLsizeiptr>(frame_capacity * FRAME_COUNT);
+    CHECKED_GL_CALL(glGenBuffers, 1, &m_buffer);
+    // The copy target leaves the array and element bindings of the app's vertex arrays alone.
+    CHECKED_GL_CALL(glBindBuffer, GL_COPY_WRITE_BUFFER, m_buffer);
+    if (const auto buffer_storage = load_buffer_storage()) {
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT_ARB | GL_MAP_COHERENT_BIT_ARB;
+        CHECKED_GL_CALL(buffer_storage, GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+        m_persistent = static_cast<uint8_t *>(CHECKED_GL_CALL(glMapBufferRange, GL_COPY_WRITE_BUFFER, 0, size, flags));
+        RG_GUARANTEE(m_persistent, "Failed to map the streaming buffer.");
+    } else {
+        CHECKED_GL_CALL(glBufferData, GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+    CHECKED_GL_CALL(glBindBuffer, GL_COPY_WRITE_BUFFER, 0);
+    ++util::g_frame_events.buffer_allocations;
+    util::g_frame_events.buffer_allocation_bytes += size;
+    GpuResourceTracker::instance()->on_create(GlObjectType::Buffer, m_buffer, category, size);
+    util::logger("graphics")->info("Streaming buffer: {} KB per frame, {}.", frame_capacity / 1024,
+                                   is_persistent() ? "persistently mapped" : "mapped per batch");
+}
+
+void StreamingBuffer::destroy() {
+    if (!is_created()) {
+        return;
+    }
+    for (auto &fence: m_fences) {
+        if (fence) {
+            CHECKED_GL_CALL(glDeleteSync, static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+    if (m_persistent || m_mapped) {
+        CHECKED_GL_CALL(glBindBuffer, GL_COPY_WRITE_BUFFER, m_buffer);
+        CHECKED_GL_CALL(glUnmapBuffer, GL_COPY_WRITE_BUFFER);
+        CHECKED_GL_CALL(glBindBuffer, GL_COPY_WRITE_BUFFER, 0);
+        m_persistent = m_mapped = nullptr;
+    }
+    CHECKED_GL_CALL(glDeleteBuffers, 1, &m_buffer);
+    GpuResourceTracker::instance()->on_delete(GlObjectType::Buffer, m_buffer);
+    m_buffer = 0;
+    if (m_stalls > 0) {
+        util::logger("graphics")->warn("The streaming buffer waited for the GPU {} times, {:.2f} ms in total.", m_stalls,
+                                       static_cast<double>(m_stall_ns) / 1e6);
+    }
+}
+
+void StreamingBuffer::begin_frame() {
+    m_region = (m_region + 1) % FRAME_COUNT;
+    m_head = 0;
+    m_captured_head = 0;
+    m_capturing = g_gl_capture != nullptr;
+    if (m_capturing) {
+        m_capture_shadow.resize(m_frame_capacity);
+    }
+    auto &fence = m_fences[m_region];
+    if (!fence) {
+        return;
+    }
+    const auto sync = static_cast<GLsync>(fence);
+    GLenum status = CHECKED_GL_CALL(glClientWaitSync, sync, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        const uint64_t begin_ns = util::Profiler::now_ns();
+        do {
+            status = CHECKED_GL_CALL(glClientWaitSync, sync, GL_SYNC_FLUSH_COMMANDS_BIT, STALL_TIMEOUT_NS);
+        } while (status == GL_TIMEOUT_EXPIRED);
+        ++m_stalls;
+        m_stall_ns += util::Profiler::now_ns() - begin_ns;
+    }
+    RG_GUARANTEE(status != GL_WAIT_FAILED, "Waiting for the streaming buffer fence failed.");
+    CHECKED_GL_CALL(glDeleteSync, sync);
+    fence = nullptr;
+}
+
+StreamingAllocation StreamingBuffer::allocate(std::size_t bytes, std::size_t alignment) {
+    RG_GUARANTEE(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment {} is not a power of two.", alignment);
+    const std::size_t offset = (m_head + alignment - 1) & ~(alignment - 1);
+    RG_GUARANTEE(offset + bytes <= m_frame_capacity,
+                 "The streaming buffer is out of space: {} B requested, {} of {} B used this frame.", bytes, m_head,
+                 m_frame_capacity);
+    m_head = offset + bytes;
+    m_peak_used = std::max(m_peak_used, m_head);
+    g_render_stats.buffer_bytes_uploaded += bytes;
+    if (m_persistent) {
+        uint8_t *data = m_capturing ? m_capture_shadow.data() + offset : m_persistent + region_begin() + offset;
+        return {data, region_begin() + offset};
+    }
+    if (!m_mapped) {
+        // The GPU is done with the region, its fence was waited for in begin_frame, so nothing needs to synchronize.
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        CHECKED_GL_CALL(glBindBuffer, GL_COPY_WRITE_BUFFER, m_buffer);
+        m_mapped = static_cast<uint8_t *>(CHECKED_GL_CALL(glMapBufferRange, GL_COPY_WRITE_BUFFER,
+                                                          static_cast<GLintptr>(region_begin() + offset),
+                                                          static_cast<GLsizeiptr>(m_frame_capacity - offset), flags));
+        CHECKED_GL_CALL(glBindBuffer, GL_COPY_WRITE_BUFFER, 0);
+        RG_GUARANTEE(m_mapped, "Failed to map the streaming buffer.");
+        m_mapped_begin = offset;
+    }
+    uint8_t *data = m_capturing ? m_capture_shadow.data() + offset : m_mapped + (offset - m_mapped_begin);
+    return {data, region_begin() + offset};
+}
+
+void StreamingBuffer::flush() {
+    // While capturing, the writes since the last flush are in the shadow, they go to the mapping and into the capture.
+    // The capture gets them after the unmap, the replay can't upload into a buffer that's mapped for 3.3.
+    const bool capture = m_capturing && m_head > m_captured_head;
+    const std::size_t capture_begin = m_mapped ? m_mapped_begin : m_captured_head;
+    if (capture) {
+        uint8_t *target = m_mapped ? m_mapped : m_persistent + region_begin() + capture_begin;
+        std::memcpy(target, m_capture_shadow.data() + capture_begin, m_head - capture_begin);
+    }
+    if (m_mapped) {
+        CHECKED_GL_CALL(glBindBuffer, GL_COPY_WRITE_BUFFER, m_buffer);
+        CHECKED_GL_CALL(glUnmapBuffer, GL_COPY_WRITE_BUFFER);
+        CHECKED_GL_CALL(glBindBuffer, GL_COPY_WRITE_BUFFER, 0);
+        m_mapped = nullptr;
+    }
+    if (capture && g_gl_capture) {
+        g_gl_capture->record_buffer_data(m_buffer, region_begin() + capture_begin,
+                                         m_capture_shadow.data() + capture_begin, m_head - capture_begin);
+    }
+    m_captured_head = m_head;
+}
+
+void StreamingBuffer::end_frame() {
+    flush();
+    if (m_head == 0) {
+        // Nothing was written, the region can be reused right away.
+        return;
+    }
+    m_fences[m_region] = CHECKED_GL_CALL(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+} // namespace engine::graphics
@@ -1,7 +1,7 @@
 
 #include <engine/util/Utils.hpp>
 #include <engine/util/Errors.hpp>
-#include <spdlog/spdlog.h>
+#include <engine/util/Logging.hpp>
 #include <fstream>
 #include <engine/util/Configuration.hpp>
 #include <engine/util/ArgParser.hpp>
@@ -17,11 +17,13 @@ void tracing_off() {
     g_tracing = false;
 }
 
+#ifdef RG_ENGINE_TRACE
 void trace(std::source_location location) {
     if (g_tracing) {
-        spdlog::info("{}, in {}:{}", location.function_name(), location.file_name(), location.line());
+        logger("engine")->info("{}, in {}:{}", location.function_name(), location.file_name(), location.line());
     }
 }
+#endif
 
 void Configuration::initialize() {
     auto config_path = get_config_path();
@@ -40,7 +42,7 @@ void Configuration::initialize() {
                 "Please make sure that the file is in the correct json format.",
                 message));
     }
-    spdlog::info("Configuration initialized.");
+    logger("engine")->info("Configuration initialized.");
 }
 
 std::filesystem::path Configuration::get_config_path() {
@@ -83,7 +85,7 @@ ArgParser *ArgParser::instance() {
 void ArgParser::initialize(int argc, char **argv) {
     m_argc = argc;
     m_argv = argv;
-    spdlog::info("ArgParser initialized.");
+    logger("engine")->info("ArgParser initialized.");
 }
 
 std::string ArgParser::get_arg_value(std::string_view arg_name) {
@@ -105,4 +107,12 @@ std::string read_text_file(const std::filesystem::path &path) {
     ss << file.rdbuf();
     return ss.str();
 }
+
+std::vector<uint8_t> read_binary_file(const std::filesystem::path &path) {
+    RG_GUARANTEE(std::filesystem::exists(path), "File {} doesn't exist.", path.string());
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> bytes(std::filesystem::file_size(path));
+    file.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return bytes;
+}
 } // namespace engine
@@ -37,9 +37,12 @@ private:
 
     void update_camera();
 
+    void late_latch_camera();
+
     float m_backpack_scale{1.0f};
     bool m_draw_gui{false};
     bool m_cursor_enabled{true};
+    bool m_late_latch{false};
 };
 }
 #endif //MAINCONTROLLER_HPP
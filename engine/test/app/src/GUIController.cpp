@@ -1,7 +1,9 @@
 #include <imgui.h>
 #include <engine/core/Engine.hpp>
 #include <app/GUIController.hpp>
+#include <engine/graphics/GpuResourceTracker.hpp>
 #include <engine/graphics/GraphicsController.hpp>
+#include <engine/util/AllocationTracker.hpp>
 
 namespace engine::test::app {
 void GUIController::initialize() {
@@ -41,6 +43,27 @@ void GUIController::draw() {
                                                     .y, c.Front
                                                          .z);
     ImGui::End();
+
+    const auto &latency = engine::core::Controller::get<platform::PlatformController>()->input_latency();
+    ImGui::Begin("Input latency");
+    ImGui::Text("Input to present: %.2f ms (avg %.2f ms, max %.2f ms)", latency.last_ms, latency.average_ms,
+                latency.max_ms);
+    ImGui::End();
+
+    auto platform = engine::core::Controller::get<platform::PlatformController>();
+    ImGui::Begin("Idle");
+    bool on_demand = platform->on_demand();
+    if (ImGui::Checkbox("Draw on demand", &on_demand)) {
+        platform->set_on_demand(on_demand);
+    }
+    ImGui::End();
+    platform->frame_pacer()->draw_gui();
+    engine::util::Profiler::instance()->draw_gui();
+    graphics->gpu_profiler()->draw_gui();
+    graphics->render_stats()->draw_gui();
+    engine::graphics::GpuResourceTracker::instance()->draw_gui();
+    engine::util::AllocationTracker::instance()->draw_gui();
+    engine::core::Controller::get<engine::resources::ResourcesController>()->load_profile()->draw_gui();
     graphics->end_gui();
 }
 }
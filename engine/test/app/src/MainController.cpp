@@ -1,5 +1,5 @@
 #include <memory>
-#include <spdlog/spdlog.h>
+#include <engine/util/Logging.hpp>
 #include <engine/core/Engine.hpp>
 #include <engine/graphics/GraphicsController.hpp>
 #include <app/MainController.hpp>
@@ -7,16 +7,20 @@
 
 namespace engine::test::app {
 void MainPlatformEventObserver::on_key(engine::platform::Key key) {
-    spdlog::info("Keyboard event: key={}, state={}", key.name(), key.state_str());
+    engine::util::logger("app")->info("Keyboard event: key={}, state={}", key.name(), key.state_str());
 }
 
 void MainPlatformEventObserver::on_mouse_move(engine::platform::MousePosition position) {
-    spdlog::info("MousePosition: {} {}", position.x, position.y);
+    SPDLOG_LOGGER_TRACE(engine::util::logger("app"), "MousePosition: {} {}", position.x, position.y);
 }
 
 void MainController::initialize() {
     // User initialization
     engine::graphics::OpenGL::enable_depth_testing();
+    auto &config = engine::util::Configuration::config();
+    if (config.contains("input")) {
+        m_late_latch = config["input"].value("late_latch", false);
+    }
 
     auto observer = std::make_unique<MainPlatformEventObserver>();
     engine::core::Controller::get<engine::platform::PlatformController>()->register_platform_event_observer(
@@ -50,6 +54,9 @@ void MainController::begin_draw() {
 }
 
 void MainController::draw() {
+    if (m_late_latch) {
+        late_latch_camera();
+    }
     draw_backpack();
     draw_skybox();
 }
@@ -59,6 +66,7 @@ void MainController::end_draw() {
 }
 
 void MainController::draw_backpack() {
+    RG_GPU_SCOPE("backpack");
     auto graphics = engine::core::Controller::get<engine::graphics::GraphicsController>();
     auto shader = engine::core::Controller::get<engine::resources::ResourcesController>()->shader("basic");
     auto backpack = engine::core::Controller::get<engine::resources::ResourcesController>()->model("backpack");
@@ -71,6 +79,7 @@ void MainController::draw_backpack() {
 }
 
 void MainController::draw_skybox() {
+    RG_GPU_SCOPE("skybox");
     auto shader = engine::core::Controller::get<engine::resources::ResourcesController>()->shader("skybox");
     auto skybox_cube = engine::core::Controller::get<engine::resources::ResourcesController>()->skybox("skybox");
     engine::core::Controller::get<engine::graphics::GraphicsController>()->draw_skybox(shader, skybox_cube);
@@ -104,6 +113,17 @@ void MainController::update_camera() {
     camera->rotate_camera(mouse.dx, mouse.dy);
     camera->zoom(mouse.scroll);
 }
+
+void MainController::late_latch_camera() {
+    auto gui = engine::core::Controller::get<GUIController>();
+    if (gui->is_enabled()) {
+        return;
+    }
+    auto platform = engine::core::Controller::get<engine::platform::PlatformController>();
+    auto camera = engine::core::Controller::get<engine::graphics::GraphicsController>()->camera();
+    auto mouse = platform->latch_mouse();
+    camera->rotate_camera(mouse.dx, mouse.dy);
+}
 }
 
 
@@ -0,0 +1,122 @@
+
+#ifndef MATF_RG_PROJECT_STRESS_SCENE_GENERATOR_HPP
+#define MATF_RG_PROJECT_STRESS_SCENE_GENERATOR_HPP
+
+#include <glm/glm.hpp>
+#include <json.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace engine::test::stress {
+enum class Layout {
+    Grid,
+    Random,
+    /**
+    * @brief Objects are gathered around a few random centers, so some parts of the view are much denser than others.
+    */
+    Clustered,
+};
+
+/**
+* @struct SceneParams
+* @brief The `stress` section of the config.json.
+*/
+struct SceneParams {
+    Layout layout{Layout::Grid};
+    uint32_t models{4};
+    uint32_t materials{16};
+    uint32_t textures{8};
+    uint32_t lights{8};
+    uint32_t shader_variants{4};
+    uint32_t clusters{8};
+    float spacing{2.5f};
+    uint32_t seed{1};
+
+    static SceneParams from_config(const nlohmann::json &config);
+};
+
+struct StressMaterial {
+    uint32_t shader_variant;
+    uint32_t texture;
+    glm::vec3 tint;
+};
+
+struct StressLight {
+    glm::vec3 position;
+    glm::vec3 color;
+};
+
+struct StressObject {
+    uint32_t model;
+    uint32_t material;
+    glm::mat4 transform;
+};
+
+/**
+* @class SceneGenerator
+* @brief Generates the assets and the layouts of the stress scene. The same parameters always generate the same scene.
+*
+* The assets are written to files and loaded through the ResourcesController like any other asset:
+* UV spheres of increasing tessellation as OBJ models, checkerboard PPM textures and variants of the stress shader.
+*/
+class SceneGenerator {
+public:
+    /**
+    * @brief Lights beyond this number are ignored by the stress shader.
+    */
+    static constexpr uint32_t MAX_LIGHTS = 32;
+
+    explicit SceneGenerator(SceneParams params);
+
+    const SceneParams &params() const {
+        return m_params;
+    }
+
+    static std::string model_name(uint32_t index);
+
+    static std::string texture_name(uint32_t index);
+
+    static std::string shader_name(uint32_t variant);
+
+    /**
+    * @brief Writes the models into `models_dir` and registers them in the config, and the textures and shader
+    * variants into `generated_dir`.
+    */
+    void write_assets(const std::filesystem::path &models_dir, const std::filesystem::path &generated_dir,
+                      const std::filesystem::path &shader_template) const;
+
+    std::vector<StressMaterial> materials() const;
+
+    std::vector<StressLight> lights(uint32_t object_count) const;
+
+    /**
+    * @returns `count` objects, sorted by material so the draw loop binds every shader and material once.
+    */
+    std::vector<StressObject> objects(uint32_t count) const;
+
+    /**
+    * @returns Half of the size of the area `count` objects are placed in.
+    */
+    float extent(uint32_t count) const;
+
+private:
+    void write_model(const std::filesystem::path &path, uint32_t index) const;
+
+    void write_texture(const std::filesystem::path &path, uint32_t index) const;
+
+    glm::vec3 position(uint32_t index, uint32_t count, const std::vector<glm::vec3> &cluster_centers,
+                       std::mt19937 &random) const;
+
+    SceneParams m_params;
+};
+
+Layout layout_from_string(std::string_view layout);
+
+std::string_view to_string(Layout layout);
+} // namespace engine::test::stress
+
+#endif//MATF_RG_PROJECT_STRESS_SCENE_GENERATOR_HPP
@@ -0,0 +1,12 @@
+
+#ifndef MATF_RG_PROJECT_STRESS_APP_HPP
+#define MATF_RG_PROJECT_STRESS_APP_HPP
+
+#include <engine/core/Engine.hpp>
+
+namespace engine::test::stress {
+class StressApp final : public engine::core::App {
+    void app_setup() override;
+};
+}
+#endif//MATF_RG_PROJECT_STRESS_APP_HPP
@@ -0,0 +1,96 @@
+
+#ifndef MATF_RG_PROJECT_STRESS_CONTROLLER_HPP
+#define MATF_RG_PROJECT_STRESS_CONTROLLER_HPP
+
+#include <engine/core/Engine.hpp>
+#include <stress/SceneGenerator.hpp>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace engine::test::stress {
+/**
+* @class StressController
+* @brief Sweeps the stress scene over the object counts of the `stress.counts` config.
+*
+* For every count, the objects are laid out and drawn for `stress.frames_per_step` frames, after `stress.warmup_frames`.
+* Each step records the time it took to build it, the frame time percentiles, the draw counters and the resident
+* memory. At the end of the sweep the results are logged as a table and written to `stress.output` as CSV,
+* one row per step, and the app exits.
+*/
+class StressController final : public engine::core::Controller {
+public:
+    std::string_view name() const override {
+        return "StressController";
+    }
+
+private:
+    struct StepResult {
+        uint32_t objects;
+        float load_ms;
+        float frame_p50_ms;
+        float frame_p95_ms;
+        float frame_max_ms;
+        float submit_ms;
+        uint32_t draw_calls;
+        uint64_t triangles;
+        float rss_mb;
+    };
+
+    void initialize() override;
+
+    bool loop() override;
+
+    void update() override;
+
+    void begin_draw() override;
+
+    void draw() override;
+
+    void end_draw() override;
+
+    /**
+    * @brief Generates the assets and loads them through the ResourcesController.
+    */
+    void load_assets();
+
+    void start_step();
+
+    void finish_step();
+
+    void write_results() const;
+
+    /**
+    * @returns The resident set size of the process, or 0 where it can't be read.
+    */
+    static float resident_memory_mb();
+
+    std::optional<SceneGenerator> m_generator;
+    std::vector<uint32_t> m_counts;
+    uint32_t m_frames_per_step{0};
+    uint32_t m_warmup_frames{0};
+    std::filesystem::path m_output_path;
+
+    std::vector<engine::resources::Model *> m_models;
+    std::vector<engine::resources::Texture *> m_textures;
+    std::vector<engine::resources::Shader *> m_shaders;
+    std::vector<StressMaterial> m_materials;
+    std::vector<StressLight> m_lights;
+    std::vector<StressObject> m_objects;
+    /**
+    * @brief Per-draw constants of @ref StressController::m_objects, built with the step.
+    */
+    std::vector<engine::graphics::DrawConstants> m_draw_constants;
+    std::vector<engine::graphics::UniformSlice> m_draw_slices;
+
+    std::size_t m_step{0};
+    uint32_t m_step_frame{0};
+    float m_step_load_ms{0.0f};
+    uint64_t m_frame_begin_ns{0};
+    std::vector<float> m_frame_ms;
+    uint64_t m_submit_ns{0};
+    std::vector<StepResult> m_results;
+};
+} // namespace engine::test::stress
+
+#endif//MATF_RG_PROJECT_STRESS_CONTROLLER_HPP
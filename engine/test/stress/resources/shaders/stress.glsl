@@ -0,0 +1,71 @@
+//#shader vertex
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+out vec2 TexCoords;
+out vec3 Normal;
+out vec3 FragPos;
+
+layout (std140) uniform DrawConstants {
+    mat4 model;
+    mat4 normal_matrix;
+    vec4 tint;
+};
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    FragPos = vec3(model * vec4(aPos, 1.0));
+    Normal = mat3(normal_matrix) * aNormal;
+    TexCoords = aTexCoords;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
+
+//#shader fragment
+#version 330 core
+// The stress-scene generates variants of this shader by defining VARIANT right after the #version line.
+#ifndef VARIANT
+#define VARIANT 0
+#endif
+#define MAX_LIGHTS 32
+
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec3 Normal;
+in vec3 FragPos;
+
+layout (std140) uniform DrawConstants {
+    mat4 model;
+    mat4 normal_matrix;
+    vec4 tint;
+};
+
+uniform sampler2D texture_diffuse1;
+uniform int light_count;
+uniform vec3 light_positions[MAX_LIGHTS];
+uniform vec3 light_colors[MAX_LIGHTS];
+
+void main() {
+    vec3 albedo = texture(texture_diffuse1, TexCoords).rgb * tint.rgb;
+    vec3 normal = normalize(Normal);
+    vec3 color = 0.05 * albedo;
+    for (int i = 0; i < light_count; ++i) {
+        vec3 to_light = light_positions[i] - FragPos;
+        float distance = length(to_light);
+        float diffuse = max(dot(normal, to_light / distance), 0.0);
+        color += albedo * light_colors[i] * diffuse / (1.0 + 0.09 * distance + 0.032 * distance * distance);
+    }
+#if VARIANT % 2 == 1
+    color *= 0.75 + 0.25 * normal.y;
+#endif
+#if VARIANT % 4 >= 2
+    color = color / (color + vec3(1.0));
+#endif
+    FragColor = vec4(pow(color, vec3(1.0 / 2.2)), 1.0);
+}
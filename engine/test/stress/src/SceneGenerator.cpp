@@ -0,0 +1,231 @@
+#include <stress/SceneGenerator.hpp>
+#include <engine/util/Configuration.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Utils.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+
+namespace engine::test::stress {
+SceneParams SceneParams::from_config(const nlohmann::json &config) {
+    SceneParams params;
+    params.layout = layout_from_string(config.value("layout", "grid"));
+    params.models = std::max(config.value("models", params.models), 1u);
+    params.materials = std::max(config.value("materials", params.materials), 1u);
+    params.textures = std::max(config.value("textures", params.textures), 1u);
+    params.lights = std::min(config.value("lights", params.lights), SceneGenerator::MAX_LIGHTS);
+    params.shader_variants = std::max(config.value("shader_variants", params.shader_variants), 1u);
+    params.clusters = std::max(config.value("clusters", params.clusters), 1u);
+    params.spacing = config.value("spacing", params.spacing);
+    params.seed = config.value("seed", params.seed);
+    return params;
+}
+
+SceneGenerator::SceneGenerator(SceneParams params) : m_params(params) {
+}
+
+std::string SceneGenerator::model_name(uint32_t index) {
+    return std::format("stress_model_{}", index);
+}
+
+std::string SceneGenerator::texture_name(uint32_t index) {
+    return std::format("stress_texture_{}", index);
+}
+
+std::string SceneGenerator::shader_name(uint32_t variant) {
+    return std::format("stress_variant_{}", variant);
+}
+
+void SceneGenerator::write_assets(const std::filesystem::path &models_dir, const std::filesystem::path &generated_dir,
+                                  const std::filesystem::path &shader_template) const {
+    std::filesystem::create_directories(models_dir);
+    std::filesystem::create_directories(generated_dir);
+    auto &models_config = engine::util::Configuration::config()["resources"]["models"];
+    for (uint32_t i = 0; i < m_params.models; ++i) {
+        const auto file_name = model_name(i) + ".obj";
+        write_model(models_dir / file_name, i);
+        models_config[model_name(i)] = {{"path", (models_dir.filename() / file_name).string()}};
+    }
+    for (uint32_t i = 0; i < m_params.textures; ++i) {
+        write_texture(generated_dir / (texture_name(i) + ".ppm"), i);
+    }
+    // Every variant is a separate program: the define goes right after the #version line of the fragment shader.
+    const std::string source = engine::util::read_text_file(shader_template);
+    const std::string_view fragment_marker = "//#shader fragment\n#version 330 core\n";
+    const auto fragment = source.find(fragment_marker);
+    RG_GUARANTEE(fragment != std::string::npos, "{} must start the fragment shader with '{}'.",
+                 shader_template.string(), fragment_marker);
+    for (uint32_t variant = 0; variant < m_params.shader_variants; ++variant) {
+        std::string variant_source = source;
+        variant_source.insert(fragment + fragment_marker.size(), std::format("#define VARIANT {}\n", variant));
+        std::ofstream file(generated_dir / (shader_name(variant) + ".glsl"));
+        RG_GUARANTEE(file.is_open(), "Failed to write the shader variant {}.", variant);
+        file << variant_source;
+    }
+}
+
+void SceneGenerator::write_model(const std::filesystem::path &path, uint32_t index) const {
+    // A UV sphere, every next model has twice the rings and segments of the previous one.
+    const uint32_t rings = 6u << std::min(index, 6u);
+    const uint32_t segments = 2 * rings;
+    std::ofstream file(path);
+    RG_GUARANTEE(file.is_open(), "Failed to write the model {}.", path.string());
+    for (uint32_t ring = 0; ring <= rings; ++ring) {
+        const float v = static_cast<float>(ring) / static_cast<float>(rings);
+        const float theta = v * glm::pi<float>();
+        for (uint32_t segment = 0; segment <= segments; ++segment) {
+            const float u = static_cast<float>(segment) / static_cast<float>(segments);
+            const float phi = u * glm::two_pi<float>();
+            const glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            file << std::format("v {:.5f} {:.5f} {:.5f}\nvt {:.5f} {:.5f}\nvn {:.5f} {:.5f} {:.5f}\n", normal.x,
+                                normal.y, normal.z, u, 1.0f - v, normal.x, normal.y, normal.z);
+        }
+    }
+    for (uint32_t ring = 0; ring < rings; ++ring) {
+        for (uint32_t segment = 0; segment < segments; ++segment) {
+            // OBJ indices start at 1.
+            const uint32_t a = ring * (segments + 1) + segment + 1;
+            const uint32_t b = a + segments + 1;
+            file << std::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\nf {2}/{2}/{2} {1}/{1}/{1} {3}/{3}/{3}\n", a, b,
+                                a + 1, b + 1);
+        }
+    }
+}
+
+void SceneGenerator::write_texture(const std::filesystem::path &path, uint32_t index) const {
+    static constexpr uint32_t SIZE = 64;
+    static constexpr uint32_t CELL = 8;
+    std::mt19937 random(m_params.seed * 7919 + index);
+    std::uniform_int_distribution<int> channel(64, 255);
+    const uint8_t color[3] = {
+            static_cast<uint8_t>(channel(random)),
+            static_cast<uint8_t>(channel(random)),
+            static_cast<uint8_t>(channel(random)),
+    };
+    std::vector<uint8_t> pixels(SIZE * SIZE * 3);
+    for (uint32_t y = 0; y < SIZE; ++y) {
+        for (uint32_t x = 0; x < SIZE; ++x) {
+            const bool dark = (x / CELL + y / CELL) % 2 == 0;
+            for (uint32_t c = 0; c < 3; ++c) {
+                pixels[(y * SIZE + x) * 3 + c] = dark ? color[c] / 4 : color[c];
+            }
+        }
+    }
+    std::ofstream file(path, std::ios::binary);
+    RG_GUARANTEE(file.is_open(), "Failed to write the texture {}.", path.string());
+    file << std::format("P6\n{} {}\n255\n", SIZE, SIZE);
+    file.write(reinterpret_cast<const char *>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+}
+
+std::vector<StressMaterial> SceneGenerator::materials() const {
+    std::mt19937 random(m_params.seed);
+    std::uniform_real_distribution<float> tint(0.5f, 1.0f);
+    std::vector<StressMaterial> result;
+    result.reserve(m_params.materials);
+    for (uint32_t i = 0; i < m_params.materials; ++i) {
+        result.push_back(StressMaterial{
+                .shader_variant = i % m_params.shader_variants,
+                .texture = i % m_params.textures,
+                .tint = glm::vec3(tint(random), tint(random), tint(random)),
+        });
+    }
+    return result;
+}
+
+std::vector<StressLight> SceneGenerator::lights(uint32_t object_count) const {
+    std::mt19937 random(m_params.seed + 1);
+    const float half = extent(object_count);
+    std::uniform_real_distribution<float> coordinate(-half, half);
+    std::uniform_real_distribution<float> channel(0.3f, 1.0f);
+    std::vector<StressLight> result;
+    result.reserve(m_params.lights);
+    for (uint32_t i = 0; i < m_params.lights; ++i) {
+        result.push_back(StressLight{
+                .position = glm::vec3(coordinate(random), half * 0.5f + m_params.spacing, coordinate(random)),
+                .color = glm::vec3(channel(random), channel(random), channel(random)),
+        });
+    }
+    return result;
+}
+
+float SceneGenerator::extent(uint32_t count) const {
+    return 0.5f * m_params.spacing * std::ceil(std::cbrt(static_cast<float>(std::max(count, 1u))));
+}
+
+std::vector<StressObject> SceneGenerator::objects(uint32_t count) const {
+    std::mt19937 random(m_params.seed + 2);
+    const float half = extent(count);
+    std::uniform_real_distribution<float> coordinate(-half, half);
+    std::vector<glm::vec3> cluster_centers;
+    for (uint32_t i = 0; i < m_params.clusters; ++i) {
+        cluster_centers.emplace_back(coordinate(random), coordinate(random), coordinate(random));
+    }
+    std::uniform_real_distribution<float> angle(0.0f, glm::two_pi<float>());
+    std::uniform_real_distribution<float> scale(0.4f, 1.0f);
+    std::vector<StressObject> result;
+    result.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), position(i, count, cluster_centers, random));
+        transform = glm::rotate(transform, angle(random), glm::vec3(0.0f, 1.0f, 0.0f));
+        transform = glm::scale(transform, glm::vec3(scale(random)));
+        result.push_back(StressObject{
+                .model = i % m_params.models,
+                .material = static_cast<uint32_t>((i * 2654435761u) % m_params.materials),
+                .transform = transform,
+        });
+    }
+    std::ranges::stable_sort(result, {}, [](const StressObject &object) {
+        return object.material;
+    });
+    return result;
+}
+
+glm::vec3 SceneGenerator::position(uint32_t index, uint32_t count, const std::vector<glm::vec3> &cluster_centers,
+                                   std::mt19937 &random) const {
+    const float half = extent(count);
+    switch (m_params.layout) {
+        case Layout::Grid: {
+            const auto side = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<float>(count))));
+            const glm::vec3 cell(index % side, index / (side * side), index / side % side);
+            return cell * m_params.spacing - glm::vec3(half - 0.5f * m_params.spacing);
+        }
+        case Layout::Random: {
+            std::uniform_real_distribution<float> coordinate(-half, half);
+            return {coordinate(random), coordinate(random), coordinate(random)};
+        }
+        case Layout::Clustered: {
+            const float radius = half / std::cbrt(static_cast<float>(m_params.clusters));
+            std::normal_distribution<float> offset(0.0f, 0.5f * radius);
+            const glm::vec3 &center = cluster_centers[index % cluster_centers.size()];
+            return center + glm::vec3(offset(random), offset(random), offset(random));
+        }
+        default: RG_SHOULD_NOT_REACH_HERE("Unknown layout");
+    }
+}
+
+Layout layout_from_string(std::string_view layout) {
+    if (layout == "grid") {
+        return Layout::Grid;
+    }
+    if (layout == "random") {
+        return Layout::Random;
+    }
+    if (layout == "clustered") {
+        return Layout::Clustered;
+    }
+    throw engine::util::EngineError(engine::util::EngineError::Type::ConfigurationError,
+                            std::format("Unknown stress.layout '{}', expected grid, random or clustered.", layout));
+}
+
+std::string_view to_string(Layout layout) {
+    switch (layout) {
+        case Layout::Grid: return "grid";
+        case Layout::Random: return "random";
+        case Layout::Clustered: return "clustered";
+        default: RG_SHOULD_NOT_REACH_HERE("Unknown layout");
+    }
+}
+} // namespace engine::test::stress
@@ -0,0 +1,13 @@
+#include <stress/StressApp.hpp>
+#include <stress/StressController.hpp>
+
+namespace engine::test::stress {
+void StressApp::app_setup() {
+    auto stress_controller = register_controller<StressController>();
+    stress_controller->after(engine::core::Controller::get<engine::core::EngineControllersEnd>());
+}
+}
+
+int main(int argc, char **argv) {
+    return std::make_unique<engine::test::stress::StressApp>()->run(argc, argv);
+}
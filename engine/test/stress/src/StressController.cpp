@@ -0,0 +1,222 @@
+#include <glad/glad.h>
+#include <stress/StressController.hpp>
+#include <engine/graphics/GraphicsController.hpp>
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <string>
+
+namespace engine::test::stress {
+void StressController::initialize() {
+    auto &config = engine::util::Configuration::config();
+    RG_GUARANTEE(config.contains("stress"), "The stress-scene needs the stress section in the config.json.");
+    const auto &stress = config["stress"];
+    m_generator.emplace(SceneParams::from_config(stress));
+    m_counts = stress.value("counts", std::vector<uint32_t>{1, 10, 100, 1000, 10000, 100000});
+    RG_GUARANTEE(!m_counts.empty(), "stress.counts can't be empty.");
+    m_frames_per_step = std::max(stress.value("frames_per_step", 120u), 1u);
+    m_warmup_frames = stress.value("warmup_frames", 10u);
+    m_output_path = stress.value("output", "stress.csv");
+    m_frame_ms.reserve(m_frames_per_step);
+
+    engine::graphics::OpenGL::enable_depth_testing();
+    load_assets();
+    m_materials = m_generator->materials();
+    start_step();
+}
+
+void StressController::load_assets() {
+    const auto &params = m_generator->params();
+    auto resources = engine::core::Controller::get<engine::resources::ResourcesController>();
+    const std::filesystem::path generated = "resources/generated";
+    m_generator->write_assets("resources/models/generated", generated, "resources/shaders/stress.glsl");
+
+    const auto timed = [](auto &&load) {
+        const uint64_t begin = engine::util::Profiler::now_ns();
+        load();
+        return static_cast<float>(engine::util::Profiler::now_ns() - begin) / 1e6f;
+    };
+    const float models_ms = timed([&] {
+        for (uint32_t i = 0; i < params.models; ++i) {
+            m_models.push_back(resources->model(SceneGenerator::model_name(i)));
+        }
+    });
+    const float textures_ms = timed([&] {
+        for (uint32_t i = 0; i < params.textures; ++i) {
+            const auto name = SceneGenerator::texture_name(i);
+            m_textures.push_back(resources->texture(name, generated / (name + ".ppm")));
+        }
+    });
+    const float shaders_ms = timed([&] {
+        for (uint32_t i = 0; i < params.shader_variants; ++i) {
+            const auto name = SceneGenerator::shader_name(i);
+            m_shaders.push_back(resources->shader(name, generated / (name + ".glsl")));
+            m_shaders.back()->bind_uniform_block<engine::graphics::DrawConstants>();
+        }
+    });
+    engine::util::logger("app")->info("Stress assets loaded: {} models in {:.1f} ms, {} textures in {:.1f} ms, "
+                                      "{} shader variants in {:.1f} ms.", params.models, models_ms, params.textures,
+                                      textures_ms, params.shader_variants, shaders_ms);
+}
+
+void StressController::start_step() {
+    const uint32_t count = m_counts[m_step];
+    const uint64_t begin = engine::util::Profiler::now_ns();
+    m_objects = m_generator->objects(count);
+    m_lights = m_generator->lights(count);
+    m_draw_constants.clear();
+    for (const auto &object: m_objects) {
+        const glm::vec3 &tint = m_materials[object.material].tint;
+        m_draw_constants.push_back(engine::graphics::DrawConstants::from_model(object.transform, glm::vec4(tint, 1.0f)));
+    }
+    m_draw_slices.reserve(m_objects.size());
+    m_step_load_ms = static_cast<float>(engine::util::Profiler::now_ns() - begin) / 1e6f;
+
+    // Look at the whole scene from above its front side.
+    const float extent = m_generator->extent(count);
+    auto graphics = engine::core::Controller::get<engine::graphics::GraphicsController>();
+    auto camera = graphics->camera();
+    camera->Position = glm::vec3(0.0f, extent, 2.0f * extent + 3.0f);
+    camera->set_orientation(engine::graphics::Camera::YAW, -25.0f);
+    graphics->perspective_params().Far = std::max(100.0f, 6.0f * extent);
+
+    m_step_frame = 0;
+    m_frame_ms.clear();
+    m_submit_ns = 0;
+    engine::util::logger("app")->info("Stress step {}/{}: {} objects ({}), built in {:.2f} ms.", m_step + 1,
+                                      m_counts.size(), count, to_string(m_generator->params().layout),
+                                      m_step_load_ms);
+}
+
+bool StressController::loop() {
+    const uint64_t now = engine::util::Profiler::now_ns();
+    if (m_step_frame > m_warmup_frames) {
+        m_frame_ms.push_back(static_cast<float>(now - m_frame_begin_ns) / 1e6f);
+        auto graphics = engine::core::Controller::get<engine::graphics::GraphicsController>();
+        m_submit_ns += static_cast<uint64_t>(graphics->render_stats()->last_frame().submit_ms * 1e6f);
+    }
+    if (m_frame_ms.size() == m_frames_per_step) {
+        finish_step();
+        if (++m_step == m_counts.size()) {
+            write_results();
+            return false;
+        }
+        start_step();
+    }
+    ++m_step_frame;
+    m_frame_begin_ns = engine::util::Profiler::now_ns();
+    return true;
+}
+
+void StressController::finish_step() {
+    std::ranges::sort(m_frame_ms);
+    const auto percentile = [&](float p) {
+        return m_frame_ms[static_cast<std::size_t>(p * static_cast<float>(m_frame_ms.size() - 1))];
+    };
+    auto graphics = engine::core::Controller::get<engine::graphics::GraphicsController>();
+    const auto &stats = graphics->render_stats()->last_frame();
+    m_results.push_back(StepResult{
+            .objects = m_counts[m_step],
+            .load_ms = m_step_load_ms,
+            .frame_p50_ms = percentile(0.5f),
+            .frame_p95_ms = percentile(0.95f),
+            .frame_max_ms = m_frame_ms.back(),
+            .submit_ms = static_cast<float>(m_submit_ns) / 1e6f / static_cast<float>(m_frame_ms.size()),
+            .draw_calls = stats.draw_calls,
+            .triangles = stats.triangles,
+            .rss_mb = resident_memory_mb(),
+    });
+}
+
+void StressController::update() {
+    // Keeps the lights moving, so the frames aren't identical.
+    const float dt = engine::core::Controller::get<engine::platform::PlatformController>()->dt();
+    const glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), 0.25f * dt, glm::vec3(0.0f, 1.0f, 0.0f));
+    for (auto &light: m_lights) {
+        light.position = glm::vec3(rotation * glm::vec4(light.position, 1.0f));
+    }
+}
+
+void StressController::begin_draw() {
+    engine::graphics::OpenGL::clear_buffers();
+}
+
+void StressController::draw() {
+    RG_GPU_SCOPE("stress");
+    auto graphics = engine::core::Controller::get<engine::graphics::GraphicsController>();
+    const glm::mat4 projection = graphics->projection_matrix();
+    const glm::mat4 view = graphics->camera()->view_matrix();
+    for (auto shader: m_shaders) {
+        shader->use();
+        shader->set_mat4("projection", projection);
+        shader->set_mat4("view", view);
+        shader->set_int("texture_diffuse1", 0);
+        shader->set_int("light_count", static_cast<int>(m_lights.size()));
+        for (std::size_t i = 0; i < m_lights.size(); ++i) {
+            shader->set_vec3(std::format("light_positions[{}]", i), m_lights[i].position);
+            shader->set_vec3(std::format("light_colors[{}]", i), m_lights[i].color);
+        }
+    }
+    // All the per-draw constants are copied first, so the streaming buffer is updated once for the whole frame.
+    m_draw_slices.clear();
+    for (const auto &constants: m_draw_constants) {
+        m_draw_slices.push_back(graphics->push_uniforms(constants));
+    }
+    graphics->streaming_buffer()->flush();
+    // The objects are sorted by material, switch the shader and the material only when they change.
+    uint32_t current_material = UINT32_MAX;
+    engine::resources::Shader *shader = nullptr;
+    for (std::size_t i = 0; i < m_objects.size(); ++i) {
+        const auto &object = m_objects[i];
+        if (object.material != current_material) {
+            current_material = object.material;
+            const auto &material = m_materials[current_material];
+            shader = m_shaders[material.shader_variant];
+            shader->use();
+            m_textures[material.texture]->bind(GL_TEXTURE0);
+        }
+        graphics->bind_uniforms<engine::graphics::DrawConstants>(m_draw_slices[i]);
+        m_models[object.model]->draw(shader);
+    }
+}
+
+void StressController::end_draw() {
+    engine::core::Controller::get<engine::platform::PlatformController>()->swap_buffers();
+}
+
+void StressController::write_results() const {
+    auto logger = engine::util::logger("app");
+    logger->info("{:>8} {:>10} {:>10} {:>10} {:>10} {:>10} {:>8} {:>12} {:>9}", "objects", "build ms", "p50 ms",
+                 "p95 ms", "max ms", "submit ms", "draws", "triangles", "rss MB");
+    for (const auto &result: m_results) {
+        logger->info("{:>8} {:>10.2f} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>8} {:>12} {:>9.1f}", result.objects,
+                     result.load_ms, result.frame_p50_ms, result.frame_p95_ms, result.frame_max_ms, result.submit_ms,
+                     result.draw_calls, result.triangles, result.rss_mb);
+    }
+    std::ofstream csv(m_output_path);
+    RG_GUARANTEE(csv.is_open(), "Failed to open {} for writing.", m_output_path.string());
+    const auto &params = m_generator->params();
+    csv << "layout,models,materials,textures,lights,shader_variants,objects,build_ms,frame_p50_ms,frame_p95_ms,"
+           "frame_max_ms,submit_ms,draw_calls,triangles,rss_mb\n";
+    for (const auto &result: m_results) {
+        csv << std::format("{},{},{},{},{},{},{},{:.3f},{:.4f},{:.4f},{:.4f},{:.4f},{},{},{:.2f}\n",
+                           to_string(params.layout), params.models, params.materials, params.textures, params.lights,
+                           params.shader_variants, result.objects, result.load_ms, result.frame_p50_ms,
+                           result.frame_p95_ms, result.frame_max_ms, result.submit_ms, result.draw_calls,
+                           result.triangles, result.rss_mb);
+    }
+    logger->info("Stress results written to {}.", m_output_path.string());
+}
+
+float StressController::resident_memory_mb() {
+    // Linux only, the VmRSS line of /proc/self/status is in kB.
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmRSS:")) {
+            return static_cast<float>(std::stoul(line.substr(6))) / 1024.0f;
+        }
+    }
+    return 0.0f;
+}
+} // namespace engine::test::stress
@@ -0,0 +1,28 @@
+/**
+ * @file UnitTest.hpp
+ * @brief The checks shared by the engine unit tests, and the test groups the engine-unit-tests executable runs.
+ */
+
+#ifndef MATF_RG_PROJECT_UNIT_TEST_HPP
+#define MATF_RG_PROJECT_UNIT_TEST_HPP
+
+#include <cstdio>
+
+namespace engine::test {
+inline int g_failures = 0;
+
+inline void expect(bool condition, const char *what) {
+    if (!condition) {
+        std::fprintf(stderr, "FAILED: %s\n", what);
+        ++g_failures;
+    }
+}
+
+void run_container_tests();
+
+void run_arena_tests();
+
+void run_resources_tests();
+} // namespace engine::test
+
+#endif//MATF_RG_PROJECT_UNIT_TEST_HPP
@@ -0,0 +1,103 @@
+#include <UnitTest.hpp>
+#include <engine/util/Arena.hpp>
+#include <algorithm>
+#include <cstdint>
+
+// Checks the LinearArena bookkeeping that the frame and scratch arenas rely on.
+
+namespace engine::test {
+namespace {
+using engine::util::ds::LinearArena;
+
+constexpr std::size_t BLOCK_SIZE = 1024;
+
+void rewind_releases_allocations_after_marker() {
+    LinearArena arena(BLOCK_SIZE);
+    auto *kept = static_cast<std::byte *>(arena.allocate(100));
+    const auto marker = arena.marker();
+    auto *released = static_cast<std::byte *>(arena.allocate(200));
+    arena.allocate(300);
+    arena.rewind(marker);
+    expect(arena.stats().used == marker.used && arena.stats().allocations == 1,
+           "rewind restores the used bytes and the allocation count");
+    expect(arena.allocate(200) == released, "the next allocation after rewind reuses the released memory");
+    expect(kept != released, "the allocation before the marker is kept");
+}
+
+void allocations_chain_blocks() {
+    LinearArena arena(BLOCK_SIZE);
+    arena.set_poison_on_free(false);
+    auto *first = static_cast<std::byte *>(arena.allocate(BLOCK_SIZE / 2));
+    auto *second = static_cast<std::byte *>(arena.allocate(BLOCK_SIZE));
+    expect(arena.stats().block_allocations == 2, "an allocation that doesn't fit starts a new block");
+    expect(second < first || second >= first + BLOCK_SIZE, "the new block doesn't overlap the first one");
+    // Larger than the block size, so it gets a block of its own.
+    arena.allocate(4 * BLOCK_SIZE);
+    expect(arena.stats().block_allocations == 3 && arena.stats().capacity >= 6 * BLOCK_SIZE,
+           "an oversized allocation gets a block that fits it");
+    const auto aligned = reinterpret_cast<std::uintptr_t>(arena.allocate(8, 256));
+    expect(aligned % 256 == 0, "allocate respects the alignment");
+}
+
+void reset_merges_blocks() {
+    LinearArena arena(BLOCK_SIZE);
+    arena.allocate(BLOCK_SIZE);
+    arena.allocate(BLOCK_SIZE);
+    arena.allocate(BLOCK_SIZE);
+    const std::size_t capacity = arena.stats().capacity;
+    arena.reset();
+    expect(arena.stats().used == 0 && arena.stats().allocations == 0, "reset releases every allocation");
+    expect(arena.stats().capacity == capacity && arena.stats().block_allocations == 4,
+           "reset merges the blocks into one of the same total size");
+    const std::size_t block_allocations = arena.stats().block_allocations;
+    for (int frame = 0; frame < 3; ++frame) {
+        arena.allocate(BLOCK_SIZE);
+        arena.allocate(BLOCK_SIZE);
+        arena.allocate(BLOCK_SIZE);
+        arena.reset();
+    }
+    expect(arena.stats().block_allocations == block_allocations,
+           "the merged block serves later frames without growing");
+}
+
+void high_water_mark_survives_reset() {
+    LinearArena arena(BLOCK_SIZE);
+    arena.allocate(600);
+    arena.allocate(200);
+    const std::size_t peak = arena.stats().used;
+    arena.reset();
+    arena.allocate(100);
+    expect(arena.stats().high_water_mark == peak && peak >= 800,
+           "the high-water mark keeps the peak of the earlier frame");
+    const auto marker = arena.marker();
+    arena.allocate(900);
+    arena.rewind(marker);
+    expect(arena.stats().high_water_mark >= 1000, "the high-water mark keeps the peak before a rewind");
+}
+
+void released_memory_is_poisoned() {
+    LinearArena arena(BLOCK_SIZE);
+    arena.set_poison_on_free(true);
+    const auto marker = arena.marker();
+    auto *data = static_cast<std::byte *>(arena.allocate(64));
+    std::fill_n(data, 64, std::byte{0x11});
+    arena.rewind(marker);
+    expect(std::all_of(data, data + 64, [](std::byte b) { return b == LinearArena::POISON_BYTE; }),
+           "rewind poisons the released memory");
+
+    data = static_cast<std::byte *>(arena.allocate(64));
+    std::fill_n(data, 64, std::byte{0x22});
+    arena.set_poison_on_free(false);
+    arena.rewind(marker);
+    expect(data[0] == std::byte{0x22}, "poisoning can be turned off");
+}
+} // namespace
+
+void run_arena_tests() {
+    rewind_releases_allocations_after_marker();
+    allocations_chain_blocks();
+    reset_merges_blocks();
+    high_water_mark_survives_reset();
+    released_memory_is_poisoned();
+}
+} // namespace engine::test
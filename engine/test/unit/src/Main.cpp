@@ -0,0 +1,12 @@
+#include <UnitTest.hpp>
+
+int main() {
+    engine::test::run_container_tests();
+    engine::test::run_arena_tests();
+    // Runs the engine, which sets the logging up and shuts it down itself.
+    engine::test::run_resources_tests();
+    if (engine::test::g_failures == 0) {
+        std::printf("All unit tests passed.\n");
+    }
+    return engine::test::g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include <UnitTest.hpp>
+#include <engine/core/App.hpp>
+#include <engine/resources/ResourcesController.hpp>
+#include <engine/util/Errors.hpp>
+#include <iterator>
+#include <string>
+
+// A failed load is reported and the engine terminates cleanly, instead of crashing in
+// ResourcesController::terminate on the slot the failed load left behind.
+
+namespace engine::test {
+namespace {
+class MissingTextureController final : public core::Controller {
+public:
+    std::string_view name() const override {
+        return "MissingTextureController";
+    }
+
+private:
+    void initialize() override {
+        get<resources::ResourcesController>()->texture("missing", "resources/textures/missing.png");
+    }
+};
+
+/**
+ * @class MissingAssetApp
+ * @brief Runs the engine headless with the null renderer, and loads a texture that doesn't exist on initialize.
+ */
+class MissingAssetApp final : public core::App {
+public:
+    bool error_reported() const {
+        return m_error_reported;
+    }
+
+private:
+    void app_setup() override {
+        auto controller = register_controller<MissingTextureController>();
+        controller->after(core::Controller::get<core::EngineControllersEnd>());
+    }
+
+    void handle_error(const util::Error &e) override {
+        m_error_reported = e.report().find("missing.png") != std::string::npos;
+    }
+
+    bool m_error_reported{false};
+};
+
+void missing_texture_is_reported() {
+    static const char *args[] = {
+            "engine-unit-tests", "--configuration", RG_UNIT_TESTS_CONFIG, "--headless", "1", "--null-renderer", "1"
+    };
+    MissingAssetApp app;
+    app.run(std::size(args), const_cast<char **>(args));
+    expect(app.error_reported(), "a missing texture is reported as an error, and terminate() doesn't crash");
+}
+} // namespace
+
+void run_resources_tests() {
+    missing_texture_is_reported();
+}
+} // namespace engine::test
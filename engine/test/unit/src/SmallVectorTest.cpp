@@ -0,0 +1,124 @@
+#include <UnitTest.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/ObjectPool.hpp>
+#include <engine/util/SlotMap.hpp>
+#include <engine/util/SmallVector.hpp>
+#include <string>
+
+// Checks the engine::util::ds containers for the cases that a benchmark doesn't exercise.
+
+namespace engine::test {
+namespace {
+// The strings are longer than the small string buffer, so a read from a freed element reads freed heap memory too.
+std::string long_string(char c) {
+    return std::string(64, c);
+}
+
+void push_back_aliased_element_when_full() {
+    using engine::util::ds::SmallVector;
+    SmallVector<std::string, 2> inline_full{long_string('a'), long_string('b')};
+    // Inline to heap.
+    inline_full.push_back(inline_full[0]);
+    expect(inline_full.size() == 3 && inline_full[2] == long_string('a'),
+           "push_back(v[0]) when the inline buffer is full");
+    // Heap to a bigger heap buffer.
+    inline_full.push_back(long_string('c'));
+    inline_full.push_back(inline_full.back());
+    expect(inline_full.size() == 5 && inline_full[4] == long_string('c'),
+           "push_back(v.back()) when the heap buffer is full");
+    inline_full.emplace_back(inline_full[1]);
+    expect(inline_full[5] == long_string('b') && inline_full[1] == long_string('b'),
+           "emplace_back(v[1]) leaves v[1] alone");
+}
+
+void push_back_moved_element_when_full() {
+    using engine::util::ds::SmallVector;
+    SmallVector<std::string, 1> full{long_string('x')};
+    full.push_back(std::move(full[0]));
+    expect(full.size() == 2 && full[1] == long_string('x'), "push_back(std::move(v[0])) when full");
+}
+void slot_map_rejects_stale_handles() {
+    using engine::util::ds::SlotMap;
+    SlotMap<std::string> values;
+    const auto erased = values.insert(long_string('a'));
+    expect(values.erase(erased), "erase of a live handle");
+    const auto reused = values.insert(long_string('b'));
+    expect(reused.index == erased.index && reused.generation == erased.generation + 1,
+           "insert reuses the erased slot with the next generation");
+    expect(!values.contains(erased) && values.get(erased) == nullptr, "the erased handle doesn't resolve");
+    expect(!values.erase(erased) && values.size() == 1, "erase of the erased handle leaves the reused slot alone");
+    expect(values.get(reused) && *values.get(reused) == long_string('b'), "the new handle resolves to the new value");
+    bool threw = false;
+    try {
+        values[erased];
+    } catch (const engine::util::EngineError &) {
+        threw = true;
+    }
+    expect(threw, "operator[] throws on the erased handle");
+}
+
+void slot_map_erase_fixes_moved_value() {
+    using engine::util::ds::SlotMap;
+    SlotMap<std::string> values;
+    const auto first = values.insert(long_string('a'));
+    const auto middle = values.insert(long_string('b'));
+    const auto last = values.insert(long_string('c'));
+    // The last value moves into the hole, so its slot has to point to the new dense index.
+    values.erase(first);
+    expect(values.size() == 2 && *values.data() == long_string('c'), "erase moves the last value into the hole");
+    expect(values.get(last) && *values.get(last) == long_string('c'), "the moved value's handle follows it");
+    expect(values.handle_at(0) == last, "the dense index maps back to the moved value's handle");
+    expect(values.get(middle) && *values.get(middle) == long_string('b'), "the other values are untouched");
+    // Erasing the moved value through its fixed-up slot must not disturb the rest.
+    values.erase(last);
+    expect(values.size() == 1 && values.handle_at(0) == middle && *values.get(middle) == long_string('b'),
+           "erase of the moved value");
+}
+
+void object_pool_reuses_freed_slots() {
+    using engine::util::ds::ObjectPool;
+    ObjectPool<std::string, 4> pool;
+    std::string *a = pool.create(long_string('a'));
+    std::string *b = pool.create(long_string('b'));
+    pool.destroy(a);
+    std::string *c = pool.create(long_string('c'));
+    expect(c == a, "create hands out the last destroyed slot");
+    expect(*b == long_string('b') && *c == long_string('c') && pool.size() == 2, "the other objects are untouched");
+    for (int i = 0; i < 2; ++i) {
+        pool.create(long_string('d'));
+    }
+    expect(pool.capacity() == 4, "a full free list doesn't grow the pool");
+    pool.create(long_string('e'));
+    expect(pool.capacity() == 8 && pool.size() == 5, "an empty free list grows the pool by a chunk");
+    expect(*b == long_string('b'), "growing keeps the objects in place");
+}
+
+void object_pool_rejects_double_destroy() {
+    using engine::util::ds::ObjectPool;
+    ObjectPool<std::string, 4> pool;
+    std::string *a = pool.create(long_string('a'));
+    pool.create(long_string('b'));
+    pool.destroy(a);
+    bool threw = false;
+    try {
+        pool.destroy(a);
+    } catch (const engine::util::EngineError &) {
+        threw = true;
+    }
+    expect(threw, "destroying the same object twice throws");
+    // The free list still has the slot once, so the next two objects get different slots.
+    std::string *c = pool.create(long_string('c'));
+    std::string *d = pool.create(long_string('d'));
+    expect(c == a && d != a && pool.size() == 3, "the double destroy didn't corrupt the free list");
+}
+} // namespace
+
+void run_container_tests() {
+    push_back_aliased_element_when_full();
+    push_back_moved_element_when_full();
+    slot_map_rejects_stale_handles();
+    slot_map_erase_fixes_moved_value();
+    object_pool_reuses_freed_slots();
+    object_pool_rejects_double_destroy();
+}
+} // namespace engine::test
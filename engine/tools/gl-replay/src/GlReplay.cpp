@@ -0,0 +1,155 @@
+/**
+ * @file GlReplay.cpp
+ * @brief Plays back a GL call capture (see engine::graphics::GlCapture) on a headless context and reports per-frame
+ * timings.
+ *
+ * Usage: gl-replay <capture> [--loops N] [--width W] [--height H] [--context-api egl|osmesa] [--csv path]
+ *
+ * The context is created like the engine's headless mode (see engine::platform::PlatformController::headless), without
+ * a display connection, and the frames are rendered into an engine::graphics::OffscreenTarget.
+ */
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <engine/graphics/GlCapture.hpp>
+#include <engine/graphics/OffscreenTarget.hpp>
+#include <engine/platform/PlatformController.hpp>
+#include <engine/util/Errors.hpp>
+#include <engine/util/Logging.hpp>
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace {
+struct Options {
+    std::string capture;
+    int loops{1};
+    int width{800};
+    int height{600};
+    std::string context_api{"egl"};
+    std::string csv;
+};
+
+int parse_int(std::string_view value, std::string_view flag) {
+    int result = 0;
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (error != std::errc{} || end != value.data() + value.size() || result <= 0) {
+        throw engine::util::EngineError(engine::util::EngineError::Type::ConfigurationError,
+                                        std::format("{} expects a positive number, got '{}'.", flag, value));
+    }
+    return result;
+}
+
+Options parse_options(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--loops" && has_value) {
+            options.loops = parse_int(argv[++i], arg);
+        } else if (arg == "--width" && has_value) {
+            options.width = parse_int(argv[++i], arg);
+        } else if (arg == "--height" && has_value) {
+            options.height = parse_int(argv[++i], arg);
+        } else if (arg == "--context-api" && has_value) {
+            options.context_api = argv[++i];
+        } else if (arg == "--csv" && has_value) {
+            options.csv = argv[++i];
+        } else if (options.capture.empty() && !arg.starts_with("--")) {
+            options.capture = arg;
+        } else {
+            throw engine::util::EngineError(engine::util::EngineError::Type::ConfigurationError,
+                                            std::format("Unknown argument '{}'.", arg));
+        }
+    }
+    if (options.capture.empty()) {
+        throw engine::util::EngineError(engine::util::EngineError::Type::ConfigurationError,
+                                        "Usage: gl-replay <capture> [--loops N] [--width W] [--height H] "
+                                        "[--context-api egl|osmesa] [--csv path]");
+    }
+    return options;
+}
+
+GLFWwindow *create_context(const Options &options) {
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    RG_GUARANTEE(glfwInit(), "GLFW failed to initialize.");
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    engine::platform::PlatformController::set_headless_window_hints(options.context_api);
+    GLFWwindow *window = glfwCreateWindow(options.width, options.height, "gl-replay", nullptr, nullptr);
+    RG_GUARANTEE(window, "Failed to create the {} OpenGL context.", options.context_api);
+    glfwMakeContextCurrent(window);
+    RG_GUARANTEE(gladLoadGLLoader((GLADloadproc) glfwGetProcAddress), "OpenGL failed to init!");
+    return window;
+}
+
+float percentile(std::vector<float> values, float p) {
+    std::ranges::sort(values);
+    return values[static_cast<std::size_t>(p * static_cast<float>(values.size() - 1))];
+}
+
+void print_summary(std::string_view name, const std::vector<float> &values) {
+    float sum = 0.0f;
+    for (float value: values) {
+        sum += value;
+    }
+    std::cout << std::format("{:<12} avg {:8.3f} ms  min {:8.3f} ms  p50 {:8.3f} ms  p95 {:8.3f} ms  max {:8.3f} ms\n",
+                             name, sum / static_cast<float>(values.size()), std::ranges::min(values),
+                             percentile(values, 0.5f), percentile(values, 0.95f), std::ranges::max(values));
+}
+
+int run(const Options &options) {
+    GLFWwindow *window = create_context(options);
+    // The captured calls draw into the framebuffer that is bound, there is no default one.
+    engine::graphics::OffscreenTarget target;
+    target.create(options.width, options.height);
+    engine::graphics::GlReplayer replayer(options.capture);
+    RG_GUARANTEE(replayer.frame_count() > 0, "{} has no complete frames.", options.capture);
+    std::cout << std::format("Replaying {}: {} frames, {} calls, {} loop(s) on {}.\n", options.capture,
+                             replayer.frame_count(), replayer.call_count(), options.loops,
+                             reinterpret_cast<const char *>(glGetString(GL_RENDERER)));
+    replayer.replay_setup();
+
+    std::ofstream csv;
+    if (!options.csv.empty()) {
+        csv.open(options.csv);
+        RG_GUARANTEE(csv.is_open(), "Failed to open {}.", options.csv);
+        csv << "loop,frame,submit_ms,gpu_wait_ms\n";
+    }
+    std::vector<float> submit_ms, frame_ms;
+    for (int loop = 0; loop < options.loops; ++loop) {
+        for (std::size_t frame = 0; frame < replayer.frame_count(); ++frame) {
+            const auto timing = replayer.replay_frame(frame);
+            submit_ms.push_back(timing.submit_ms);
+            frame_ms.push_back(timing.submit_ms + timing.gpu_wait_ms);
+            if (csv.is_open()) {
+                csv << std::format("{},{},{:.4f},{:.4f}\n", loop, frame, timing.submit_ms, timing.gpu_wait_ms);
+            }
+        }
+    }
+    print_summary("CPU submit", submit_ms);
+    print_summary("Frame", frame_ms);
+
+    target.destroy();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    engine::util::Logging::instance()->initialize();
+    int exit_code = 1;
+    try {
+        exit_code = run(parse_options(argc, argv));
+    } catch (const engine::util::Error &e) {
+        std::cerr << e.report() << '\n';
+    }
+    engine::util::Logging::instance()->shutdown();
+    return exit_code;
+}